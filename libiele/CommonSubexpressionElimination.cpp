@@ -0,0 +1,289 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleInstruction.h"
+#include "IeleIntConstant.h"
+#include "IeleLocalVariable.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// A value computed by a pure instruction, given by its opcode and operands.
+// An expression with the Sha3 opcode stands for the hash of a memory cell
+// holding its single operand, as computed for hashed mapping keys.
+struct Expression {
+  IeleInstruction::IeleOps Opcode;
+  std::vector<const IeleValue *> Operands;
+
+  bool operator<(const Expression &E) const {
+    return std::tie(Opcode, Operands) < std::tie(E.Opcode, E.Operands);
+  }
+};
+
+// The facts known at some program point: the registers holding the values of
+// expressions, the values held by memory cells, by their address, and the
+// registers holding copies of other values, with the value copied.
+struct State {
+  std::map<Expression, IeleLocalVariable *> Available;
+  std::map<const IeleValue *, IeleValue *> Cells;
+  std::map<const IeleLocalVariable *, const IeleValue *> Copies;
+};
+
+// Returns the value that V is known to hold a copy of, or V itself.
+const IeleValue *valueOf(const IeleValue *V, const State &S) {
+  if (const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V)) {
+    auto It = S.Copies.find(LV);
+    if (It != S.Copies.end())
+      return It->second;
+  }
+  return V;
+}
+
+// Returns true if A and B may be the addresses of the same memory cell.
+bool mayAlias(const IeleValue *A, const IeleValue *B) {
+  if (A == B)
+    return true;
+  // Integer constants are unique, so distinct constants differ.
+  return !llvm::isa<IeleIntConstant>(A) || !llvm::isa<IeleIntConstant>(B);
+}
+
+// Returns the expression computed by I, if it is a pure instruction or the
+// hash of a memory cell with known contents.
+std::optional<Expression> expressionOf(const IeleInstruction &I,
+                                       const State &S) {
+  if (I.lvalue_size() != 1)
+    return std::nullopt;
+
+  // The operands are replaced by the values they are copies of, so that an
+  // expression on the result of an eliminated instruction matches the same
+  // expression on the register that held it first.
+  Expression E{I.getOpcode(), {}};
+  if (I.getOpcode() == IeleInstruction::Sha3) {
+    auto It = S.Cells.find(*I.begin());
+    if (It == S.Cells.end())
+      return std::nullopt;
+    E.Operands.push_back(valueOf(It->second, S));
+  } else if (I.isPure()) {
+    for (const IeleValue *V : I.operands())
+      E.Operands.push_back(valueOf(V, S));
+    if (I.isCommutative())
+      std::sort(E.Operands.begin(), E.Operands.end());
+  } else
+    return std::nullopt;
+
+  // An expression on the previous value of its own result cannot be reused.
+  const IeleLocalVariable *LV = I.getIeleLValueList().front();
+  if (std::find(E.Operands.begin(), E.Operands.end(), LV) != E.Operands.end())
+    return std::nullopt;
+  return E;
+}
+
+// Forgets the facts that refer to the register LV, which is being assigned.
+void kill(const IeleLocalVariable *LV, State &S) {
+  for (auto It = S.Available.begin(); It != S.Available.end();) {
+    const std::vector<const IeleValue *> &Ops = It->first.Operands;
+    if (It->second == LV || std::find(Ops.begin(), Ops.end(), LV) != Ops.end())
+      It = S.Available.erase(It);
+    else
+      ++It;
+  }
+  for (auto It = S.Cells.begin(); It != S.Cells.end();) {
+    if (It->first == LV || It->second == LV)
+      It = S.Cells.erase(It);
+    else
+      ++It;
+  }
+  for (auto It = S.Copies.begin(); It != S.Copies.end();) {
+    if (It->first == LV || It->second == LV)
+      It = S.Copies.erase(It);
+    else
+      ++It;
+  }
+}
+
+// Updates S with the effect of I.
+void transfer(const IeleInstruction &I, State &S) {
+  IeleInstruction::IeleOps Opcode = I.getOpcode();
+
+  if (Opcode == IeleInstruction::Store) {
+    const IeleValue *Address = *(I.begin() + 1);
+    for (auto It = S.Cells.begin(); It != S.Cells.end();) {
+      if (mayAlias(It->first, Address))
+        It = S.Cells.erase(It);
+      else
+        ++It;
+    }
+    // Only a store of a whole cell determines its contents.
+    if (I.size() == 2)
+      S.Cells[Address] = *I.begin();
+    return;
+  }
+  // Calls may write to any memory cell.
+  if (Opcode >= IeleInstruction::IeleCallsBegin &&
+      Opcode < IeleInstruction::IeleCallsEnd)
+    S.Cells.clear();
+
+  std::optional<Expression> E = expressionOf(I, S);
+  const IeleValue *Copied =
+    Opcode == IeleInstruction::Assign ? valueOf(*I.begin(), S) : nullptr;
+  for (const IeleLocalVariable *LV : I.lvalues())
+    kill(LV, S);
+  if (E)
+    S.Available.emplace(*E, I.getIeleLValueList().front());
+  if (Copied && Copied != I.getIeleLValueList().front())
+    S.Copies[I.getIeleLValueList().front()] = Copied;
+}
+
+// Common subexpression elimination on IELE functions. An instruction that
+// computes an expression whose value is already held by a register on every
+// path to the instruction is replaced by a copy of that register. Since the
+// registers of IELE functions can be assigned many times, the analysis tracks
+// which expressions are available in which registers at the entry of each
+// block, and forgets an expression when its result or one of its operands is
+// reassigned. Operands that hold copies of other values are replaced by these
+// values, so that expressions on the results of eliminated instructions are
+// found as well.
+//
+// The contents of memory cells written as a whole are tracked as well, so
+// that the hash of a cell holding a value that was hashed before, as emitted
+// for every access to a mapping with a hashed keyspace, reuses the earlier
+// hash, and loading a whole cell with known contents is replaced by a copy.
+// Stores to addresses that are not distinct constants, and calls, may change
+// any cell.
+class CommonSubexpressionElimination : public IeleFunctionPass {
+public:
+  const char *getName() const override {
+    return "CommonSubexpressionElimination";
+  }
+  const char *getCountDescription() const override {
+    return "expressions eliminated";
+  }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    EntryStates.clear();
+    Worklist.clear();
+    EntryStates.emplace(&F.front(), State());
+    Worklist.push_back(&F.front());
+    while (!Worklist.empty()) {
+      IeleBlock *B = Worklist.back();
+      Worklist.pop_back();
+      analyze(*B);
+    }
+
+    unsigned Eliminated = 0;
+    for (auto &Entry : EntryStates)
+      Eliminated += rewrite(*Entry.first, Entry.second);
+    count(F, Eliminated);
+    return Eliminated != 0;
+  }
+
+private:
+  std::map<IeleBlock *, State> EntryStates;
+  std::vector<IeleBlock *> Worklist;
+
+  // Merges S into the entry state of B, scheduling B for analysis if its
+  // entry state changed.
+  void propagate(IeleBlock *B, const State &S) {
+    auto Inserted = EntryStates.emplace(B, S);
+    bool Changed = Inserted.second;
+    if (!Changed) {
+      State &Entry = Inserted.first->second;
+      for (auto It = Entry.Available.begin(); It != Entry.Available.end();) {
+        auto Other = S.Available.find(It->first);
+        if (Other == S.Available.end() || Other->second != It->second) {
+          It = Entry.Available.erase(It);
+          Changed = true;
+        } else
+          ++It;
+      }
+      for (auto It = Entry.Cells.begin(); It != Entry.Cells.end();) {
+        auto Other = S.Cells.find(It->first);
+        if (Other == S.Cells.end() || Other->second != It->second) {
+          It = Entry.Cells.erase(It);
+          Changed = true;
+        } else
+          ++It;
+      }
+      for (auto It = Entry.Copies.begin(); It != Entry.Copies.end();) {
+        auto Other = S.Copies.find(It->first);
+        if (Other == S.Copies.end() || Other->second != It->second) {
+          It = Entry.Copies.erase(It);
+          Changed = true;
+        } else
+          ++It;
+      }
+    }
+    if (Changed && std::find(Worklist.begin(), Worklist.end(), B) ==
+                     Worklist.end())
+      Worklist.push_back(B);
+  }
+
+  void analyze(IeleBlock &B) {
+    State S = EntryStates.at(&B);
+    for (IeleInstruction &I : B.instructions()) {
+      if (I.getOpcode() == IeleInstruction::Br)
+        propagate(I.getBranchTarget(), S);
+      if (I.isTerminator())
+        return;
+      transfer(I, S);
+    }
+    if (IeleBlock *Next = B.getNextNode())
+      propagate(Next, S);
+  }
+
+  unsigned rewrite(IeleBlock &B, State S) {
+    unsigned Eliminated = 0;
+    for (auto It = B.begin(), End = B.end(); It != End;) {
+      IeleInstruction &I = *It++;
+      if (I.isTerminator())
+        break;
+
+      IeleValue *Replacement = nullptr;
+      if (std::optional<Expression> E = expressionOf(I, S)) {
+        auto Available = S.Available.find(*E);
+        if (Available != S.Available.end())
+          Replacement = Available->second;
+      } else if (I.getOpcode() == IeleInstruction::Load && I.size() == 1) {
+        auto Cell = S.Cells.find(*I.begin());
+        if (Cell != S.Cells.end())
+          Replacement = Cell->second;
+      }
+
+      if (!Replacement) {
+        transfer(I, S);
+        continue;
+      }
+
+      // The result of the instruction is already known, and no longer
+      // depends on its operands. If its lvalue holds the result already, the
+      // facts about it remain true.
+      IeleLocalVariable *LV = I.getIeleLValueList().front();
+      if (Replacement != LV)
+        transfer(*IeleInstruction::CreateAssign(LV, Replacement, I.location(),
+                                                &I),
+                 S);
+      I.eraseFromParent();
+      Eliminated++;
+    }
+    return Eliminated;
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createCommonSubexpressionEliminationPass() {
+  return std::make_unique<CommonSubexpressionElimination>();
+}
@@ -0,0 +1,337 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleGlobalVariable.h"
+#include "IeleInstruction.h"
+#include "IeleIntConstant.h"
+#include "IeleLocalVariable.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// Results wider than this are never computed at compile time: they would
+// bloat the bytecode more than they save at run time.
+const unsigned MaxFoldedBits = 4096;
+
+// The known constant values of local variables at some program point. A
+// variable that is not in the map may have any value.
+using ConstantMap = std::map<const IeleLocalVariable *, bigint>;
+
+// Returns the value of V at a point where the local variables have the values
+// in State, if it is a compile-time constant.
+std::optional<bigint> valueOf(const IeleValue *V, const ConstantMap &State) {
+  if (const IeleIntConstant *IC = llvm::dyn_cast<IeleIntConstant>(V))
+    return IC->getValue();
+  if (const IeleGlobalVariable *GV = llvm::dyn_cast<IeleGlobalVariable>(V))
+    if (GV->getStorageAddress())
+      return GV->getStorageAddress()->getValue();
+  if (const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V)) {
+    auto It = State.find(LV);
+    if (It != State.end())
+      return It->second;
+  }
+  return std::nullopt;
+}
+
+unsigned bitWidth(const bigint &V) {
+  return V == 0 ? 0 : boost::multiprecision::msb(abs(V)) + 1;
+}
+
+// Returns V as a two's complement number of NBytes bytes.
+bigint twos(const bigint &NBytes, const bigint &V) {
+  bigint Modulus = bigint(1) << (8 * unsigned(NBytes));
+  bigint Result = V % Modulus;
+  if (Result < 0)
+    Result += Modulus;
+  return Result;
+}
+
+// Computes the result of an instruction with the given opcode on constant
+// operands, following the semantics of IELE on arbitrary-precision integers.
+// Returns nothing if the instruction has side effects, throws an exception on
+// these operands, or has an unreasonably large result. Cases where the
+// semantics of IELE and of bigint on negative operands might diverge are
+// conservatively left to the VM.
+std::optional<bigint> fold(IeleInstruction::IeleOps Opcode,
+                           const std::vector<bigint> &Ops) {
+  switch (Opcode) {
+  case IeleInstruction::Assign:
+    return Ops[0];
+  case IeleInstruction::IsZero:
+    return bigint(Ops[0] == 0 ? 1 : 0);
+  case IeleInstruction::Not:
+    return -Ops[0] - 1;
+  case IeleInstruction::Add:
+    return Ops[0] + Ops[1];
+  case IeleInstruction::Sub:
+    return Ops[0] - Ops[1];
+  case IeleInstruction::Mul:
+    if (bitWidth(Ops[0]) + bitWidth(Ops[1]) > MaxFoldedBits)
+      return std::nullopt;
+    return Ops[0] * Ops[1];
+  case IeleInstruction::Div:
+    if (Ops[0] < 0 || Ops[1] <= 0)
+      return std::nullopt;
+    return bigint(Ops[0] / Ops[1]);
+  case IeleInstruction::Mod:
+    if (Ops[0] < 0 || Ops[1] <= 0)
+      return std::nullopt;
+    return bigint(Ops[0] % Ops[1]);
+  case IeleInstruction::Exp: {
+    const bigint &Base = Ops[0], &Exponent = Ops[1];
+    if (Exponent < 0)
+      return std::nullopt;
+    if (Base == 0 || Base == 1)
+      return Exponent == 0 ? bigint(1) : Base;
+    if (Base == -1)
+      return bigint(Exponent % 2 == 0 ? 1 : -1);
+    if (Exponent * bitWidth(Base) > MaxFoldedBits)
+      return std::nullopt;
+    return bigint(boost::multiprecision::pow(Base, unsigned(Exponent)));
+  }
+  case IeleInstruction::Log2:
+    if (Ops[0] <= 0)
+      return std::nullopt;
+    return bigint(boost::multiprecision::msb(Ops[0]));
+  case IeleInstruction::SExt:
+  case IeleInstruction::Twos: {
+    const bigint &NBytes = Ops[0];
+    if (NBytes <= 0 || NBytes * 8 > MaxFoldedBits)
+      return std::nullopt;
+    bigint Result = twos(NBytes, Ops[1]);
+    if (Opcode == IeleInstruction::SExt &&
+        boost::multiprecision::bit_test(Result, 8 * unsigned(NBytes) - 1))
+      Result -= bigint(1) << (8 * unsigned(NBytes));
+    return Result;
+  }
+  case IeleInstruction::And:
+  case IeleInstruction::Or:
+  case IeleInstruction::Xor:
+    if (Ops[0] < 0 || Ops[1] < 0)
+      return std::nullopt;
+    if (Opcode == IeleInstruction::And)
+      return bigint(Ops[0] & Ops[1]);
+    if (Opcode == IeleInstruction::Or)
+      return bigint(Ops[0] | Ops[1]);
+    return bigint(Ops[0] ^ Ops[1]);
+  case IeleInstruction::Shift: {
+    const bigint &Value = Ops[0], &Amount = Ops[1];
+    if (Value < 0 || abs(Amount) > MaxFoldedBits ||
+        bitWidth(Value) + Amount > MaxFoldedBits)
+      return std::nullopt;
+    if (Amount >= 0)
+      return bigint(Value << unsigned(Amount));
+    return bigint(Value >> unsigned(-Amount));
+  }
+  case IeleInstruction::CmpLt: return bigint(Ops[0] <  Ops[1] ? 1 : 0);
+  case IeleInstruction::CmpLe: return bigint(Ops[0] <= Ops[1] ? 1 : 0);
+  case IeleInstruction::CmpGt: return bigint(Ops[0] >  Ops[1] ? 1 : 0);
+  case IeleInstruction::CmpGe: return bigint(Ops[0] >= Ops[1] ? 1 : 0);
+  case IeleInstruction::CmpEq: return bigint(Ops[0] == Ops[1] ? 1 : 0);
+  case IeleInstruction::CmpNe: return bigint(Ops[0] != Ops[1] ? 1 : 0);
+  default:
+    return std::nullopt;
+  }
+}
+
+// Returns the constant result of I, if its operands have constant values in
+// State and it can be computed at compile time.
+std::optional<bigint> evaluate(const IeleInstruction &I,
+                               const ConstantMap &State) {
+  if (I.lvalue_size() != 1)
+    return std::nullopt;
+
+  std::vector<bigint> Ops;
+  for (const IeleValue *V : I.operands()) {
+    std::optional<bigint> Value = valueOf(V, State);
+    if (!Value)
+      break;
+    Ops.push_back(*Value);
+  }
+
+  // Multiplication by zero is constant regardless of the other operand.
+  if (I.getOpcode() == IeleInstruction::Mul)
+    for (const bigint &Op : Ops)
+      if (Op == 0)
+        return bigint(0);
+
+  if (Ops.size() != I.size())
+    return std::nullopt;
+  return fold(I.getOpcode(), Ops);
+}
+
+// Returns the operand that I copies to its result, if I is an arithmetic
+// instruction with a neutral constant operand, e.g. an addition of zero.
+IeleValue *simplify(IeleInstruction &I, const ConstantMap &State) {
+  if (I.lvalue_size() != 1 || I.size() != 2)
+    return nullptr;
+
+  IeleValue *LHS = *I.begin(), *RHS = *(I.begin() + 1);
+  std::optional<bigint> L = valueOf(LHS, State), R = valueOf(RHS, State);
+  switch (I.getOpcode()) {
+  case IeleInstruction::Add:
+  case IeleInstruction::Or:
+  case IeleInstruction::Xor:
+    if (R && *R == 0) return LHS;
+    if (L && *L == 0) return RHS;
+    return nullptr;
+  case IeleInstruction::Mul:
+    if (R && *R == 1) return LHS;
+    if (L && *L == 1) return RHS;
+    return nullptr;
+  case IeleInstruction::Sub:
+  case IeleInstruction::Shift:
+    return R && *R == 0 ? LHS : nullptr;
+  case IeleInstruction::Div:
+    return R && *R == 1 ? LHS : nullptr;
+  default:
+    return nullptr;
+  }
+}
+
+// Updates State with the effect of I on the local variables.
+void transfer(const IeleInstruction &I, ConstantMap &State) {
+  std::optional<bigint> Result = evaluate(I, State);
+  for (const IeleLocalVariable *LV : I.lvalues())
+    State.erase(LV);
+  if (Result)
+    State[I.getIeleLValueList().front()] = *Result;
+}
+
+// Conditional constant propagation on IELE functions. Because IELE registers
+// can be assigned many times, the analysis tracks the constant values of all
+// local variables at the entry of each block, considering only control flow
+// edges that can be taken given the constants known so far. Instructions with
+// constant results are then replaced by assignments of their result, and
+// conditional branches on constant conditions are made unconditional or
+// removed. Blocks found to be unreachable are left in place.
+class ConstantPropagation : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "ConstantPropagation"; }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    EntryStates.clear();
+    Worklist.clear();
+    EntryStates.emplace(&F.front(), ConstantMap());
+    Worklist.push_back(&F.front());
+    while (!Worklist.empty()) {
+      IeleBlock *B = Worklist.back();
+      Worklist.pop_back();
+      analyze(*B);
+    }
+
+    bool Changed = false;
+    for (auto &Entry : EntryStates)
+      Changed |= rewrite(*Entry.first, Entry.second);
+    return Changed;
+  }
+
+private:
+  std::map<IeleBlock *, ConstantMap> EntryStates;
+  std::vector<IeleBlock *> Worklist;
+
+  // Merges State into the entry state of B, scheduling B for analysis if its
+  // entry state changed.
+  void propagate(IeleBlock *B, const ConstantMap &State) {
+    auto Inserted = EntryStates.emplace(B, State);
+    bool Changed = Inserted.second;
+    if (!Changed) {
+      ConstantMap &Entry = Inserted.first->second;
+      for (auto It = Entry.begin(); It != Entry.end();) {
+        auto Other = State.find(It->first);
+        if (Other == State.end() || Other->second != It->second) {
+          It = Entry.erase(It);
+          Changed = true;
+        } else
+          ++It;
+      }
+    }
+    if (Changed && std::find(Worklist.begin(), Worklist.end(), B) ==
+                     Worklist.end())
+      Worklist.push_back(B);
+  }
+
+  void analyze(IeleBlock &B) {
+    ConstantMap State = EntryStates.at(&B);
+    for (IeleInstruction &I : B.instructions()) {
+      if (I.isConditionalBranch()) {
+        std::optional<bigint> Condition = valueOf(*I.begin(), State);
+        if (!Condition || *Condition != 0)
+          propagate(I.getBranchTarget(), State);
+        if (Condition && *Condition != 0)
+          return;
+        continue;
+      }
+      if (I.getOpcode() == IeleInstruction::Br)
+        propagate(I.getBranchTarget(), State);
+      if (I.isTerminator())
+        return;
+      transfer(I, State);
+    }
+    if (IeleBlock *Next = B.getNextNode())
+      propagate(Next, State);
+  }
+
+  bool rewrite(IeleBlock &B, ConstantMap State) {
+    IeleContext *Ctx = B.getContext();
+    bool Changed = false;
+    for (auto It = B.begin(), End = B.end(); It != End;) {
+      IeleInstruction &I = *It++;
+
+      if (I.isConditionalBranch()) {
+        std::optional<bigint> Condition = valueOf(*I.begin(), State);
+        if (!Condition)
+          continue;
+        bool Taken = *Condition != 0;
+        if (Taken)
+          IeleInstruction::CreateUncondBr(I.getBranchTarget(), I.location(),
+                                          &I);
+        I.eraseFromParent();
+        Changed = true;
+        // The rest of the block is unreachable after a taken branch.
+        if (Taken)
+          break;
+        continue;
+      }
+      if (I.isTerminator())
+        break;
+
+      std::optional<bigint> Result = evaluate(I, State);
+      IeleValue *Copied = Result ? nullptr : simplify(I, State);
+      transfer(I, State);
+      if (!Result && !Copied)
+        continue;
+
+      // Leave instructions that already assign a constant alone.
+      if (I.getOpcode() == IeleInstruction::Assign &&
+          llvm::isa<IeleIntConstant>(*I.begin()))
+        continue;
+
+      IeleLocalVariable *LV = I.getIeleLValueList().front();
+      if (Result)
+        Copied = IeleIntConstant::Create(Ctx, *Result);
+      IeleInstruction::CreateAssign(LV, Copied, I.location(), &I);
+      I.eraseFromParent();
+      Changed = true;
+    }
+    return Changed;
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createConstantPropagationPass() {
+  return std::make_unique<ConstantPropagation>();
+}
@@ -0,0 +1,165 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleInstruction.h"
+#include "IeleLiveness.h"
+#include "IeleLocalVariable.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// The copies available at some program point: each register in the map is
+// known to hold the same value as the register it is mapped to.
+using CopyMap = std::map<const IeleLocalVariable *, IeleLocalVariable *>;
+
+// Returns the register copied by I, if it is a copy between two registers.
+IeleLocalVariable *copiedRegister(const IeleInstruction &I) {
+  if (I.getOpcode() != IeleInstruction::Assign)
+    return nullptr;
+  return llvm::dyn_cast<IeleLocalVariable>(*I.begin());
+}
+
+// Updates Copies with the effect of I.
+void transfer(const IeleInstruction &I, CopyMap &Copies) {
+  for (const IeleLocalVariable *LV : I.lvalues()) {
+    Copies.erase(LV);
+    for (auto It = Copies.begin(); It != Copies.end();) {
+      if (It->second == LV)
+        It = Copies.erase(It);
+      else
+        ++It;
+    }
+  }
+
+  if (IeleLocalVariable *Source = copiedRegister(I)) {
+    const IeleLocalVariable *Dest = I.getIeleLValueList().front();
+    if (Source != Dest)
+      Copies[Dest] = Source;
+  }
+}
+
+// Copy propagation on IELE functions. Reads of a register that is known to be
+// a copy of another register are replaced by reads of the original register,
+// so that chains of assignments through temporaries collapse. Assignments
+// whose result is then never read are removed.
+class CopyPropagation : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "CopyPropagation"; }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    EntryStates.clear();
+    Worklist.clear();
+    EntryStates.emplace(&F.front(), CopyMap());
+    Worklist.push_back(&F.front());
+    while (!Worklist.empty()) {
+      IeleBlock *B = Worklist.back();
+      Worklist.pop_back();
+      analyze(*B);
+    }
+
+    bool Changed = false;
+    for (auto &Entry : EntryStates)
+      Changed |= rewrite(*Entry.first, Entry.second);
+    Changed |= removeDeadCopies(F);
+    return Changed;
+  }
+
+private:
+  std::map<IeleBlock *, CopyMap> EntryStates;
+  std::vector<IeleBlock *> Worklist;
+
+  // Merges Copies into the entry state of B, scheduling B for analysis if its
+  // entry state changed.
+  void propagate(IeleBlock *B, const CopyMap &Copies) {
+    auto Inserted = EntryStates.emplace(B, Copies);
+    bool Changed = Inserted.second;
+    if (!Changed) {
+      CopyMap &Entry = Inserted.first->second;
+      for (auto It = Entry.begin(); It != Entry.end();) {
+        auto Other = Copies.find(It->first);
+        if (Other == Copies.end() || Other->second != It->second) {
+          It = Entry.erase(It);
+          Changed = true;
+        } else
+          ++It;
+      }
+    }
+    if (Changed && std::find(Worklist.begin(), Worklist.end(), B) ==
+                     Worklist.end())
+      Worklist.push_back(B);
+  }
+
+  void analyze(IeleBlock &B) {
+    CopyMap Copies = EntryStates.at(&B);
+    for (IeleInstruction &I : B.instructions()) {
+      if (I.getOpcode() == IeleInstruction::Br)
+        propagate(I.getBranchTarget(), Copies);
+      if (I.isTerminator())
+        return;
+      transfer(I, Copies);
+    }
+    if (IeleBlock *Next = B.getNextNode())
+      propagate(Next, Copies);
+  }
+
+  bool rewrite(IeleBlock &B, CopyMap Copies) {
+    bool Changed = false;
+    for (IeleInstruction &I : B.instructions()) {
+      for (IeleValue *&V : I.getIeleOperandList()) {
+        const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V);
+        if (!LV)
+          continue;
+        auto It = Copies.find(LV);
+        if (It != Copies.end()) {
+          V = It->second;
+          Changed = true;
+        }
+      }
+      if (I.isTerminator())
+        break;
+      transfer(I, Copies);
+    }
+    return Changed;
+  }
+
+  // Removes copies whose result is never read, until there are none left.
+  bool removeDeadCopies(IeleFunction &F) {
+    bool Changed = false;
+    while (true) {
+      IeleLiveness Liveness(F);
+      std::vector<IeleInstruction *> Dead;
+      for (IeleBlock &B : F.blocks())
+        Liveness.forEachInstruction(
+          B, [&](const IeleInstruction &I,
+                 const IeleLiveness::RegisterSet &LiveOut) {
+            if (I.getOpcode() != IeleInstruction::Assign)
+              return;
+            const IeleLocalVariable *Dest = I.getIeleLValueList().front();
+            if (!LiveOut.count(Dest) || copiedRegister(I) == Dest)
+              Dead.push_back(const_cast<IeleInstruction *>(&I));
+          });
+      if (Dead.empty())
+        return Changed;
+      for (IeleInstruction *I : Dead)
+        I->eraseFromParent();
+      Changed = true;
+    }
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createCopyPropagationPass() {
+  return std::make_unique<CopyPropagation>();
+}
@@ -0,0 +1,130 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleInstruction.h"
+#include "IeleLiveness.h"
+#include "IeleLocalVariable.h"
+
+#include <set>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// Dead code elimination on IELE functions. It removes
+//   - instructions that follow a terminator in their block,
+//   - blocks that cannot be reached from the entry block,
+//   - branches to the block that follows the branch anyway,
+//   - instructions without side effects whose lvalues are never read, and
+//   - local variables that are no longer referenced.
+class DeadCodeElimination : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "DeadCodeElimination"; }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    bool Changed = removeUnreachableCode(F);
+    Changed |= removeRedundantBranches(F);
+    Changed |= removeDeadInstructions(F);
+    Changed |= F.removeUnusedLocalVariables();
+    return Changed;
+  }
+
+private:
+  bool removeUnreachableCode(IeleFunction &F) {
+    bool Changed = false;
+
+    // Drop the tail of each block after its first terminator.
+    for (IeleBlock &B : F.blocks()) {
+      auto It = B.begin();
+      while (It != B.end() && !It->isTerminator())
+        ++It;
+      if (It == B.end())
+        continue;
+      for (++It; It != B.end();) {
+        IeleInstruction &I = *It++;
+        I.eraseFromParent();
+        Changed = true;
+      }
+    }
+
+    // Find the blocks reachable from the entry block.
+    std::set<const IeleBlock *> Reachable;
+    std::vector<IeleBlock *> Worklist{&F.front()};
+    while (!Worklist.empty()) {
+      IeleBlock *B = Worklist.back();
+      Worklist.pop_back();
+      if (!Reachable.insert(B).second)
+        continue;
+      for (IeleInstruction &I : B->instructions())
+        if (I.getOpcode() == IeleInstruction::Br)
+          Worklist.push_back(I.getBranchTarget());
+      if (B->empty() || !B->back().isTerminator())
+        if (IeleBlock *Next = B->getNextNode())
+          Worklist.push_back(Next);
+    }
+
+    // Branches to unreachable blocks can only appear in unreachable blocks,
+    // so all unreachable blocks can be removed together.
+    for (auto It = F.begin(); It != F.end();) {
+      IeleBlock &B = *It++;
+      if (Reachable.count(&B))
+        continue;
+      B.eraseFromParent();
+      Changed = true;
+    }
+    return Changed;
+  }
+
+  bool removeRedundantBranches(IeleFunction &F) {
+    bool Changed = false;
+    for (IeleBlock &B : F.blocks()) {
+      if (B.empty() || B.back().getOpcode() != IeleInstruction::Br)
+        continue;
+      IeleInstruction &Br = B.back();
+      if (Br.getBranchTarget() != B.getNextNode())
+        continue;
+      // Evaluating the condition of a branch has no side effects, so the
+      // branch can go whether it is conditional or not.
+      Br.eraseFromParent();
+      Changed = true;
+    }
+    return Changed;
+  }
+
+  bool removeDeadInstructions(IeleFunction &F) {
+    bool Changed = false;
+    while (true) {
+      IeleLiveness Liveness(F);
+      std::vector<IeleInstruction *> Dead;
+      for (IeleBlock &B : F.blocks())
+        Liveness.forEachInstruction(
+          B, [&](const IeleInstruction &I,
+                 const IeleLiveness::RegisterSet &LiveOut) {
+            if (I.lvalue_empty() || I.mayHaveSideEffects())
+              return;
+            for (const IeleLocalVariable *LV : I.lvalues())
+              if (LiveOut.count(LV))
+                return;
+            Dead.push_back(const_cast<IeleInstruction *>(&I));
+          });
+      if (Dead.empty())
+        return Changed;
+      for (IeleInstruction *I : Dead)
+        I->eraseFromParent();
+      Changed = true;
+    }
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createDeadCodeEliminationPass() {
+  return std::make_unique<DeadCodeElimination>();
+}
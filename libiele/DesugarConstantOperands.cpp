@@ -0,0 +1,64 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleInstruction.h"
+#include "IeleIntConstant.h"
+#include "IeleLocalVariable.h"
+
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+class DesugarConstantOperands : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "DesugarConstantOperands"; }
+
+  bool runOnFunction(IeleFunction &F) override {
+    // Collect instructions to desugar.
+    std::vector<IeleInstruction *> DesugarWorklist;
+    for (IeleBlock &B : F.blocks()) {
+      for (IeleInstruction &I : B.instructions()) {
+        if (I.getOpcode() == IeleInstruction::Assign)
+          continue;
+        for (IeleValue *V : I.operands()) {
+          if (llvm::isa<IeleIntConstant>(V)) {
+            DesugarWorklist.push_back(&I);
+            break;
+          }
+        }
+      }
+    }
+
+    // Desugar constant operands. The temporaries only live from their
+    // assignment up to the desugared instruction, so the k-th constant
+    // operand of every instruction can use the same register.
+    std::vector<IeleLocalVariable *> ConstTmps;
+    for (IeleInstruction *I : DesugarWorklist) {
+      unsigned NumConstants = 0;
+      for (auto it = I->begin(), itEnd = I->end(); it != itEnd; ++it) {
+        IeleValue *V = *it;
+        if (IeleIntConstant *IC = llvm::dyn_cast<IeleIntConstant>(V)) {
+          if (NumConstants == ConstTmps.size())
+            ConstTmps.push_back(
+              IeleLocalVariable::Create(F.getContext(), "const.tmp", &F));
+          IeleLocalVariable *ConstTmp = ConstTmps[NumConstants++];
+          IeleInstruction::CreateAssign(ConstTmp, IC, I->location(), I);
+          *it = ConstTmp;
+        }
+      }
+    }
+
+    return !DesugarWorklist.empty();
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createDesugarConstantOperandsPass() {
+  return std::make_unique<DesugarConstantOperands>();
+}
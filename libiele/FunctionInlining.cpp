@@ -0,0 +1,275 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleContract.h"
+#include "IeleFunction.h"
+#include "IeleGlobalVariable.h"
+#include "IeleInstruction.h"
+#include "IeleIntConstant.h"
+#include "IeleLocalVariable.h"
+#include "IeleValueSymbolTable.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// Returns the function of Contract that V names, if any. Functions are
+// referenced either directly or through a global variable with their name.
+IeleFunction *functionOf(IeleContract &Contract, IeleValue *V) {
+  if (IeleFunction *F = llvm::dyn_cast<IeleFunction>(V))
+    return F;
+  if (IeleGlobalVariable *GV = llvm::dyn_cast<IeleGlobalVariable>(V))
+    return llvm::dyn_cast_or_null<IeleFunction>(
+      Contract.getIeleValueSymbolTable()->lookup(GV->getName()));
+  return nullptr;
+}
+
+size_t countInstructions(const IeleFunction &F) {
+  size_t Count = 0;
+  for (const IeleBlock &B : F.blocks())
+    Count += B.size();
+  return Count;
+}
+
+// Function inlining on IELE contracts. A call to an internal function is
+// replaced by a copy of the body of the function if the function has at most
+// SizeThreshold instructions, or if the call is its only use, so that the
+// function can be removed afterwards. The arguments are assigned to copies of
+// the parameters, the copies of the other registers are cleared, and every
+// return assigns the returned values to the lvalues of the call and continues
+// after it. The registers and blocks of the
+// copy get fresh names from the symbol table of the caller.
+//
+// Functions that call themselves directly, and functions marked as not to be
+// inlined, e.g. outlined modifiers, are never inlined. Internal
+// functions that are no longer referenced, neither by calls nor as function
+// pointers, are removed.
+class FunctionInlining : public IeleContractPass {
+public:
+  explicit FunctionInlining(unsigned SizeThreshold)
+    : SizeThreshold(SizeThreshold) { }
+
+  const char *getName() const override { return "FunctionInlining"; }
+  const char *getCountDescription() const override { return "calls inlined"; }
+
+  bool runOnContract(IeleContract &Contract) override {
+    std::map<IeleFunction *, std::vector<IeleInstruction *>> Calls;
+    std::set<IeleFunction *> Referenced;
+    collectUses(Contract, Calls, Referenced);
+
+    bool Changed = false;
+    for (IeleFunction &Callee : Contract.functions()) {
+      auto CallsToCallee = Calls.find(&Callee);
+      if (CallsToCallee == Calls.end() || !isInlinable(Contract, Callee))
+        continue;
+      bool OnlyUse =
+        CallsToCallee->second.size() == 1 && !Referenced.count(&Callee);
+      if (!OnlyUse && countInstructions(Callee) > SizeThreshold)
+        continue;
+      for (IeleInstruction *Call : CallsToCallee->second) {
+        IeleFunction &Caller = *Call->getParent()->getParent();
+        if (&Caller == &Callee || !returnsMatch(Callee, *Call))
+          continue;
+        inlineCall(*Call, Callee);
+        count(Caller);
+        Changed = true;
+      }
+    }
+
+    // Remove the internal functions that are no longer used. Inlining may
+    // have copied calls, so the uses are collected again.
+    Calls.clear();
+    Referenced.clear();
+    collectUses(Contract, Calls, Referenced);
+    for (auto It = Contract.begin(); It != Contract.end();) {
+      IeleFunction &F = *It++;
+      if (F.isPublic() || F.isInit() || F.isDeposit() || Calls.count(&F) ||
+          Referenced.count(&F))
+        continue;
+      Contract.getIeleFunctionList().erase(&F);
+      Changed = true;
+    }
+    return Changed;
+  }
+
+private:
+  unsigned SizeThreshold;
+
+  // Finds the calls to each function of Contract, and the functions that are
+  // referenced other than as the callee of an internal call.
+  static void collectUses(
+      IeleContract &Contract,
+      std::map<IeleFunction *, std::vector<IeleInstruction *>> &Calls,
+      std::set<IeleFunction *> &Referenced) {
+    for (IeleFunction &F : Contract.functions())
+      for (IeleBlock &B : F.blocks())
+        for (IeleInstruction &I : B.instructions())
+          for (auto It = I.begin(); It != I.end(); ++It)
+            if (IeleFunction *Target = functionOf(Contract, *It)) {
+              if (I.getOpcode() == IeleInstruction::Call && It == I.begin())
+                Calls[Target].push_back(&I);
+              else
+                Referenced.insert(Target);
+            }
+  }
+
+  static bool isInlinable(IeleContract &Contract, IeleFunction &F) {
+    if (F.isPublic() || F.isInit() || F.isDeposit() || F.isNoInline() ||
+        F.empty())
+      return false;
+    for (IeleBlock &B : F.blocks())
+      for (IeleInstruction &I : B.instructions())
+        if (I.getOpcode() == IeleInstruction::Call &&
+            functionOf(Contract, *I.begin()) == &F)
+          return false;
+    return true;
+  }
+
+  // Returns true if every return of Callee returns as many values as Call
+  // assigns.
+  static bool returnsMatch(const IeleFunction &Callee,
+                           const IeleInstruction &Call) {
+    for (const IeleBlock &B : Callee.blocks())
+      for (const IeleInstruction &I : B.instructions())
+        if (I.getOpcode() == IeleInstruction::Ret &&
+            I.size() != Call.lvalue_size())
+          return false;
+    return Call.size() - 1 == Callee.arg_size();
+  }
+
+  static bool endsWithTerminator(const IeleBlock &B) {
+    return !B.empty() && B.back().isTerminator();
+  }
+
+  static void inlineCall(IeleInstruction &Call, IeleFunction &Callee) {
+    IeleBlock *Block = Call.getParent();
+    IeleFunction *Caller = Block->getParent();
+    IeleContext *Context = Caller->getContext();
+
+    // Move the instructions after the call to a block of their own, which the
+    // returns of the copy branch to.
+    IeleBlock *Continuation =
+      IeleBlock::Create(Context, "inline.end", Caller, Block->getNextNode());
+    Continuation->getIeleInstructionList().splice(
+      Continuation->end(), Block->getIeleInstructionList(),
+      std::next(Call.getIterator()), Block->end());
+
+    std::map<const IeleValue *, IeleValue *> Map;
+    auto mapValue = [&](IeleValue *V) -> IeleValue * {
+      IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V);
+      if (!LV || LV->getParent() != &Callee)
+        return Map.count(V) ? Map[V] : V;
+      IeleValue *&Copy = Map[V];
+      if (!Copy)
+        Copy = IeleLocalVariable::Create(Context, LV->getName(), Caller);
+      return Copy;
+    };
+
+    // Pass the arguments.
+    auto Argument = std::next(Call.begin());
+    for (IeleArgument &A : Callee.args())
+      IeleInstruction::CreateAssign(
+        llvm::cast<IeleLocalVariable>(mapValue(&A)), *Argument++,
+        Call.location(), &Call);
+
+    // The other registers of a function are zero when it is called, but the
+    // registers of the copy keep their values between executions of the call,
+    // e.g. in a loop, so the ones the callee reads are cleared.
+    std::set<const IeleValue *> Read;
+    for (const IeleBlock &B : Callee.blocks())
+      for (const IeleInstruction &I : B.instructions())
+        Read.insert(I.operands().begin(), I.operands().end());
+    for (IeleLocalVariable &LV : Callee.lvars())
+      if (Read.count(&LV))
+        IeleInstruction::CreateAssign(
+          llvm::cast<IeleLocalVariable>(mapValue(&LV)),
+          IeleIntConstant::getZero(Context), Call.location(), &Call);
+
+    // The entry block of the copy continues the block of the call, unless it
+    // is the target of a branch.
+    std::set<const IeleBlock *> Targets;
+    for (IeleBlock &B : Callee.blocks())
+      for (IeleInstruction &I : B.instructions())
+        if (I.getOpcode() == IeleInstruction::Br)
+          Targets.insert(I.getBranchTarget());
+    // If the last block of the copy that returns ends with the return, the
+    // blocks after it are only entered by branches, e.g. to revert, and are
+    // moved to the end of the caller, so that the return falls through to the
+    // continuation.
+    const IeleBlock *LastReturning = nullptr;
+    for (const IeleBlock &B : Callee.blocks())
+      for (const IeleInstruction &I : B.instructions())
+        if (I.getOpcode() == IeleInstruction::Ret)
+          LastReturning = &B;
+    if (LastReturning && (LastReturning->empty() ||
+                          LastReturning->back().getOpcode() !=
+                            IeleInstruction::Ret ||
+                          !endsWithTerminator(Callee.back()) ||
+                          !endsWithTerminator(Caller->back())))
+      LastReturning = nullptr;
+    bool AfterLastReturning = false;
+    for (IeleBlock &B : Callee.blocks()) {
+      if (&B == &Callee.front() && !Targets.count(&B))
+        Map[&B] = Block;
+      else
+        Map[&B] = IeleBlock::Create(Context, B.getName(), Caller,
+                                    AfterLastReturning ? nullptr
+                                                       : Continuation);
+      AfterLastReturning |= &B == LastReturning;
+    }
+
+    IeleInstruction::IeleLValueListType Results(Call.lvalue_begin(),
+                                                Call.lvalue_end());
+    Call.eraseFromParent();
+
+    bool ContinuationIsTarget = false;
+    for (IeleBlock &B : Callee.blocks()) {
+      IeleBlock *Copy = llvm::cast<IeleBlock>(Map[&B]);
+      for (IeleInstruction &I : B.instructions()) {
+        if (I.getOpcode() != IeleInstruction::Ret) {
+          IeleInstruction::IeleOperandListType Operands;
+          for (IeleValue *V : I.operands())
+            Operands.push_back(mapValue(V));
+          IeleInstruction::IeleLValueListType LValues;
+          for (IeleLocalVariable *LV : I.lvalues())
+            LValues.push_back(llvm::cast<IeleLocalVariable>(mapValue(LV)));
+          IeleInstruction::CreateCopy(I, Operands, LValues, Copy);
+          continue;
+        }
+
+        // The values returned are held by registers of the copy, which are
+        // distinct from the lvalues of the call.
+        for (unsigned i = 0; i < Results.size(); ++i)
+          IeleInstruction::CreateAssign(Results[i],
+                                        mapValue(*(I.begin() + i)),
+                                        I.location(), Copy);
+        if (&I != &B.back() ||
+            &B != (LastReturning ? LastReturning : &Callee.back())) {
+          IeleInstruction::CreateUncondBr(Continuation, I.location(), Copy);
+          ContinuationIsTarget = true;
+        }
+      }
+    }
+
+    // Without branches to it, the continuation can be merged into the block
+    // before it.
+    if (!ContinuationIsTarget) {
+      IeleBlock *Last = Continuation->getPrevNode();
+      Last->getIeleInstructionList().splice(
+        Last->end(), Continuation->getIeleInstructionList());
+      Continuation->eraseFromParent();
+    }
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createFunctionInliningPass(unsigned SizeThreshold) {
+  return std::make_unique<FunctionInlining>(SizeThreshold);
+}
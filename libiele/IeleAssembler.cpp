@@ -0,0 +1,542 @@
+#include "IeleAssembler.h"
+
+#include "IeleContext.h"
+#include "IeleContract.h"
+#include "IeleIntConstant.h"
+
+#include <liblangutil/Exceptions.h>
+
+#include "llvm/ADT/STLExtras.h"
+
+#include <map>
+
+using namespace solidity;
+using namespace solidity::iele;
+using namespace solidity::util;
+
+namespace {
+
+// IELE bytecode opcodes.
+enum BinaryOpcode : uint8_t {
+  ADD          = 0x01,
+  MUL          = 0x02,
+  SUB          = 0x03,
+  DIV          = 0x04,
+  EXP          = 0x05,
+  MOD          = 0x06,
+  ADDMOD       = 0x08,
+  MULMOD       = 0x09,
+  EXPMOD       = 0x0a,
+  SIGNEXTEND   = 0x0b,
+  TWOS         = 0x0c,
+  NE           = 0x0f,
+  LT           = 0x10,
+  LE           = 0x11,
+  GT           = 0x12,
+  GE           = 0x13,
+  EQ           = 0x14,
+  ISZERO       = 0x15,
+  AND          = 0x16,
+  OR           = 0x17,
+  XOR          = 0x18,
+  NOT          = 0x19,
+  BYTE         = 0x1a,
+  SHIFT        = 0x1b,
+  LOG2         = 0x1c,
+  BSWAP        = 0x1d,
+  SHA3         = 0x20,
+  ADDRESS      = 0x30,
+  BALANCE      = 0x31,
+  ORIGIN       = 0x32,
+  CALLER       = 0x33,
+  CALLVALUE    = 0x34,
+  CODESIZE     = 0x38,
+  GASPRICE     = 0x3a,
+  EXTCODESIZE  = 0x3b,
+  BLOCKHASH    = 0x40,
+  BENEFICIARY  = 0x41,
+  TIMESTAMP    = 0x42,
+  NUMBER       = 0x43,
+  DIFFICULTY   = 0x44,
+  GASLIMIT     = 0x45,
+  MLOADN       = 0x50,
+  MLOAD        = 0x51,
+  MSTOREN      = 0x52,
+  MSTORE       = 0x53,
+  SLOAD        = 0x54,
+  SSTORE       = 0x55,
+  MSIZE        = 0x59,
+  GAS          = 0x5a,
+  MOVE         = 0x60,
+  LOADPOS      = 0x61,
+  LOADNEG      = 0x62,
+  REGISTERS    = 0x63,
+  JUMP         = 0x64,
+  JUMPI        = 0x65,
+  JUMPDEST     = 0x66,
+  CALLDEST     = 0x67,
+  EXTCALLDEST  = 0x68,
+  FUNCTION     = 0x69,
+  CONTRACT     = 0x6a,
+  LOG0         = 0xa0,
+  CREATE       = 0xf0,
+  COPYCREATE   = 0xf1,
+  CALL         = 0xf2,
+  CALLADDRESS  = 0xf3,
+  LOCALCALL    = 0xf4,
+  LOCALCALLDYN = 0xf5,
+  RETURN       = 0xf6,
+  REVERT       = 0xf7,
+  STATICCALL   = 0xf8,
+  INVALID      = 0xfe,
+  SELFDESTRUCT = 0xff
+};
+
+// Returns the bytecode opcode of instructions whose encoding is just the
+// opcode followed by their lvalue and operand registers.
+uint8_t registerOnlyOpcode(IeleInstruction::IeleOps Opcode) {
+  switch (Opcode) {
+  case IeleInstruction::SLoad:       return SLOAD;
+  case IeleInstruction::SStore:      return SSTORE;
+  case IeleInstruction::IsZero:      return ISZERO;
+  case IeleInstruction::Not:         return NOT;
+  case IeleInstruction::Add:         return ADD;
+  case IeleInstruction::Mul:         return MUL;
+  case IeleInstruction::Sub:         return SUB;
+  case IeleInstruction::Div:         return DIV;
+  case IeleInstruction::Exp:         return EXP;
+  case IeleInstruction::Mod:         return MOD;
+  case IeleInstruction::Log2:        return LOG2;
+  case IeleInstruction::AddMod:      return ADDMOD;
+  case IeleInstruction::MulMod:      return MULMOD;
+  case IeleInstruction::ExpMod:      return EXPMOD;
+  case IeleInstruction::Byte:        return BYTE;
+  case IeleInstruction::SExt:        return SIGNEXTEND;
+  case IeleInstruction::Twos:        return TWOS;
+  case IeleInstruction::BSwap:       return BSWAP;
+  case IeleInstruction::And:         return AND;
+  case IeleInstruction::Or:          return OR;
+  case IeleInstruction::Xor:         return XOR;
+  case IeleInstruction::Shift:       return SHIFT;
+  case IeleInstruction::CmpLt:       return LT;
+  case IeleInstruction::CmpLe:       return LE;
+  case IeleInstruction::CmpGt:       return GT;
+  case IeleInstruction::CmpGe:       return GE;
+  case IeleInstruction::CmpEq:       return EQ;
+  case IeleInstruction::CmpNe:       return NE;
+  case IeleInstruction::Sha3:        return SHA3;
+  case IeleInstruction::Revert:      return REVERT;
+  case IeleInstruction::Selfdestruct: return SELFDESTRUCT;
+  case IeleInstruction::Invalid:     return INVALID;
+  case IeleInstruction::Gas:         return GAS;
+  case IeleInstruction::Gasprice:    return GASPRICE;
+  case IeleInstruction::Gaslimit:    return GASLIMIT;
+  case IeleInstruction::Beneficiary: return BENEFICIARY;
+  case IeleInstruction::Timestamp:   return TIMESTAMP;
+  case IeleInstruction::Number:      return NUMBER;
+  case IeleInstruction::Difficulty:  return DIFFICULTY;
+  case IeleInstruction::Address:     return ADDRESS;
+  case IeleInstruction::Origin:      return ORIGIN;
+  case IeleInstruction::Caller:      return CALLER;
+  case IeleInstruction::Callvalue:   return CALLVALUE;
+  case IeleInstruction::Msize:       return MSIZE;
+  case IeleInstruction::Codesize:    return CODESIZE;
+  case IeleInstruction::Blockhash:   return BLOCKHASH;
+  case IeleInstruction::Balance:     return BALANCE;
+  case IeleInstruction::Extcodesize: return EXTCODESIZE;
+  default:
+    solAssert(false, "IeleAssembler: instruction needs a dedicated encoding");
+  }
+  return 0;
+}
+
+void appendU16(bytes &Out, size_t Value) {
+  solAssert(Value <= 0xffff, "IeleAssembler: immediate does not fit in 16 bits");
+  Out.push_back(static_cast<uint8_t>(Value >> 8));
+  Out.push_back(static_cast<uint8_t>(Value));
+}
+
+void appendU32(bytes &Out, size_t Value) {
+  solAssert(Value <= 0xffffffff,
+            "IeleAssembler: immediate does not fit in 32 bits");
+  for (int Shift = 24; Shift >= 0; Shift -= 8)
+    Out.push_back(static_cast<uint8_t>(Value >> Shift));
+}
+
+// Appends Value as a sequence of 7-bit groups, most significant first, where
+// all groups but the last have their high bit set.
+void appendLength(bytes &Out, size_t Value) {
+  bytes Groups;
+  do {
+    Groups.push_back(static_cast<uint8_t>(Value & 0x7f));
+    Value >>= 7;
+  } while (Value);
+  for (size_t i = Groups.size(); i-- > 0;)
+    Out.push_back(Groups[i] | (i ? 0x80 : 0x00));
+}
+
+// Big-endian bytes of a non-negative value, without leading zeros.
+bytes magnitudeBytes(bigint Value) {
+  bytes Result;
+  while (Value > 0) {
+    Result.push_back(static_cast<uint8_t>(Value & 0xff));
+    Value >>= 8;
+  }
+  std::reverse(Result.begin(), Result.end());
+  return Result;
+}
+
+// Per-contract encoding state.
+class ContractAssembler {
+public:
+  ContractAssembler(const IeleContract &C, IeleAssemblyCache *AC) :
+    Contract(C), Cache(AC) { }
+
+  bytes assemble();
+
+private:
+  const IeleContract &Contract;
+  IeleAssemblyCache *Cache;
+
+  std::vector<const IeleFunction *> Functions;
+  std::vector<std::string> Names;
+  std::map<std::string, unsigned> NameIndices;
+  std::map<const IeleContract *, unsigned> ChildIndices;
+  unsigned NBits = 0;
+
+  // Register numbering of each function, and the first register that may be
+  // used for materializing constant operands.
+  std::map<const IeleFunction *, std::map<const IeleValue *, unsigned>>
+    FunctionRegisters;
+  std::map<const IeleFunction *, unsigned> FunctionScratch;
+
+  // Per-function encoding state.
+  const std::map<const IeleValue *, unsigned> *Registers = nullptr;
+  unsigned FirstScratch = 0;
+  unsigned NextScratch = 0;
+  std::map<const IeleBlock *, unsigned> Labels;
+  bytes Code;
+
+  unsigned nameIndex(llvm::StringRef Name);
+  unsigned functionIndex(const IeleValue *Callee);
+  bigint constantValue(const IeleValue *V);
+
+  void numberRegisters(const IeleFunction &F);
+
+  void appendRegisters(const std::vector<unsigned> &Regs);
+  void appendLoadConstant(unsigned Reg, const bigint &Value);
+  unsigned operandRegister(const IeleValue *V);
+  std::vector<unsigned> instructionRegisters(
+      const IeleInstruction &I,
+      IeleInstruction::const_iterator FirstOperand);
+
+  void assembleFunction(const IeleFunction &F);
+  void assembleInstruction(const IeleInstruction &I);
+};
+
+unsigned ContractAssembler::nameIndex(llvm::StringRef Name) {
+  auto It = NameIndices.find(Name.str());
+  if (It != NameIndices.end())
+    return It->second;
+  unsigned Index = Names.size();
+  Names.push_back(Name.str());
+  NameIndices[Name.str()] = Index;
+  return Index;
+}
+
+unsigned ContractAssembler::functionIndex(const IeleValue *Callee) {
+  solAssert(llvm::isa<IeleGlobalValue>(Callee),
+            "IeleAssembler: call target is not a function name");
+  return nameIndex(Callee->getName());
+}
+
+bigint ContractAssembler::constantValue(const IeleValue *V) {
+  if (const IeleIntConstant *IC = llvm::dyn_cast<IeleIntConstant>(V))
+    return IC->getValue();
+  if (const IeleGlobalVariable *GV = llvm::dyn_cast<IeleGlobalVariable>(V)) {
+    if (GV->getStorageAddress())
+      return GV->getStorageAddress()->getValue();
+    if (GV->getName() == "ielert.storage.next.free")
+      return Contract.getStorageRuntimeNextFreePtrAddress();
+  }
+  // Function values are represented by their index in the name table.
+  return functionIndex(V);
+}
+
+void ContractAssembler::numberRegisters(const IeleFunction &F) {
+  std::map<const IeleValue *, unsigned> &Regs = FunctionRegisters[&F];
+  for (const IeleArgument &A : F.args())
+    Regs.emplace(&A, Regs.size());
+  for (const IeleLocalVariable &LV : F.lvars())
+    Regs.emplace(&LV, Regs.size());
+
+  // Account for registers that are not in the local variable list, as well as
+  // for scratch registers needed to materialize constant operands.
+  unsigned MaxScratch = 0;
+  for (const IeleBlock &B : F.blocks()) {
+    for (const IeleInstruction &I : B.instructions()) {
+      for (const IeleLocalVariable *LV : I.lvalues())
+        Regs.emplace(LV, Regs.size());
+      unsigned Scratch = 0;
+      for (const IeleValue *V : I.operands()) {
+        if (const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V))
+          Regs.emplace(LV, Regs.size());
+        else if (!llvm::isa<IeleBlock>(V) && !llvm::isa<IeleContract>(V))
+          Scratch++;
+        // Make sure that every function name is in the name table.
+        if (llvm::isa<IeleFunction>(V) ||
+            (llvm::isa<IeleGlobalVariable>(V) &&
+             !llvm::cast<IeleGlobalVariable>(V)->getStorageAddress() &&
+             V->getName() != "ielert.storage.next.free"))
+          nameIndex(V->getName());
+      }
+      MaxScratch = std::max(MaxScratch, Scratch);
+    }
+  }
+
+  unsigned NumRegisters = Regs.size() + MaxScratch;
+  FunctionScratch[&F] = Regs.size();
+  while ((1u << NBits) < NumRegisters)
+    NBits++;
+}
+
+void ContractAssembler::appendRegisters(const std::vector<unsigned> &Regs) {
+  unsigned Accumulator = 0;
+  unsigned Pending = 0;
+  for (unsigned Reg : Regs) {
+    solAssert(Reg < (1u << NBits), "IeleAssembler: register out of range");
+    for (unsigned Bit = NBits; Bit-- > 0;) {
+      Accumulator = (Accumulator << 1) | ((Reg >> Bit) & 1);
+      if (++Pending == 8) {
+        Code.push_back(static_cast<uint8_t>(Accumulator));
+        Accumulator = 0;
+        Pending = 0;
+      }
+    }
+  }
+  if (Pending)
+    Code.push_back(static_cast<uint8_t>(Accumulator << (8 - Pending)));
+}
+
+void ContractAssembler::appendLoadConstant(unsigned Reg, const bigint &Value) {
+  bytes Data;
+  if (Value >= 0) {
+    Code.push_back(LOADPOS);
+    Data = magnitudeBytes(Value);
+  } else {
+    // Minimal two's complement representation.
+    Code.push_back(LOADNEG);
+    size_t Width = 1;
+    while (Value < -(bigint(1) << (8 * Width - 1)))
+      Width++;
+    Data = magnitudeBytes(Value + (bigint(1) << (8 * Width)));
+  }
+  appendRegisters({Reg});
+  appendLength(Code, Data.size());
+  Code += Data;
+}
+
+unsigned ContractAssembler::operandRegister(const IeleValue *V) {
+  if (llvm::isa<IeleLocalVariable>(V))
+    return Registers->at(V);
+  unsigned Reg = NextScratch++;
+  appendLoadConstant(Reg, constantValue(V));
+  return Reg;
+}
+
+// Returns the registers of the lvalues of I followed by the registers of its
+// operands starting at FirstOperand, materializing constants along the way.
+std::vector<unsigned> ContractAssembler::instructionRegisters(
+    const IeleInstruction &I, IeleInstruction::const_iterator FirstOperand) {
+  std::vector<unsigned> Regs;
+  for (const IeleLocalVariable *LV : I.lvalues())
+    Regs.push_back(Registers->at(LV));
+  for (auto It = FirstOperand; It != I.end(); ++It)
+    Regs.push_back(operandRegister(*It));
+  return Regs;
+}
+
+void ContractAssembler::assembleInstruction(const IeleInstruction &I) {
+  NextScratch = FirstScratch;
+  // Materialization of constant operands happens while the register list is
+  // computed, so the opcode is emitted afterwards.
+  std::vector<unsigned> Regs;
+  switch (I.getOpcode()) {
+  case IeleInstruction::Assign: {
+    const IeleValue *RHS = *I.begin();
+    unsigned Result = Registers->at(*I.lvalue_begin());
+    if (llvm::isa<IeleLocalVariable>(RHS)) {
+      Code.push_back(MOVE);
+      appendRegisters({Result, Registers->at(RHS)});
+    } else {
+      appendLoadConstant(Result, constantValue(RHS));
+    }
+    return;
+  }
+  case IeleInstruction::Load:
+  case IeleInstruction::Store: {
+    Regs = instructionRegisters(I, I.begin());
+    bool Wide = I.size() > 2;
+    if (I.getOpcode() == IeleInstruction::Load)
+      Code.push_back(Wide ? MLOADN : MLOAD);
+    else
+      Code.push_back(Wide ? MSTOREN : MSTORE);
+    appendRegisters(Regs);
+    return;
+  }
+  case IeleInstruction::Br: {
+    const IeleBlock *Target = llvm::cast<IeleBlock>(I.getIeleOperandList().back());
+    if (I.size() == 1) {
+      Code.push_back(JUMP);
+      appendU16(Code, Labels.at(Target));
+    } else {
+      Regs.push_back(operandRegister(I.getIeleOperandList().front()));
+      Code.push_back(JUMPI);
+      appendU16(Code, Labels.at(Target));
+      appendRegisters(Regs);
+    }
+    return;
+  }
+  case IeleInstruction::Ret:
+    Regs = instructionRegisters(I, I.begin());
+    Code.push_back(RETURN);
+    appendU16(Code, Regs.size());
+    appendRegisters(Regs);
+    return;
+  case IeleInstruction::Log:
+    Regs = instructionRegisters(I, I.begin());
+    solAssert(Regs.size() >= 1 && Regs.size() <= 5,
+              "IeleAssembler: invalid number of log operands");
+    Code.push_back(LOG0 + Regs.size() - 1);
+    appendRegisters(Regs);
+    return;
+  case IeleInstruction::Call: {
+    const IeleValue *Callee = *I.begin();
+    size_t NumArgs = I.size() - 1;
+    if (llvm::isa<IeleLocalVariable>(Callee)) {
+      Regs = instructionRegisters(I, I.begin());
+      Code.push_back(LOCALCALLDYN);
+    } else {
+      Regs = instructionRegisters(I, std::next(I.begin()));
+      Code.push_back(LOCALCALL);
+      appendU16(Code, functionIndex(Callee));
+    }
+    appendU16(Code, NumArgs);
+    appendU16(Code, I.lvalue_size());
+    appendRegisters(Regs);
+    return;
+  }
+  case IeleInstruction::CallAt:
+  case IeleInstruction::StaticCallAt: {
+    // Operands are the callee, the account, the value to send (only for
+    // non-static calls), the gas limit, and the call arguments.
+    bool Static = I.getOpcode() == IeleInstruction::StaticCallAt;
+    size_t NumArgs = I.size() - (Static ? 3 : 4);
+    Regs = instructionRegisters(I, I.begin());
+    Code.push_back(Static ? STATICCALL : CALL);
+    appendU16(Code, NumArgs);
+    appendU16(Code, I.lvalue_size() - 1);
+    appendRegisters(Regs);
+    return;
+  }
+  case IeleInstruction::CallAddress:
+    Regs = instructionRegisters(I, std::next(I.begin()));
+    Code.push_back(CALLADDRESS);
+    appendU16(Code, functionIndex(*I.begin()));
+    appendRegisters(Regs);
+    return;
+  case IeleInstruction::Create: {
+    const IeleContract *Child = llvm::cast<IeleContract>(*I.begin());
+    Regs = instructionRegisters(I, std::next(I.begin()));
+    Code.push_back(CREATE);
+    appendU16(Code, ChildIndices.at(Child));
+    appendU16(Code, I.size() - 2);
+    appendRegisters(Regs);
+    return;
+  }
+  case IeleInstruction::CopyCreate:
+    Regs = instructionRegisters(I, I.begin());
+    Code.push_back(COPYCREATE);
+    appendU16(Code, I.size() - 2);
+    appendRegisters(Regs);
+    return;
+  default:
+    Regs = instructionRegisters(I, I.begin());
+    Code.push_back(registerOnlyOpcode(I.getOpcode()));
+    appendRegisters(Regs);
+    return;
+  }
+}
+
+void ContractAssembler::assembleFunction(const IeleFunction &F) {
+  Registers = &FunctionRegisters.at(&F);
+  FirstScratch = FunctionScratch.at(&F);
+
+  // Every block gets a jump destination, numbered in layout order within
+  // its function, as kiele does for the labeled blocks of the textual form.
+  Labels.clear();
+  for (const IeleBlock &B : F.blocks())
+    Labels.emplace(&B, Labels.size());
+
+  // The init function is only entered on account creation, so it is not an
+  // external call destination.
+  bool IsEntryPoint = F.isPublic() || F.isDeposit();
+  Code.push_back(IsEntryPoint ? EXTCALLDEST : CALLDEST);
+  appendU16(Code, nameIndex(F.getName()));
+  appendU16(Code, F.arg_size());
+
+  for (const IeleBlock &B : F.blocks()) {
+    Code.push_back(JUMPDEST);
+    appendU16(Code, Labels.at(&B));
+    for (const IeleInstruction &I : B.instructions())
+      assembleInstruction(I);
+  }
+}
+
+bytes ContractAssembler::assemble() {
+  // The name table implicitly starts with init, which gets no FUNCTION
+  // entry. Defined functions come next, in emission order, followed by the
+  // runtime functions the contract needs.
+  nameIndex("init");
+  for (const IeleFunction &F : Contract.functions())
+    Functions.push_back(&F);
+  for (const IeleFunction *F : Contract.getRuntimeFunctions())
+    Functions.push_back(F);
+  for (const IeleFunction *F : Functions)
+    nameIndex(F->getName());
+
+  for (const IeleContract *Child : Contract.getIeleContractList())
+    ChildIndices.emplace(Child, ChildIndices.size());
+
+  for (const IeleFunction *F : Functions)
+    numberRegisters(*F);
+  solAssert(NBits <= 0xff, "IeleAssembler: too many registers");
+
+  for (const IeleFunction *F : Functions)
+    assembleFunction(*F);
+
+  bytes Body;
+  Body.push_back(REGISTERS);
+  Body.push_back(static_cast<uint8_t>(NBits));
+  for (const std::string &Name : llvm::drop_begin(Names, 1)) {
+    Body.push_back(FUNCTION);
+    appendU16(Body, Name.size());
+    Body += asBytes(Name);
+  }
+  for (const IeleContract *Child : Contract.getIeleContractList()) {
+    Body.push_back(CONTRACT);
+    Body += Child->getBytecode(Cache);
+  }
+  Body += Code;
+
+  bytes Result;
+  appendU32(Result, Body.size());
+  return Result + Body;
+}
+
+} // end anonymous namespace
+
+bytes IeleAssembler::assemble(const IeleContract &Contract,
+                              IeleAssemblyCache *Cache) {
+  return ContractAssembler(Contract, Cache).assemble();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <libsolutil/Common.h>
+
+namespace solidity {
+namespace iele {
+
+class IeleAssemblyCache;
+class IeleContract;
+
+// In-process encoder from the IELE data model to IELE bytecode. It walks the
+// IeleContract/IeleFunction/IeleBlock/IeleInstruction objects directly, so no
+// textual IELE needs to be produced and no external assembler needs to run.
+//
+// The layout of the produced bytecode is:
+//
+//   contract   ::= size:4 REGISTERS nbits:1 name* child* function*
+//   name       ::= FUNCTION len:2 bytes
+//   child      ::= CONTRACT contract
+//   function   ::= (CALLDEST | EXTCALLDEST) name-index:2 nargs:2 block*
+//   block      ::= JUMPDEST label:2 instruction*
+//
+// All multi-byte immediates are big-endian. Every function referenced by the
+// contract, whether defined in it, called on another account, or part of the
+// IELE runtime, gets an entry in the name table, and is referred to by its
+// index in that table. Index 0 is implicitly taken by @init, which has no
+// FUNCTION entry. Blocks are labeled in layout order within their function.
+// Register operands are numbered per function (formal arguments first, then
+// local variables in declaration order) and are packed back to back using
+// nbits bits each, padded with zeros to a byte boundary; nbits is 0 when no
+// function uses more than one register.
+// Integer constants are materialized with LOADPOS/LOADNEG into a scratch
+// register whenever they appear outside of an assignment.
+//
+class IeleAssembler {
+public:
+  // Version of the bytecode encoding. It must be bumped whenever the produced
+  // bytecode changes for some input, as it invalidates cached bytecode.
+  static constexpr unsigned Version = 2;
+
+  // Returns the bytecode of Contract, including the bytecode of every contract
+  // it creates, but excluding its auxiliary data. The bytecode of the created
+  // contracts is not re-assembled, but obtained with
+  // IeleContract::getBytecode (consulting Cache), so that each contract is
+  // assembled once no matter how deep in the creation tree it appears.
+  static bytes assemble(const IeleContract &Contract,
+                        IeleAssemblyCache *Cache = nullptr);
+};
+
+} // end namespace iele
+} // end namespace solidity
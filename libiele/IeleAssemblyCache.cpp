@@ -0,0 +1,153 @@
+#include "IeleAssemblyCache.h"
+
+#include "IeleAssembler.h"
+
+#include <libsolutil/Keccak256.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+using namespace solidity::util;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// Extension of complete cache entries. Entries are first written under a
+// unique temporary name and then renamed, so that concurrent compiler
+// invocations never observe partially written entries.
+const char *const EntryExtension = ".bin";
+
+bool isEntry(const fs::directory_entry &Entry) {
+  boost::system::error_code EC;
+  return Entry.path().extension() == EntryExtension &&
+         fs::is_regular_file(Entry.status(EC));
+}
+
+} // end anonymous namespace
+
+IeleAssemblyCache::IeleAssemblyCache(fs::path Dir, uint64_t Max) :
+  Directory(std::move(Dir)), MaxSize(Max) {
+  boost::system::error_code EC;
+  fs::create_directories(Directory, EC);
+  for (fs::directory_iterator It(Directory, EC), End; !EC && It != End;
+       It.increment(EC))
+    if (isEntry(*It))
+      CurrentSize += fs::file_size(It->path(), EC);
+}
+
+h256 IeleAssemblyCache::key(const std::string &Source) {
+  return keccak256(
+    "iele-assembler-" + std::to_string(IeleAssembler::Version) + "\n" + Source);
+}
+
+fs::path IeleAssemblyCache::entryPath(const h256 &Key) const {
+  return Directory / (Key.hex() + EntryExtension);
+}
+
+std::optional<bytes> IeleAssemblyCache::lookup(const h256 &Key) {
+  fs::path Path = entryPath(Key);
+  std::ifstream In(Path.string(), std::ios::binary);
+  if (!In) {
+    Misses++;
+    return std::nullopt;
+  }
+
+  bytes Contents{std::istreambuf_iterator<char>(In),
+                 std::istreambuf_iterator<char>()};
+  boost::system::error_code EC;
+  if (In.bad() || Contents.size() < h256::size ||
+      h256(bytesConstRef(Contents.data(), h256::size)) !=
+        keccak256(bytesConstRef(Contents.data() + h256::size,
+                                Contents.size() - h256::size))) {
+    // The entry is damaged, e.g. truncated by a full disk or modified by
+    // hand. Drop it, so that it is replaced by the next store.
+    In.close();
+    if (fs::remove(Path, EC))
+      CurrentSize -= std::min<uint64_t>(CurrentSize, Contents.size());
+    Misses++;
+    return std::nullopt;
+  }
+
+  // Mark the entry as recently used.
+  fs::last_write_time(Path, std::time(nullptr), EC);
+  Hits++;
+  return bytes(Contents.begin() + h256::size, Contents.end());
+}
+
+void IeleAssemblyCache::store(const h256 &Key, const bytes &Bytecode) {
+  boost::system::error_code EC;
+  fs::path Temporary =
+    Directory / fs::unique_path(Key.hex() + ".%%%%-%%%%-%%%%.tmp", EC);
+  if (EC)
+    return;
+
+  {
+    std::ofstream Out(Temporary.string(), std::ios::binary);
+    h256 Checksum = keccak256(Bytecode);
+    Out.write(reinterpret_cast<const char *>(Checksum.data()), h256::size);
+    Out.write(reinterpret_cast<const char *>(Bytecode.data()),
+              static_cast<std::streamsize>(Bytecode.size()));
+    if (!Out) {
+      Out.close();
+      fs::remove(Temporary, EC);
+      return;
+    }
+  }
+
+  fs::rename(Temporary, entryPath(Key), EC);
+  if (EC) {
+    fs::remove(Temporary, EC);
+    return;
+  }
+
+  CurrentSize += h256::size + Bytecode.size();
+  if (CurrentSize > MaxSize)
+    evict();
+}
+
+void IeleAssemblyCache::evict() {
+  // Other compiler invocations may share the directory, so take a fresh look
+  // at its contents instead of relying on CurrentSize.
+  struct Entry {
+    fs::path Path;
+    std::time_t LastUse;
+    uint64_t Size;
+  };
+  std::vector<Entry> Entries;
+  CurrentSize = 0;
+
+  boost::system::error_code EC;
+  for (fs::directory_iterator It(Directory, EC), End; !EC && It != End;
+       It.increment(EC)) {
+    if (!isEntry(*It))
+      continue;
+    boost::system::error_code EntryEC;
+    uint64_t Size = fs::file_size(It->path(), EntryEC);
+    std::time_t LastUse = fs::last_write_time(It->path(), EntryEC);
+    if (EntryEC)
+      continue;
+    Entries.push_back({It->path(), LastUse, Size});
+    CurrentSize += Size;
+  }
+
+  std::sort(Entries.begin(), Entries.end(),
+            [](const Entry &LHS, const Entry &RHS) {
+              return LHS.LastUse < RHS.LastUse;
+            });
+
+  for (const Entry &E : Entries) {
+    if (CurrentSize <= MaxSize)
+      break;
+    if (fs::remove(E.Path, EC)) {
+      CurrentSize -= E.Size;
+      Evictions++;
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <libsolutil/Common.h>
+#include <libsolutil/FixedHash.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <optional>
+
+namespace solidity {
+namespace iele {
+
+// A persistent, content-addressed cache of assembled IELE bytecode. Entries
+// are keyed by the hash of the textual form of a contract together with the
+// version of the IeleAssembler, and are stored one per file in a directory
+// that may be shared by any number of compiler invocations.
+//
+// The total size of the cached bytecode is bounded. When an insertion takes
+// the cache above its bound, the least recently used entries are evicted until
+// it fits again. Reading an entry counts as using it.
+//
+// Each entry starts with the keccak256 hash of the bytecode that follows it.
+// Entries that do not match their hash are removed on lookup.
+//
+// The cache is strictly an optimization: any I/O failure or damaged entry is
+// treated as a miss and never makes compilation fail.
+//
+class IeleAssemblyCache {
+public:
+  static constexpr uint64_t DefaultMaxSize = 256 * 1024 * 1024;
+
+  explicit IeleAssemblyCache(boost::filesystem::path Directory,
+                             uint64_t MaxSize = DefaultMaxSize);
+
+  // Returns the key under which the bytecode assembled from Source is stored.
+  static util::h256 key(const std::string &Source);
+
+  // Returns the bytecode stored under Key, if any.
+  std::optional<bytes> lookup(const util::h256 &Key);
+
+  // Stores Bytecode under Key, evicting old entries if needed.
+  void store(const util::h256 &Key, const bytes &Bytecode);
+
+  const boost::filesystem::path &directory() const { return Directory; }
+  uint64_t maxSize() const { return MaxSize; }
+
+  unsigned hits() const { return Hits; }
+  unsigned misses() const { return Misses; }
+  unsigned evictions() const { return Evictions; }
+
+private:
+  boost::filesystem::path Directory;
+  uint64_t MaxSize;
+  // Total size of the entries in the directory, as last observed.
+  uint64_t CurrentSize = 0;
+
+  unsigned Hits = 0;
+  unsigned Misses = 0;
+  unsigned Evictions = 0;
+
+  boost::filesystem::path entryPath(const util::h256 &Key) const;
+  void evict();
+};
+
+} // end namespace iele
+} // end namespace solidity
@@ -33,6 +33,12 @@ void IeleBlock::insertInto(IeleFunction *NewParent, IeleBlock *InsertBefore) {
 }
 
 void IeleBlock::setParent(IeleFunction *parent) {
+  // Nothing to check when the block is removed from its function.
+  if (!parent) {
+    Parent = nullptr;
+    return;
+  }
+
   // Assert that all operands and lvalues of the block's instructions belong to
   // the function.
   for (const IeleInstruction &I : instructions()) {
@@ -71,6 +77,11 @@ bool IeleBlock::endsWithRet() const {
   return !empty() && back().getOpcode() == IeleInstruction::Ret;
 }
 
+void IeleBlock::eraseFromParent() {
+  solAssert(Parent, "Block is not in a function!");
+  Parent->getIeleBlockList().erase(getIterator());
+}
+
 IeleBlock::~IeleBlock() { }
 
 void IeleBlock::print(llvm::raw_ostream &OS, unsigned indent) const {
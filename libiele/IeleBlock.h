@@ -113,6 +113,10 @@ public:
   //
   void insertInto(IeleFunction *NewParent, IeleBlock *InsertBefore = nullptr);
 
+  // Unlinks the block from its function and deletes it, together with its
+  // instructions. The block must not be the target of any branch.
+  void eraseFromParent();
+
   // Returns true if the last instruction of the block is a ret instruction.
   bool endsWithRet() const;
 
@@ -1,10 +1,14 @@
 #include "IeleContract.h"
 
+#include "IeleAssembler.h"
+#include "IeleAssemblyCache.h"
 #include "IeleContext.h"
 #include "IeleIntConstant.h"
+#include "IeleParser.h"
 #include "IeleValueSymbolTable.h"
 
 #include <liblangutil/Exceptions.h>
+#include <libsolutil/Keccak256.h>
 #include "llvm/ADT/Optional.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Program.h"
@@ -13,6 +17,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
+#include <set>
 #include <sstream>
 
 #include <boost/filesystem.hpp>
@@ -45,34 +50,75 @@ IeleContract::IeleContract(IeleContext *Ctx, const llvm::Twine &Name,
 
 IeleContract::~IeleContract() { }
 
-void IeleContract::printRuntime(llvm::raw_ostream &OS, unsigned indent) const {
-  std::string RuntimeSourceCode;
-  if (!IncludeMemoryRuntime && !IncludeStorageRuntime)
-    return;
+namespace {
 
-  if (IncludeStorageRuntime) {
-    RuntimeSourceCode.append(
-      "\n@ielert.storage.next.free = " + NextFreePtrAddress.str() + "\n");
-    RuntimeSourceCode.append(
+// The IELE source code of all runtime functions.
+const char *RuntimeSourceCode =
 #include "iele-rt/iele-storage-rt.h"
-    );
-  }
-
-  if (IncludeMemoryRuntime) {
-    if (IncludeStorageRuntime)
-      RuntimeSourceCode.append("\n");
-    RuntimeSourceCode.append(
+  "\n"
 #include "iele-rt/iele-memory-rt.h"
-    );
+  ;
+
+// Returns the IELE runtime in IR form. The runtime functions do not depend on
+// the contract that calls them, so they are parsed once per process and kept
+// in their own context, as they do not belong to the IR of any particular
+// contract.
+const IeleContract &runtimeContract() {
+  static IeleContext RuntimeContext;
+  static const IeleContract *Runtime = [] {
+    IeleContract *Runtime = IeleContract::Create(&RuntimeContext, "ielert");
+    IeleParser(&RuntimeContext).parseFunctions(RuntimeSourceCode, Runtime);
+    return Runtime;
+  }();
+  return *Runtime;
+}
+
+} // end anonymous namespace
+
+std::vector<const IeleFunction *> IeleContract::getRuntimeFunctions() const {
+  std::vector<const IeleFunction *> Result;
+  if (!IncludeMemoryRuntime && !IncludeStorageRuntime)
+    return Result;
+
+  // Runtime functions are referred to by unattached global variables of the
+  // same name, both from the contract and from other runtime functions.
+  const IeleContract &Runtime = runtimeContract();
+  std::set<const IeleFunction *> Reachable;
+  std::vector<const IeleFunction *> Worklist;
+  auto visit = [&](const IeleFunction &F) {
+    for (const IeleBlock &B : F.blocks())
+      for (const IeleInstruction &I : B.instructions())
+        for (const IeleValue *V : I.operands()) {
+          if (!llvm::isa<IeleGlobalVariable>(V))
+            continue;
+          const IeleFunction *Callee = llvm::dyn_cast_or_null<IeleFunction>(
+            Runtime.getIeleValueSymbolTable()->lookup(V->getName()));
+          if (Callee && Reachable.insert(Callee).second)
+            Worklist.push_back(Callee);
+        }
+  };
+  for (const IeleFunction &F : functions())
+    visit(F);
+  while (!Worklist.empty()) {
+    const IeleFunction *F = Worklist.back();
+    Worklist.pop_back();
+    visit(*F);
   }
 
-  std::istringstream rtstream(RuntimeSourceCode);
-  std::string line;
+  for (const IeleFunction &F : Runtime.functions())
+    if (Reachable.count(&F))
+      Result.push_back(&F);
+  return Result;
+}
+
+void IeleContract::printRuntime(llvm::raw_ostream &OS, unsigned indent) const {
   std::string Indent(indent, ' ');
-  OS << "\n";
-  while (!rtstream.eof()) {
-    std::getline(rtstream, line);
-    OS << Indent << line << "\n";
+  if (IncludeStorageRuntime)
+    OS << "\n\n" << Indent << "@ielert.storage.next.free = "
+       << NextFreePtrAddress.str();
+  for (const IeleFunction *F : getRuntimeFunctions()) {
+    OS << "\n\n";
+    F->print(OS, indent);
   }
 }
 
@@ -93,11 +139,16 @@ std::string IeleContract::escapeIeleName(llvm::StringRef str) {
 }
 
 void IeleContract::print(llvm::raw_ostream &OS, unsigned indent) const {
-  std::string Indent(indent, ' ');
   for (const IeleContract *Contract : IeleContractList) {
     Contract->print(OS, indent);
     OS << "\n";
   }
+  printDefinition(OS, indent);
+}
+
+void IeleContract::printDefinition(llvm::raw_ostream &OS,
+                                   unsigned indent) const {
+  std::string Indent(indent, ' ');
   OS << Indent << "contract \"" << escapeIeleName(getName()) << "\" {\n";
   bool isFirst = true;
   for (const IeleContract *Contract : IeleContractList) {
@@ -129,7 +180,47 @@ void IeleContract::print(llvm::raw_ostream &OS, unsigned indent) const {
   OS << "\n\n" << Indent << "}" << "\n";
 }
 
-bytes IeleContract::toBinary() const {
+const bytes &IeleContract::getBytecode(IeleAssemblyCache *Cache) const {
+  if (Bytecode)
+    return *Bytecode;
+
+  if (!Cache) {
+    Bytecode = IeleAssembler::assemble(*this, Cache);
+    return *Bytecode;
+  }
+
+  // The cache key covers the text of the contract itself and the bytecode of
+  // the contracts it creates, which is already available, instead of their
+  // (recursively printed) text.
+  std::string KeySource;
+  llvm::raw_string_ostream OS(KeySource);
+  printDefinition(OS);
+  for (const IeleContract *Contract : IeleContractList)
+    OS << "\n" << keccak256(Contract->getBytecode(Cache)).hex();
+  OS.flush();
+
+  h256 Key = IeleAssemblyCache::key(KeySource);
+  if (std::optional<bytes> Cached = Cache->lookup(Key)) {
+    Bytecode = std::move(*Cached);
+  } else {
+    Bytecode = IeleAssembler::assemble(*this, Cache);
+    Cache->store(Key, *Bytecode);
+  }
+  return *Bytecode;
+}
+
+bytes IeleContract::toBinary(bool CrossCheck, IeleAssemblyCache *Cache) const {
+  const bytes &Result = getBytecode(Cache);
+  if (CrossCheck && Result != assembleExternally())
+    throw langutil::Error(7391_error,
+                          langutil::Error::Type::CodeGenerationError)
+        << util::errinfo_comment(
+               "IELE assembler output differs from kiele for contract " +
+               getName().str() + ".");
+  return Result + AuxiliaryData;
+}
+
+bytes IeleContract::assembleExternally() const {
   std::string assembly;
   llvm::raw_string_ostream OS(assembly);
   this->print(OS);
@@ -169,7 +260,7 @@ bytes IeleContract::toBinary() const {
   std::remove(tempin);
   std::remove(tempout);
 
-  return fromHex(hex, WhenError::Throw) + AuxiliaryData;
+  return fromHex(hex, WhenError::Throw);
 }
 
 
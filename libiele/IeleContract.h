@@ -9,9 +9,13 @@
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/ADT/Twine.h"
 
+#include <optional>
+#include <vector>
+
 namespace solidity {
 namespace iele {
 
+class IeleAssemblyCache;
 class IeleValueSymbolTable;
 
 class IeleContract :
@@ -54,6 +58,17 @@ private:
   bigint NextFreePtrAddress;
   void printRuntime(llvm::raw_ostream &OS, unsigned indent = 0) const;
 
+  // Prints the contract itself, but none of the contracts it creates.
+  void printDefinition(llvm::raw_ostream &OS, unsigned indent = 0) const;
+
+  // The assembled bytecode of the contract, excluding its auxiliary data. A
+  // contract is not modified after its compilation is complete, so it only
+  // needs to be assembled once, no matter how many other contracts create it.
+  mutable std::optional<bytes> Bytecode;
+
+  // Runs the external kiele assembler on the textual form of the contract.
+  bytes assembleExternally() const;
+
   // IeleContract ctor - If the (optional) IeleContract argument is specified,
   // the contract is automatically inserted into the end of the external
   // contract list for the given contract.
@@ -81,10 +96,18 @@ public:
   void setIncludeStorageRuntime(bool includeStorageRuntime) {
     IncludeStorageRuntime = includeStorageRuntime;
   }
+  const bigint &getStorageRuntimeNextFreePtrAddress() const {
+    return NextFreePtrAddress;
+  }
   void setStorageRuntimeNextFreePtrAddress(bigint nextFreePtrAddress) {
     NextFreePtrAddress = nextFreePtrAddress;
   }
 
+  // Returns the functions of the IELE runtime that are reachable from the
+  // functions of the contract, in the order they are defined in the runtime.
+  // Only these are emitted along with the contract.
+  std::vector<const IeleFunction *> getRuntimeFunctions() const;
+
   void appendAuxiliaryDataToEnd(const bytes &data) { AuxiliaryData += data; }
 
   // Get the underlying elements of the IeleContract.
@@ -195,7 +218,19 @@ public:
   bool   contract_empty() const { return IeleContractList.empty(); }
 
   void print(llvm::raw_ostream &OS, unsigned indent = 0) const override;
-  bytes toBinary() const;
+
+  // Returns the bytecode of the contract, excluding its auxiliary data. The
+  // bytecode is produced by the in-process IeleAssembler the first time it is
+  // requested, unless it is found in the (optional) Cache, and is reused by
+  // every later request, including the ones for embedding the contract in the
+  // bytecode of the contracts that create it.
+  const bytes &getBytecode(IeleAssemblyCache *Cache = nullptr) const;
+
+  // Returns the bytecode of the contract followed by its auxiliary data. If
+  // CrossCheck is set, the contract is also assembled with the external kiele
+  // assembler, and the two results are required to be identical.
+  bytes toBinary(bool CrossCheck = false,
+                 IeleAssemblyCache *Cache = nullptr) const;
 
   void printSourceMapping(
     llvm::raw_ostream &OS,
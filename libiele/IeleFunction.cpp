@@ -3,6 +3,8 @@
 #include "IeleContract.h"
 #include "IeleValueSymbolTable.h"
 
+#include <set>
+
 using namespace solidity;
 using namespace solidity::iele;
 
@@ -12,7 +14,8 @@ IeleFunction::IeleFunction(IeleContext *Ctx, bool isPublic, bool isInit,
   IeleGlobalValue(Ctx, Name, IeleValue::IeleFunctionVal),
   IsPublic(isPublic),
   IsInit(isInit),
-  IsDeposit(isDeposit) {
+  IsDeposit(isDeposit),
+  IsNoInline(false) {
   SymTab = std::make_unique<IeleValueSymbolTable>();
 
   if (C) {
@@ -20,7 +23,34 @@ IeleFunction::IeleFunction(IeleContext *Ctx, bool isPublic, bool isInit,
   }
 }
 
-IeleFunction::~IeleFunction() { }
+IeleFunction::~IeleFunction() {
+  // Delete the blocks, arguments and local variables before the symbol table
+  // holding their names.
+  IeleBlockList.clear();
+  IeleArgumentList.clear();
+  IeleLocalVariableList.clear();
+}
+
+bool IeleFunction::removeUnusedLocalVariables() {
+  std::set<const IeleValue *> Used;
+  for (const IeleBlock &B : blocks()) {
+    for (const IeleInstruction &I : B.instructions()) {
+      Used.insert(I.begin(), I.end());
+      Used.insert(I.lvalue_begin(), I.lvalue_end());
+    }
+  }
+
+  bool Changed = false;
+  for (auto It = lvar_begin(); It != lvar_end();) {
+    if (Used.count(&*It)) {
+      ++It;
+      continue;
+    }
+    It = IeleLocalVariableList.erase(It);
+    Changed = true;
+  }
+  return Changed;
+}
 
 void IeleFunction::printNameAsIeleText(llvm::raw_ostream &OS) const {
   if (!(isInit() || isDeposit()))
@@ -41,6 +41,7 @@ private:
   bool IsPublic;
   bool IsInit;
   bool IsDeposit;
+  bool IsNoInline;
 
   friend class SymbolTableListTraits<IeleFunction>;
 
@@ -81,6 +82,11 @@ public:
   inline bool isDeposit() const { return IsDeposit; }
   inline void setDeposit(bool isDeposit) { IsDeposit = isDeposit; }
 
+  // Functions outlined on purpose by the compiler, e.g. the parts of a
+  // modifier, which FunctionInlining does not inline back.
+  inline bool isNoInline() const { return IsNoInline; }
+  inline void setNoInline(bool isNoInline) { IsNoInline = isNoInline; }
+
   // Get the underlying elements of the IeleFunction.
   //
   const IeleBlockListType &getIeleBlockList() const {
@@ -200,6 +206,10 @@ public:
   size_t  lvar_size() const { return IeleLocalVariableList.size();  }
   bool   lvar_empty() const { return IeleLocalVariableList.empty(); }
 
+  // Removes and deletes the local variables that no instruction of the
+  // function refers to. Returns true if any was removed.
+  bool removeUnusedLocalVariables();
+
   // Helper that prints the function's name as it should appear in the IELE
   // textual format.
   void printNameAsIeleText(llvm::raw_ostream &OS) const;
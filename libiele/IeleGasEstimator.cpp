@@ -0,0 +1,354 @@
+#include "IeleGasEstimator.h"
+
+#include "IeleBlock.h"
+#include "IeleContract.h"
+#include "IeleFunction.h"
+#include "IeleGlobalVariable.h"
+#include "IeleInstruction.h"
+#include "IeleIntConstant.h"
+#include "IeleValueSymbolTable.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// Returns the number of 64-bit words of the value of V.
+uint64_t wordsOf(const IeleValue *V, const IeleGasSchedule &Schedule) {
+  const IeleIntConstant *C = llvm::dyn_cast<IeleIntConstant>(V);
+  if (!C)
+    return Schedule.RegisterWords;
+  bigint Value = C->getValue() < 0 ? bigint(-C->getValue()) : C->getValue();
+  uint64_t Bits = 0;
+  for (; Value != 0; Value >>= 1)
+    ++Bits;
+  // Values are signed, so a word holds 63 bits of magnitude.
+  return Bits / 64 + 1;
+}
+
+uint64_t widestOperand(const IeleInstruction &I,
+                       const IeleGasSchedule &Schedule) {
+  uint64_t Words = 1;
+  for (const IeleValue *V : I.operands())
+    Words = std::max(Words, wordsOf(V, Schedule));
+  return Words;
+}
+
+// Returns the number of words accessed by a memory instruction whose width
+// operand, if any, is at index WidthIndex.
+uint64_t accessedWords(const IeleInstruction &I, unsigned WidthIndex,
+                       const IeleGasSchedule &Schedule) {
+  if (I.size() <= WidthIndex)
+    return Schedule.RegisterWords;
+  const IeleIntConstant *Width =
+    llvm::dyn_cast<IeleIntConstant>(*(I.begin() + WidthIndex));
+  if (!Width)
+    return Schedule.RegisterWords;
+  return uint64_t((Width->getValue() + 7) / 8);
+}
+
+bool mayBeNonZero(const IeleValue *V) {
+  const IeleIntConstant *C = llvm::dyn_cast<IeleIntConstant>(V);
+  return !C || C->getValue() != 0;
+}
+
+IeleGasCost exactly(uint64_t Gas) { return IeleGasCost{Gas, Gas}; }
+
+} // end anonymous namespace
+
+IeleGasCost solidity::iele::getInstructionGasCost(
+    const IeleInstruction &I, const IeleGasSchedule &S) {
+  uint64_t Registers = I.size() + I.lvalue_size();
+  // Every opcode of IeleInstruction.def has a case, so that adding an opcode
+  // without a cost is diagnosed.
+  switch (I.getOpcode()) {
+  case IeleInstruction::Assign:
+    return exactly(S.Move * widestOperand(I, S));
+  case IeleInstruction::Load:
+    return exactly(S.Memory + S.MemoryWord * accessedWords(I, 2, S));
+  case IeleInstruction::Store: {
+    // Memory grows at most by the words written.
+    uint64_t Words = accessedWords(I, 3, S);
+    uint64_t Gas = S.Memory + S.MemoryWord * Words;
+    return IeleGasCost{Gas, Gas + S.MemoryGrowthWord * Words};
+  }
+  case IeleInstruction::SLoad:
+    return exactly(S.SLoad);
+  case IeleInstruction::SStore:
+    return IeleGasCost{S.SStoreReset, S.SStoreSet};
+  case IeleInstruction::IsZero:
+  case IeleInstruction::Not:
+  case IeleInstruction::Add:
+  case IeleInstruction::Sub:
+  case IeleInstruction::Log2:
+  case IeleInstruction::Byte:
+  case IeleInstruction::SExt:
+  case IeleInstruction::Twos:
+  case IeleInstruction::BSwap:
+  case IeleInstruction::And:
+  case IeleInstruction::Or:
+  case IeleInstruction::Xor:
+  case IeleInstruction::Shift:
+  case IeleInstruction::CmpLt:
+  case IeleInstruction::CmpLe:
+  case IeleInstruction::CmpGt:
+  case IeleInstruction::CmpGe:
+  case IeleInstruction::CmpEq:
+  case IeleInstruction::CmpNe:
+    return exactly(S.Arith + S.ArithWord * widestOperand(I, S));
+  case IeleInstruction::Mul:
+  case IeleInstruction::Div:
+  case IeleInstruction::Mod:
+    return exactly(S.Mul + S.MulWord * wordsOf(*I.begin(), S) *
+                             wordsOf(*(I.begin() + 1), S));
+  case IeleInstruction::AddMod:
+  case IeleInstruction::MulMod: {
+    uint64_t Words = widestOperand(I, S);
+    return exactly(S.Mul + S.MulWord * Words * Words);
+  }
+  case IeleInstruction::Exp:
+  case IeleInstruction::ExpMod:
+    return exactly(S.Exp + S.ExpWord * wordsOf(*(I.begin() + 1), S));
+  case IeleInstruction::Sha3:
+    return exactly(S.Sha3 + S.Sha3Word * S.RegisterWords);
+  case IeleInstruction::Br:
+    return exactly(I.isConditionalBranch() ? S.CondJump : S.Jump);
+  case IeleInstruction::Ret:
+  case IeleInstruction::Revert:
+    return exactly(S.Jump + S.CallRegister * I.size());
+  case IeleInstruction::Log:
+    return exactly(S.Log + S.LogTopic * (I.size() - 1) +
+                   S.LogDataWord * S.RegisterWords);
+  case IeleInstruction::Selfdestruct:
+    return IeleGasCost{S.Selfdestruct, S.Selfdestruct + S.NewAccount};
+  case IeleInstruction::Call:
+    return exactly(S.LocalCall + S.CallRegister * Registers);
+  case IeleInstruction::CallAt: {
+    // The operands are the callee, the address, the value and the gas.
+    IeleGasCost Gas = exactly(S.AccountCall + S.CallRegister * Registers);
+    if (mayBeNonZero(*(I.begin() + 2)))
+      Gas.Max += S.CallValue + S.NewAccount;
+    return Gas;
+  }
+  case IeleInstruction::StaticCallAt:
+    return exactly(S.AccountCall + S.CallRegister * Registers);
+  case IeleInstruction::Create:
+  case IeleInstruction::CopyCreate:
+    return exactly(S.Create + S.CallRegister * Registers);
+  case IeleInstruction::Invalid:
+    return exactly(0);
+  case IeleInstruction::CallAddress:
+  case IeleInstruction::Gas:
+  case IeleInstruction::Gasprice:
+  case IeleInstruction::Gaslimit:
+  case IeleInstruction::Beneficiary:
+  case IeleInstruction::Timestamp:
+  case IeleInstruction::Number:
+  case IeleInstruction::Difficulty:
+  case IeleInstruction::Address:
+  case IeleInstruction::Origin:
+  case IeleInstruction::Caller:
+  case IeleInstruction::Callvalue:
+  case IeleInstruction::Msize:
+  case IeleInstruction::Codesize:
+    return exactly(S.Environment);
+  case IeleInstruction::Blockhash:
+    return exactly(S.Blockhash);
+  case IeleInstruction::Balance:
+    return exactly(S.Balance);
+  case IeleInstruction::Extcodesize:
+    return exactly(S.Extcodesize);
+  }
+  return exactly(0);
+}
+
+std::string IeleGasEstimate::minString() const {
+  return std::to_string(Min);
+}
+
+std::string IeleGasEstimate::maxString(const IeleFunction &Owner) const {
+  if (Unbounded)
+    return "infinite";
+  std::ostringstream OS;
+  OS << Max;
+  for (const auto &Loop : LoopIterations) {
+    OS << " + " << Loop.second << "*";
+    if (Loop.first.first != Owner.getName())
+      OS << Loop.first.first << ":";
+    OS << "n" << Loop.first.second;
+  }
+  return OS.str();
+}
+
+IeleGasEstimator::IeleGasEstimator(const IeleContract &Contract,
+                                   IeleGasSchedule Schedule)
+  : Contract(Contract), Schedule(Schedule) {
+  for (const IeleFunction *F : Contract.getRuntimeFunctions())
+    RuntimeFunctions[F->getName().str()] = F;
+}
+
+const IeleGasEstimate &IeleGasEstimator::estimate(const IeleFunction &F) {
+  auto It = Estimates.find(&F);
+  if (It != Estimates.end())
+    return It->second;
+  InProgress.insert(&F);
+  IeleGasEstimate E = compute(F);
+  InProgress.erase(&F);
+  return Estimates.emplace(&F, std::move(E)).first->second;
+}
+
+// Returns the function of the contract or of the IELE runtime that V names,
+// if any. Functions are called either directly or through a global variable
+// with their name.
+const IeleFunction *IeleGasEstimator::getCallee(const IeleValue *V) const {
+  if (const IeleFunction *F = llvm::dyn_cast<IeleFunction>(V))
+    return F;
+  const IeleGlobalVariable *GV = llvm::dyn_cast<IeleGlobalVariable>(V);
+  if (!GV)
+    return nullptr;
+  if (const IeleFunction *F = llvm::dyn_cast_or_null<IeleFunction>(
+        Contract.getIeleValueSymbolTable()->lookup(GV->getName())))
+    return F;
+  auto It = RuntimeFunctions.find(GV->getName().str());
+  return It == RuntimeFunctions.end() ? nullptr : It->second;
+}
+
+IeleGasEstimate IeleGasEstimator::compute(const IeleFunction &F) {
+  IeleGasEstimate E;
+  if (F.empty())
+    return E;
+
+  // The ways to leave each block: a branch or the fall through to a block, or
+  // a return if Target is null, with the gas used in the block until then.
+  struct Exit {
+    const IeleBlock *Target;
+    IeleGasCost Gas;
+  };
+  std::map<const IeleBlock *, std::vector<Exit>> Exits;
+  for (const IeleBlock &B : F.blocks()) {
+    std::vector<Exit> &BlockExits = Exits[&B];
+    IeleGasCost Gas;
+    bool FallsThrough = true;
+    for (const IeleInstruction &I : B.instructions()) {
+      Gas += getInstructionGasCost(I, Schedule);
+      if (I.getOpcode() == IeleInstruction::Call) {
+        const IeleFunction *Callee = getCallee(*I.begin());
+        if (!Callee || InProgress.count(Callee))
+          E.Unbounded = true;
+        else {
+          const IeleGasEstimate &CalleeEstimate = estimate(*Callee);
+          Gas.Min += CalleeEstimate.Min;
+          Gas.Max += CalleeEstimate.Max;
+          E.Unbounded |= CalleeEstimate.Unbounded;
+          for (const auto &Loop : CalleeEstimate.LoopIterations) {
+            uint64_t &Iteration = E.LoopIterations[Loop.first];
+            Iteration = std::max(Iteration, Loop.second);
+          }
+        }
+      }
+      if (I.getOpcode() == IeleInstruction::Br)
+        BlockExits.push_back(Exit{I.getBranchTarget(), Gas});
+      else if (I.getOpcode() == IeleInstruction::Ret)
+        BlockExits.push_back(Exit{nullptr, Gas});
+      if (I.isTerminator()) {
+        FallsThrough = false;
+        break;
+      }
+    }
+    if (FallsThrough && B.getNextNode())
+      BlockExits.push_back(Exit{B.getNextNode(), Gas});
+  }
+
+  // A depth-first search from the entry orders the reachable blocks and finds
+  // the back edges, i.e. the branches to a block on the current path, which
+  // repeat a loop.
+  std::vector<const IeleBlock *> Order;
+  std::set<std::pair<const IeleBlock *, size_t>> BackEdges;
+  {
+    std::set<const IeleBlock *> Visited{&F.front()}, OnPath{&F.front()};
+    std::vector<std::pair<const IeleBlock *, size_t>> Stack{{&F.front(), 0}};
+    while (!Stack.empty()) {
+      const IeleBlock *B = Stack.back().first;
+      size_t Index = Stack.back().second++;
+      const std::vector<Exit> &BlockExits = Exits[B];
+      if (Index == BlockExits.size()) {
+        OnPath.erase(B);
+        Order.push_back(B);
+        Stack.pop_back();
+        continue;
+      }
+      const IeleBlock *Target = BlockExits[Index].Target;
+      if (!Target)
+        continue;
+      if (OnPath.count(Target))
+        BackEdges.emplace(B, Index);
+      else if (Visited.insert(Target).second) {
+        OnPath.insert(Target);
+        Stack.emplace_back(Target, 0);
+      }
+    }
+    std::reverse(Order.begin(), Order.end());
+  }
+
+  // Computes the cheapest and the most expensive paths without back edges
+  // from Start to each block, calling Leave with the gas of the paths to each
+  // exit that is a return or a back edge.
+  auto findPaths = [&](const IeleBlock *Start,
+                       const std::function<void(const Exit &, bool,
+                                                const IeleGasCost &)> &Leave) {
+    std::map<const IeleBlock *, IeleGasCost> Paths{{Start, IeleGasCost()}};
+    for (const IeleBlock *B : Order) {
+      auto It = Paths.find(B);
+      if (It == Paths.end())
+        continue;
+      const std::vector<Exit> &BlockExits = Exits[B];
+      for (size_t Index = 0; Index < BlockExits.size(); ++Index) {
+        const Exit &X = BlockExits[Index];
+        IeleGasCost Gas = It->second;
+        Gas += X.Gas;
+        bool Back = BackEdges.count({B, Index});
+        if (!X.Target || Back) {
+          Leave(X, Back, Gas);
+          continue;
+        }
+        auto Inserted = Paths.emplace(X.Target, Gas);
+        if (!Inserted.second) {
+          IeleGasCost &Known = Inserted.first->second;
+          Known.Min = std::min(Known.Min, Gas.Min);
+          Known.Max = std::max(Known.Max, Gas.Max);
+        }
+      }
+    }
+  };
+
+  bool Returns = false;
+  findPaths(&F.front(), [&](const Exit &X, bool, const IeleGasCost &Gas) {
+    if (X.Target)
+      return;
+    E.Min = Returns ? std::min(E.Min, Gas.Min) : Gas.Min;
+    E.Max = std::max(E.Max, Gas.Max);
+    Returns = true;
+  });
+
+  // The loops are numbered by the position of their header in the function.
+  std::set<const IeleBlock *> Headers;
+  for (const auto &BackEdge : BackEdges)
+    Headers.insert(Exits[BackEdge.first][BackEdge.second].Target);
+  unsigned LoopNumber = 0;
+  for (const IeleBlock &H : F.blocks()) {
+    if (!Headers.count(&H))
+      continue;
+    uint64_t Iteration = 0;
+    findPaths(&H, [&](const Exit &X, bool Back, const IeleGasCost &Gas) {
+      if (Back && X.Target == &H)
+        Iteration = std::max(Iteration, Gas.Max);
+    });
+    E.LoopIterations[{F.getName().str(), ++LoopNumber}] = Iteration;
+  }
+  return E;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace solidity {
+namespace iele {
+
+class IeleContract;
+class IeleFunction;
+class IeleInstruction;
+class IeleValue;
+
+// The gas costs of IELE instructions. The costs follow the structure of the
+// IELE gas schedule: most instructions cost a constant amount plus an amount
+// per 64-bit word of their operands, writing memory is charged for the growth
+// of the memory, and writing a storage entry costs more when the entry was
+// zero. The width of registers is not known at compile time, so registers are
+// assumed to hold RegisterWords words.
+struct IeleGasSchedule {
+  unsigned RegisterWords = 4;
+
+  // Register copies and control flow.
+  uint64_t Move = 1;
+  uint64_t Jump = 4;
+  uint64_t CondJump = 6;
+  uint64_t LocalCall = 10;
+  uint64_t CallRegister = 3;
+
+  // Arithmetic: a constant plus a cost per word of the widest operand, or per
+  // product of the operand widths for multiplication and division.
+  uint64_t Arith = 3;
+  uint64_t ArithWord = 1;
+  uint64_t Mul = 5;
+  uint64_t MulWord = 1;
+  uint64_t Exp = 10;
+  uint64_t ExpWord = 400;
+
+  // Memory and hashing.
+  uint64_t Memory = 3;
+  uint64_t MemoryWord = 1;
+  uint64_t MemoryGrowthWord = 1;
+  uint64_t Sha3 = 30;
+  uint64_t Sha3Word = 2;
+
+  // Storage.
+  uint64_t SLoad = 200;
+  uint64_t SStoreSet = 20000;
+  uint64_t SStoreReset = 5000;
+
+  // Accounts, logs and the environment.
+  uint64_t AccountCall = 700;
+  uint64_t CallValue = 9000;
+  uint64_t NewAccount = 25000;
+  uint64_t Create = 32000;
+  uint64_t CodeDepositByte = 200;
+  uint64_t Log = 375;
+  uint64_t LogTopic = 375;
+  uint64_t LogDataWord = 64;
+  uint64_t Selfdestruct = 5000;
+  uint64_t Environment = 2;
+  uint64_t Blockhash = 20;
+  uint64_t Balance = 400;
+  uint64_t Extcodesize = 700;
+};
+
+// A lower and an upper bound on an amount of gas.
+struct IeleGasCost {
+  uint64_t Min = 0;
+  uint64_t Max = 0;
+
+  IeleGasCost &operator+=(const IeleGasCost &C) {
+    Min += C.Min;
+    Max += C.Max;
+    return *this;
+  }
+};
+
+// Returns the gas used by one execution of I, excluding the gas used by the
+// functions and accounts that it calls.
+IeleGasCost getInstructionGasCost(const IeleInstruction &I,
+                                  const IeleGasSchedule &Schedule);
+
+// An estimate of the gas used by the executions of a function that return
+// normally. Loops make the upper bound depend on the number of iterations:
+// the upper bound is Max plus, for each loop, the gas of one iteration times
+// the number of times the loop is repeated. The loops are those of the
+// function and of the functions it calls, named by the function and the
+// position of the loop in it.
+struct IeleGasEstimate {
+  using LoopName = std::pair<std::string, unsigned>;
+
+  uint64_t Min = 0;
+  uint64_t Max = 0;
+  std::map<LoopName, uint64_t> LoopIterations;
+  // True if the upper bound is unknown, e.g. because of recursion or calls
+  // through function pointers.
+  bool Unbounded = false;
+
+  // Returns the lower bound as a string.
+  std::string minString() const;
+
+  // Returns the upper bound as a string, e.g. "1200 + 310*n1 + 45*f:n2", where
+  // n1 repeats the first loop of Owner and f:n2 the second loop of f, or
+  // "infinite" if it is unbounded.
+  std::string maxString(const IeleFunction &Owner) const;
+};
+
+// Static estimation of the gas used by the functions of an IELE contract.
+// Each function is estimated by a path analysis over its control flow graph:
+// the bounds are the cheapest and the most expensive paths from the entry to
+// a return that do not repeat a loop, where the gas of an internal call is
+// the estimate of its callee. The gas of one iteration of a loop is the most
+// expensive path from the loop header back to it, with inner loops counted
+// separately. Paths that revert are not considered, and neither is the gas
+// forwarded to other accounts by calls and contract creations.
+class IeleGasEstimator {
+public:
+  explicit IeleGasEstimator(const IeleContract &Contract,
+                            IeleGasSchedule Schedule = IeleGasSchedule());
+
+  // Returns the estimate of F, which must be a function of the contract or
+  // of the IELE runtime.
+  const IeleGasEstimate &estimate(const IeleFunction &F);
+
+  // Returns the gas for depositing CodeSize bytes of code on creation.
+  uint64_t getCodeDepositCost(size_t CodeSize) const {
+    return Schedule.CodeDepositByte * CodeSize;
+  }
+
+private:
+  const IeleContract &Contract;
+  IeleGasSchedule Schedule;
+  // The functions of the IELE runtime called by the contract, by name.
+  std::map<std::string, const IeleFunction *> RuntimeFunctions;
+  std::map<const IeleFunction *, IeleGasEstimate> Estimates;
+  std::set<const IeleFunction *> InProgress;
+
+  IeleGasEstimate compute(const IeleFunction &F);
+  const IeleFunction *getCallee(const IeleValue *V) const;
+};
+
+} // end namespace iele
+} // end namespace solidity
@@ -32,6 +32,12 @@ IeleInstruction::IeleInstruction(IeleOps opc, const SourceLocation &Loc,
 }
 
 void IeleInstruction::setParent(IeleBlock *parent) {
+  // Nothing to check when the instruction is removed from its block.
+  if (!parent) {
+    Parent = nullptr;
+    return;
+  }
+
   // Assert that all operands and lvalues have the same parent as the block.
   IeleFunction *F = parent->getParent();
   for (const IeleValue *V : operands()) {
@@ -68,6 +74,112 @@ const IeleValueSymbolTable *IeleInstruction::getIeleValueSymbolTable() const {
 
 IeleInstruction::~IeleInstruction() { }
 
+void IeleInstruction::eraseFromParent() {
+  solAssert(Parent, "Instruction is not in a block!");
+  Parent->getIeleInstructionList().erase(getIterator());
+}
+
+bool IeleInstruction::isTerminator() const {
+  switch (InstID) {
+  case Ret:
+  case Revert:
+  case Invalid:
+    return true;
+  case Br:
+    return !isConditionalBranch();
+  default:
+    return false;
+  }
+}
+
+bool IeleInstruction::mayHaveSideEffects() const {
+  // Calls may do anything, but all intrinsics other than @iele.invalid only
+  // read the state of the VM.
+  if (InstID >= IeleCallsBegin && InstID < IeleCallsEnd)
+    return true;
+  if (InstID >= IeleIntrinsicsBegin && InstID < IeleIntrinsicsEnd)
+    return InstID == Invalid;
+
+  switch (InstID) {
+  case Assign:
+  case SLoad:
+  case IsZero:
+  case Not:
+  case Add:
+  case Mul:
+  case Sub:
+  case Shift:
+  case And:
+  case Or:
+  case Xor:
+  case CmpLt:
+  case CmpLe:
+  case CmpGt:
+  case CmpGe:
+  case CmpEq:
+  case CmpNe:
+    return false;
+  default:
+    // Memory accesses and the remaining arithmetic may throw on some
+    // operands, e.g. on division by zero.
+    return true;
+  }
+}
+
+bool IeleInstruction::isPure() const {
+  switch (InstID) {
+  case IsZero:
+  case Not:
+  case Add:
+  case Mul:
+  case Sub:
+  case Div:
+  case Exp:
+  case Mod:
+  case Log2:
+  case AddMod:
+  case MulMod:
+  case ExpMod:
+  case Byte:
+  case SExt:
+  case Twos:
+  case BSwap:
+  case And:
+  case Or:
+  case Xor:
+  case Shift:
+  case CmpLt:
+  case CmpLe:
+  case CmpGt:
+  case CmpGe:
+  case CmpEq:
+  case CmpNe:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool IeleInstruction::isCommutative() const {
+  switch (InstID) {
+  case Add:
+  case Mul:
+  case And:
+  case Or:
+  case Xor:
+  case CmpEq:
+  case CmpNe:
+    return true;
+  default:
+    return false;
+  }
+}
+
+IeleBlock *IeleInstruction::getBranchTarget() const {
+  solAssert(InstID == Br, "Instruction is not a branch!");
+  return llvm::cast<IeleBlock>(IeleOperandList.back());
+}
+
 IeleInstruction *IeleInstruction::CreateRetVoid(const SourceLocation &Loc, IeleInstruction *InsertBefore) {
   return new IeleInstruction(Ret, Loc, InsertBefore);
 }
@@ -793,6 +905,16 @@ IeleInstruction *IeleInstruction::CreateTernOp(
   return TernOpInst;
 }
 
+IeleInstruction *IeleInstruction::CreateCopy(
+    const IeleInstruction &I, const IeleOperandListType &Operands,
+    const IeleLValueListType &LValues, IeleBlock *InsertAtEnd) {
+  IeleInstruction *Copy =
+    new IeleInstruction(I.getOpcode(), I.location(), InsertAtEnd);
+  Copy->getIeleOperandList() = Operands;
+  Copy->getIeleLValueList() = LValues;
+  return Copy;
+}
+
 static void printOpcode(llvm::raw_ostream &OS, const IeleInstruction *I) {
   switch (I->getOpcode()) {
 #define HANDLE_IELE_INST(N, OPC, TXT) \
@@ -79,6 +79,38 @@ public:
 
   inline const langutil::SourceLocation &location() const { return Location; }
 
+  // Unlinks the instruction from its block and deletes it.
+  void eraseFromParent();
+
+  // Returns true if execution never continues with the next instruction of
+  // the block, i.e. for unconditional branches, ret, revert and invalid.
+  bool isTerminator() const;
+
+  // Returns true if this is a conditional branch. Conditional branches fall
+  // through to the next instruction when their condition is zero.
+  bool isConditionalBranch() const {
+    return InstID == Br && IeleOperandList.size() == 2;
+  }
+
+  // Returns the target block of a branch instruction.
+  IeleBlock *getBranchTarget() const;
+
+  // Returns true if executing the instruction may have an effect other than
+  // assigning its lvalues, such as writing to memory or storage, transferring
+  // control, calling a function or throwing an exception. Instructions
+  // without side effects whose lvalues are never read can be removed.
+  bool mayHaveSideEffects() const;
+
+  // Returns true if the result of the instruction only depends on its
+  // operands, so that two such instructions with the same opcode and operands
+  // compute the same value. Pure instructions may still throw, e.g. on
+  // division by zero.
+  bool isPure() const;
+
+  // Returns true if the instruction is a binary operation whose operands can
+  // be swapped without changing its result.
+  bool isCommutative() const;
+
   // Get the operands/lvalues of the IeleInstruction.
   //
   const IeleOperandListType &getIeleOperandList() const {
@@ -409,6 +441,12 @@ public:
       const langutil::SourceLocation &Loc,
       IeleBlock *InsertAtEnd);
 
+  // Creates an instruction with the opcode and location of I, but with the
+  // given operands and lvalues, e.g. for copying I into another function.
+  static IeleInstruction *CreateCopy(
+      const IeleInstruction &I, const IeleOperandListType &Operands,
+      const IeleLValueListType &LValues, IeleBlock *InsertAtEnd);
+
   void print(llvm::raw_ostream &OS, unsigned indent = 0) const;
 };
 
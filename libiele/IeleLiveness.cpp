@@ -0,0 +1,81 @@
+#include "IeleLiveness.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleInstruction.h"
+#include "IeleLocalVariable.h"
+
+using namespace solidity;
+using namespace solidity::iele;
+
+IeleLiveness::IeleLiveness(const IeleFunction &F) {
+  // Iterate to a fixpoint, visiting blocks in reverse order so that most
+  // successors are visited before their predecessors.
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (auto It = F.getIeleBlockList().rbegin(),
+              End = F.getIeleBlockList().rend(); It != End; ++It) {
+      RegisterSet In = transfer(*It, nullptr);
+      RegisterSet &Old = LiveIn[&*It];
+      if (In != Old) {
+        Old = std::move(In);
+        Changed = true;
+      }
+    }
+  }
+}
+
+const IeleLiveness::RegisterSet &
+IeleLiveness::getLiveIn(const IeleBlock &B) const {
+  auto It = LiveIn.find(&B);
+  return It == LiveIn.end() ? Empty : It->second;
+}
+
+void IeleLiveness::forEachInstruction(
+    const IeleBlock &B,
+    std::function<void(const IeleInstruction &, const RegisterSet &)>
+      Callback) const {
+  transfer(B, Callback);
+}
+
+const IeleLocalVariable *IeleLiveness::asRegister(const IeleValue *V) {
+  return llvm::dyn_cast<IeleLocalVariable>(V);
+}
+
+IeleLiveness::RegisterSet IeleLiveness::transfer(
+    const IeleBlock &B,
+    const std::function<void(const IeleInstruction &, const RegisterSet &)>
+      &Callback) const {
+  // Instructions after the first terminator are never executed.
+  auto End = B.begin();
+  while (End != B.end() && !End->isTerminator())
+    ++End;
+
+  RegisterSet Live;
+  if (End != B.end())
+    ++End;
+  else if (const IeleBlock *Next = B.getNextNode())
+    Live = getLiveIn(*Next);
+
+  for (auto It = End; It != B.begin();) {
+    const IeleInstruction &I = *--It;
+    if (I.getOpcode() == IeleInstruction::Br) {
+      const RegisterSet &Target = getLiveIn(*I.getBranchTarget());
+      if (I.isConditionalBranch())
+        Live.insert(Target.begin(), Target.end());
+      else
+        Live = Target;
+    }
+
+    if (Callback)
+      Callback(I, Live);
+
+    for (const IeleLocalVariable *LV : I.lvalues())
+      Live.erase(LV);
+    for (const IeleValue *V : I.operands())
+      if (const IeleLocalVariable *LV = asRegister(V))
+        Live.insert(LV);
+  }
+  return Live;
+}
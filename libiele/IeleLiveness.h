@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <set>
+
+namespace solidity {
+namespace iele {
+
+class IeleBlock;
+class IeleFunction;
+class IeleInstruction;
+class IeleLocalVariable;
+class IeleValue;
+
+// Liveness of the registers (arguments and local variables) of an
+// IeleFunction. A register is live at a program point if its current value
+// may be read before it is next assigned.
+//
+// The analysis is invalidated by any change to the function.
+//
+class IeleLiveness {
+public:
+  using RegisterSet = std::set<const IeleLocalVariable *>;
+
+  explicit IeleLiveness(const IeleFunction &F);
+
+  // Returns the registers live at the entry of B. Blocks that are never
+  // visited by the analysis (e.g. because they are only reachable through
+  // unreachable code) have no live registers.
+  const RegisterSet &getLiveIn(const IeleBlock &B) const;
+
+  // Calls Callback for each instruction of B that can be executed, from last
+  // to first, with the registers that are live right after the instruction.
+  void forEachInstruction(
+    const IeleBlock &B,
+    std::function<void(const IeleInstruction &, const RegisterSet &)>
+      Callback) const;
+
+  // Returns the register V if it is one, otherwise nullptr.
+  static const IeleLocalVariable *asRegister(const IeleValue *V);
+
+private:
+  std::map<const IeleBlock *, RegisterSet> LiveIn;
+  RegisterSet Empty;
+
+  // Computes the registers live at the entry of B from the current
+  // approximation of LiveIn, calling Callback as forEachInstruction does.
+  RegisterSet transfer(
+    const IeleBlock &B,
+    const std::function<void(const IeleInstruction &, const RegisterSet &)>
+      &Callback) const;
+};
+
+} // end namespace iele
+} // end namespace solidity
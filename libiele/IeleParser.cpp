@@ -0,0 +1,435 @@
+#include "IeleParser.h"
+
+#include "IeleContract.h"
+#include "IeleFunction.h"
+#include "IeleGlobalVariable.h"
+#include "IeleIntConstant.h"
+#include "IeleValueSymbolTable.h"
+
+#include <liblangutil/Exceptions.h>
+
+#include <cctype>
+#include <map>
+
+using namespace solidity;
+using namespace solidity::iele;
+using namespace solidity::langutil;
+
+namespace {
+
+bool isNameChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '_' ||
+         c == '$';
+}
+
+// Maps the textual form of an IELE operation to its opcode. Intrinsics are
+// keyed with their leading '@'.
+const std::map<std::string, IeleInstruction::IeleOps> &opcodeTable() {
+  static const std::map<std::string, IeleInstruction::IeleOps> Table = {
+#define HANDLE_IELE_INST(N, OPC, TXT) { TXT, IeleInstruction::OPC },
+#include "IeleInstruction.def"
+  };
+  return Table;
+}
+
+} // end anonymous namespace
+
+void IeleParser::tokenize(const std::string &Source) {
+  Tokens.clear();
+  Pos = 0;
+  size_t i = 0, e = Source.size();
+  while (i < e) {
+    char c = Source[i];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      ++i;
+    } else if (c == '/' && i + 1 < e && Source[i + 1] == '/') {
+      while (i < e && Source[i] != '\n')
+        ++i;
+    } else if (c == '%' || c == '@') {
+      ++i;
+      std::string Name;
+      if (i < e && Source[i] == '"') {
+        // Quoted name, possibly containing \xx escapes.
+        ++i;
+        while (i < e && Source[i] != '"') {
+          if (Source[i] == '\\') {
+            solAssert(i + 2 < e, "IeleParser: truncated escape sequence");
+            Name.push_back(
+              static_cast<char>(std::stoi(Source.substr(i + 1, 2), nullptr, 16)));
+            i += 3;
+          } else {
+            Name.push_back(Source[i++]);
+          }
+        }
+        solAssert(i < e, "IeleParser: unterminated quoted name");
+        ++i;
+      } else {
+        while (i < e && isNameChar(Source[i]))
+          Name.push_back(Source[i++]);
+      }
+      solAssert(!Name.empty(), "IeleParser: empty name");
+      Tokens.push_back(
+        {c == '%' ? TokenKind::LocalName : TokenKind::GlobalName, Name});
+    } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+               (c == '-' && i + 1 < e &&
+                std::isdigit(static_cast<unsigned char>(Source[i + 1])))) {
+      std::string Number(1, c);
+      ++i;
+      while (i < e && (std::isxdigit(static_cast<unsigned char>(Source[i])) ||
+                       Source[i] == 'x' || Source[i] == 'X'))
+        Number.push_back(Source[i++]);
+      Tokens.push_back({TokenKind::Number, Number});
+    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      std::string Identifier;
+      while (i < e && isNameChar(Source[i]))
+        Identifier.push_back(Source[i++]);
+      Tokens.push_back({TokenKind::Identifier, Identifier});
+    } else {
+      solAssert(std::string("(){},:=").find(c) != std::string::npos,
+                std::string("IeleParser: unexpected character '") + c + "'");
+      Tokens.push_back({TokenKind::Punctuation, std::string(1, c)});
+      ++i;
+    }
+  }
+  Tokens.push_back({TokenKind::End, ""});
+}
+
+const IeleParser::Token &IeleParser::peek(size_t Ahead) const {
+  size_t Index = std::min(Pos + Ahead, Tokens.size() - 1);
+  return Tokens[Index];
+}
+
+IeleParser::Token IeleParser::next() {
+  Token T = peek();
+  if (Pos < Tokens.size() - 1)
+    ++Pos;
+  return T;
+}
+
+bool IeleParser::atPunctuation(char C, size_t Ahead) const {
+  const Token &T = peek(Ahead);
+  return T.Kind == TokenKind::Punctuation && T.Text[0] == C;
+}
+
+bool IeleParser::atIdentifier(llvm::StringRef Text, size_t Ahead) const {
+  const Token &T = peek(Ahead);
+  return T.Kind == TokenKind::Identifier && T.Text == Text;
+}
+
+void IeleParser::expectPunctuation(char C) {
+  solAssert(atPunctuation(C),
+            std::string("IeleParser: expected '") + C + "' but found '" +
+            peek().Text + "'");
+  next();
+}
+
+void IeleParser::parseFunctions(const std::string &Source,
+                                IeleContract *Contract) {
+  solAssert(Contract, "IeleParser: no contract to parse into");
+  CompilingContract = Contract;
+  tokenize(Source);
+
+  while (peek().Kind != TokenKind::End) {
+    if (peek().Kind == TokenKind::GlobalName) {
+      // Global constant definition. Its value lives outside of the IR.
+      next();
+      expectPunctuation('=');
+      solAssert(next().Kind == TokenKind::Number,
+                "IeleParser: expected global constant value");
+      continue;
+    }
+    parseFunction();
+  }
+
+  CompilingContract = nullptr;
+}
+
+void IeleParser::parseFunction() {
+  solAssert(atIdentifier("define"), "IeleParser: expected function definition");
+  next();
+  bool IsPublic = false;
+  if (atIdentifier("public")) {
+    IsPublic = true;
+    next();
+  }
+  Token Name = next();
+  solAssert(Name.Kind == TokenKind::GlobalName,
+            "IeleParser: expected function name");
+
+  if (Name.Text == "init")
+    CompilingFunction = IeleFunction::CreateInit(Context, CompilingContract);
+  else if (Name.Text == "deposit")
+    CompilingFunction =
+      IeleFunction::CreateDeposit(Context, IsPublic, CompilingContract);
+  else
+    CompilingFunction =
+      IeleFunction::Create(Context, IsPublic, Name.Text, CompilingContract);
+
+  Locals.clear();
+  Labels.clear();
+
+  // Formal arguments.
+  expectPunctuation('(');
+  while (!atPunctuation(')')) {
+    Token Arg = next();
+    solAssert(Arg.Kind == TokenKind::LocalName,
+              "IeleParser: expected formal argument");
+    Locals[Arg.Text] = IeleArgument::Create(Context, Arg.Text, CompilingFunction);
+    if (!atPunctuation(')'))
+      expectPunctuation(',');
+  }
+  expectPunctuation(')');
+  expectPunctuation('{');
+
+  // Create all blocks upfront, in order of appearance, so that forward branch
+  // targets are already attached to the function.
+  for (size_t i = Pos; i + 1 < Tokens.size(); ++i) {
+    if (Tokens[i].Kind == TokenKind::Punctuation && Tokens[i].Text == "}")
+      break;
+    if (Tokens[i].Kind == TokenKind::Identifier &&
+        Tokens[i + 1].Kind == TokenKind::Punctuation &&
+        Tokens[i + 1].Text == ":")
+      Labels[Tokens[i].Text] =
+        IeleBlock::Create(Context, Tokens[i].Text, CompilingFunction);
+  }
+
+  solAssert(peek().Kind == TokenKind::Identifier && atPunctuation(':', 1),
+            "IeleParser: function body should start with a label");
+  while (!atPunctuation('}')) {
+    if (peek().Kind == TokenKind::Identifier && atPunctuation(':', 1)) {
+      CompilingBlock = Labels[next().Text];
+      next();
+      continue;
+    }
+    parseInstruction();
+  }
+  expectPunctuation('}');
+
+  CompilingBlock = nullptr;
+  CompilingFunction = nullptr;
+}
+
+void IeleParser::parseInstruction() {
+  SourceLocation Loc;
+  const Token &T = peek();
+  if (T.Kind == TokenKind::LocalName) {
+    parseAssignment();
+    return;
+  }
+
+  solAssert(T.Kind == TokenKind::Identifier,
+            "IeleParser: unexpected token '" + T.Text + "'");
+  std::string Keyword = next().Text;
+  llvm::SmallVector<IeleValue *, 4> Operands;
+  if (Keyword == "br") {
+    if (peek().Kind == TokenKind::Identifier) {
+      IeleInstruction::CreateUncondBr(parseLabel(), Loc, CompilingBlock);
+    } else {
+      IeleValue *Condition = parseOperand();
+      expectPunctuation(',');
+      IeleInstruction::CreateCondBr(Condition, parseLabel(), Loc,
+                                    CompilingBlock);
+    }
+  } else if (Keyword == "ret") {
+    if (atIdentifier("void"))
+      next();
+    else
+      parseOperands(Operands);
+    IeleInstruction::CreateRet(Operands, Loc, CompilingBlock);
+  } else if (Keyword == "revert") {
+    IeleInstruction::CreateRevert(parseOperand(), Loc, CompilingBlock);
+  } else if (Keyword == "selfdestruct") {
+    IeleInstruction::CreateSelfdestruct(parseOperand(), Loc, CompilingBlock);
+  } else if (Keyword == "log") {
+    parseOperands(Operands);
+    IeleValue *NonIndexed = Operands.front();
+    llvm::SmallVector<IeleValue *, 4> Indexed(Operands.begin() + 1,
+                                              Operands.end());
+    IeleInstruction::CreateLog(Indexed, NonIndexed, Loc, CompilingBlock);
+  } else if (Keyword == "store" || Keyword == "sstore") {
+    parseOperands(Operands);
+    appendOperation(
+      Keyword == "store" ? IeleInstruction::Store : IeleInstruction::SStore,
+      nullptr, Operands);
+  } else if (Keyword == "call") {
+    size_t CalleePos = Pos;
+    IeleValue *Callee = parseCallee();
+    parseCallArguments(Operands);
+    llvm::SmallVector<IeleLocalVariable *, 1> NoResults;
+    if (Callee)
+      IeleInstruction::CreateInternalCall(NoResults, Callee, Operands, Loc,
+                                          CompilingBlock);
+    else
+      IeleInstruction::CreateIntrinsicCall(
+        opcodeTable().at("@" + Tokens[CalleePos].Text), nullptr, Operands,
+        Loc, CompilingBlock);
+  } else {
+    solAssert(false, "IeleParser: unsupported instruction '" + Keyword + "'");
+  }
+}
+
+void IeleParser::parseAssignment() {
+  SourceLocation Loc;
+  llvm::SmallVector<IeleLocalVariable *, 2> Results;
+  Results.push_back(parseLValue());
+  while (atPunctuation(',')) {
+    next();
+    Results.push_back(parseLValue());
+  }
+  expectPunctuation('=');
+
+  llvm::SmallVector<IeleValue *, 4> Operands;
+  if (atIdentifier("call")) {
+    next();
+    size_t CalleePos = Pos;
+    IeleValue *Callee = parseCallee();
+    parseCallArguments(Operands);
+    if (Callee) {
+      IeleInstruction::CreateInternalCall(Results, Callee, Operands, Loc,
+                                          CompilingBlock);
+    } else {
+      solAssert(Results.size() == 1,
+                "IeleParser: intrinsic calls have at most one result");
+      IeleInstruction::CreateIntrinsicCall(
+        opcodeTable().at("@" + Tokens[CalleePos].Text), Results.front(),
+        Operands, Loc, CompilingBlock);
+    }
+    return;
+  }
+
+  solAssert(Results.size() == 1,
+            "IeleParser: only calls may have multiple results");
+  if (peek().Kind == TokenKind::Identifier) {
+    std::string Mnemonic = next().Text;
+    if (Mnemonic == "cmp")
+      Mnemonic += " " + next().Text;
+    auto It = opcodeTable().find(Mnemonic);
+    solAssert(It != opcodeTable().end(),
+              "IeleParser: unknown operation '" + Mnemonic + "'");
+    parseOperands(Operands);
+    appendOperation(It->second, Results.front(), Operands);
+    return;
+  }
+
+  IeleInstruction::CreateAssign(Results.front(), parseOperand(), Loc,
+                                CompilingBlock);
+}
+
+IeleLocalVariable *IeleParser::parseLValue() {
+  IeleValue *V = parseOperand();
+  IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V);
+  solAssert(LV, "IeleParser: expected register as lvalue");
+  return LV;
+}
+
+IeleValue *IeleParser::parseOperand() {
+  Token T = next();
+  switch (T.Kind) {
+  case TokenKind::LocalName: {
+    IeleLocalVariable *&LV = Locals[T.Text];
+    if (!LV)
+      LV = IeleLocalVariable::Create(Context, T.Text, CompilingFunction);
+    return LV;
+  }
+  case TokenKind::Number:
+    return IeleIntConstant::Create(Context, bigint(T.Text));
+  case TokenKind::GlobalName: {
+    IeleValueSymbolTable *ST = CompilingContract->getIeleValueSymbolTable();
+    if (IeleValue *V = ST->lookup(T.Text))
+      return V;
+    return IeleGlobalVariable::Create(Context, T.Text);
+  }
+  default:
+    solAssert(false, "IeleParser: expected operand but found '" + T.Text + "'");
+  }
+  return nullptr;
+}
+
+IeleBlock *IeleParser::parseLabel() {
+  Token T = next();
+  solAssert(T.Kind == TokenKind::Identifier, "IeleParser: expected label");
+  auto It = Labels.find(T.Text);
+  solAssert(It != Labels.end(), "IeleParser: undefined label '" + T.Text + "'");
+  return It->second;
+}
+
+// Returns the callee of a local call, or nullptr in case of an intrinsic.
+IeleValue *IeleParser::parseCallee() {
+  const Token &T = peek();
+  solAssert(T.Kind == TokenKind::GlobalName || T.Kind == TokenKind::LocalName,
+            "IeleParser: expected callee");
+  if (T.Kind == TokenKind::GlobalName &&
+      opcodeTable().count("@" + T.Text)) {
+    next();
+    return nullptr;
+  }
+  return parseOperand();
+}
+
+void IeleParser::parseOperands(llvm::SmallVectorImpl<IeleValue *> &Operands) {
+  Operands.push_back(parseOperand());
+  while (atPunctuation(',')) {
+    next();
+    Operands.push_back(parseOperand());
+  }
+}
+
+void IeleParser::parseCallArguments(
+    llvm::SmallVectorImpl<IeleValue *> &Arguments) {
+  expectPunctuation('(');
+  if (!atPunctuation(')'))
+    parseOperands(Arguments);
+  expectPunctuation(')');
+}
+
+void IeleParser::appendOperation(
+    IeleInstruction::IeleOps Opcode, IeleLocalVariable *Result,
+    llvm::SmallVectorImpl<IeleValue *> &Operands) {
+  SourceLocation Loc;
+  switch (Opcode) {
+  case IeleInstruction::Load:
+    if (Operands.size() == 1)
+      IeleInstruction::CreateLoad(Result, Operands[0], Loc, CompilingBlock);
+    else
+      IeleInstruction::CreateLoad(Result, Operands[0], Operands[1],
+                                  Operands[2], Loc, CompilingBlock);
+    break;
+  case IeleInstruction::Store:
+    if (Operands.size() == 2)
+      IeleInstruction::CreateStore(Operands[0], Operands[1], Loc,
+                                   CompilingBlock);
+    else
+      IeleInstruction::CreateStore(Operands[0], Operands[1], Operands[2],
+                                   Operands[3], Loc, CompilingBlock);
+    break;
+  case IeleInstruction::SLoad:
+    IeleInstruction::CreateSLoad(Result, Operands[0], Loc, CompilingBlock);
+    break;
+  case IeleInstruction::SStore:
+    IeleInstruction::CreateSStore(Operands[0], Operands[1], Loc,
+                                  CompilingBlock);
+    break;
+  case IeleInstruction::IsZero:
+    IeleInstruction::CreateIsZero(Result, Operands[0], Loc, CompilingBlock);
+    break;
+  case IeleInstruction::Not:
+    IeleInstruction::CreateNot(Result, Operands[0], Loc, CompilingBlock);
+    break;
+  case IeleInstruction::Log2:
+    IeleInstruction::CreateLog2(Result, Operands[0], Loc, CompilingBlock);
+    break;
+  case IeleInstruction::Sha3:
+    IeleInstruction::CreateSha3(Result, Operands[0], Loc, CompilingBlock);
+    break;
+  default:
+    solAssert(Result, "IeleParser: operation requires a result");
+    if (Operands.size() == 2)
+      IeleInstruction::CreateBinOp(Opcode, Result, Operands[0], Operands[1],
+                                   Loc, CompilingBlock);
+    else if (Operands.size() == 3)
+      IeleInstruction::CreateTernOp(Opcode, Result, Operands[0], Operands[1],
+                                    Operands[2], Loc, CompilingBlock);
+    else
+      solAssert(false, "IeleParser: wrong number of operands");
+  }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "IeleInstruction.h"
+#include "IeleValue.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+
+#include <string>
+#include <vector>
+
+namespace solidity {
+namespace iele {
+
+// A parser for the subset of the IELE textual format that is produced by
+// IeleContract::print for function definitions. It is used to turn IELE source
+// that is not generated by the IeleCompiler (e.g. the IELE runtime found under
+// iele-rt/) into IeleFunction objects, so that the rest of the backend can
+// treat it like any other compiled code.
+//
+// Only local (non-account) calls and intrinsic calls are supported. Calls to
+// functions that are not defined in the target contract are represented as
+// unattached IeleGlobalVariable callees, in the same way the IeleCompiler
+// refers to the IELE runtime. Global constant definitions (@name = value) are
+// skipped, since their values are kept outside of the IR by IeleContract.
+//
+// Malformed input is considered an internal error and is reported with
+// solAssert.
+//
+class IeleParser {
+public:
+  explicit IeleParser(IeleContext *Ctx) : Context(Ctx) { }
+
+  // Parses all function definitions found in Source and appends them to the
+  // end of the function list of Contract.
+  void parseFunctions(const std::string &Source, IeleContract *Contract);
+
+private:
+  enum class TokenKind {
+    Identifier,   // names, labels and keywords
+    LocalName,    // %name
+    GlobalName,   // @name or @"name"
+    Number,
+    Punctuation,  // one of ( ) { } , : =
+    End
+  };
+
+  struct Token {
+    TokenKind Kind;
+    std::string Text;
+  };
+
+  IeleContext *Context;
+  std::vector<Token> Tokens;
+  size_t Pos = 0;
+
+  // Per-function parsing state.
+  IeleContract *CompilingContract = nullptr;
+  IeleFunction *CompilingFunction = nullptr;
+  IeleBlock *CompilingBlock = nullptr;
+  llvm::StringMap<IeleLocalVariable *> Locals;
+  llvm::StringMap<IeleBlock *> Labels;
+
+  void tokenize(const std::string &Source);
+
+  const Token &peek(size_t Ahead = 0) const;
+  Token next();
+  bool atPunctuation(char C, size_t Ahead = 0) const;
+  bool atIdentifier(llvm::StringRef Text, size_t Ahead = 0) const;
+  void expectPunctuation(char C);
+
+  void parseFunction();
+  void parseInstruction();
+  void parseAssignment();
+
+  IeleValue *parseOperand();
+  IeleLocalVariable *parseLValue();
+  IeleBlock *parseLabel();
+  IeleValue *parseCallee();
+  void parseOperands(llvm::SmallVectorImpl<IeleValue *> &Operands);
+  void parseCallArguments(llvm::SmallVectorImpl<IeleValue *> &Arguments);
+  void appendOperation(
+      IeleInstruction::IeleOps Opcode, IeleLocalVariable *Result,
+      llvm::SmallVectorImpl<IeleValue *> &Operands);
+};
+
+} // end namespace iele
+} // end namespace solidity
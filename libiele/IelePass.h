@@ -0,0 +1,57 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace solidity {
+namespace iele {
+
+class IeleContract;
+class IeleFunction;
+
+// Base class of all transformations of the IELE IR. A contract pass may
+// inspect and modify the whole contract, e.g. for moving code between
+// functions. Passes are run by the IelePassManager.
+//
+class IeleContractPass {
+public:
+  virtual ~IeleContractPass() = default;
+
+  // Returns the name of the pass, as shown in statistics reports.
+  virtual const char *getName() const = 0;
+
+  // Runs the pass on Contract. Returns true if the contract was modified.
+  virtual bool runOnContract(IeleContract &Contract) = 0;
+
+  // Returns what the counts reported per function by the pass measure, e.g.
+  // "checks removed", or nullptr if the pass reports no counts.
+  virtual const char *getCountDescription() const { return nullptr; }
+
+  // Returns the counts reported by the pass, accumulated over all of its runs,
+  // by function name.
+  const std::map<std::string, unsigned> &getFunctionCounts() const {
+    return FunctionCounts;
+  }
+
+protected:
+  // Adds N to the count reported for F.
+  void count(const IeleFunction &F, unsigned N = 1);
+
+private:
+  std::map<std::string, unsigned> FunctionCounts;
+};
+
+// Base class of transformations that only inspect and modify a single
+// function at a time. The pass is run on every function defined in the
+// contract, in order.
+//
+class IeleFunctionPass : public IeleContractPass {
+public:
+  bool runOnContract(IeleContract &Contract) final;
+
+  // Runs the pass on F. Returns true if the function was modified.
+  virtual bool runOnFunction(IeleFunction &F) = 0;
+};
+
+} // end namespace iele
+} // end namespace solidity
@@ -0,0 +1,231 @@
+#include "IelePassManager.h"
+
+#include "IeleAssembler.h"
+#include "IeleBlock.h"
+#include "IeleContract.h"
+#include "IeleFunction.h"
+#include "IelePasses.h"
+
+#include <libsolutil/Assertions.h>
+
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace solidity;
+using namespace solidity::iele;
+
+bool IeleFunctionPass::runOnContract(IeleContract &Contract) {
+  bool Changed = false;
+  for (IeleFunction &F : Contract.functions())
+    Changed |= runOnFunction(F);
+  return Changed;
+}
+
+void IeleContractPass::count(const IeleFunction &F, unsigned N) {
+  if (N != 0)
+    FunctionCounts[F.getName().str()] += N;
+}
+
+namespace {
+
+// Adapts the factory of a pass that takes no options to PassInfo::Create.
+template <std::unique_ptr<IeleContractPass> (*Create)()>
+std::unique_ptr<IeleContractPass> withoutOptions(const IelePassManager &) {
+  return Create();
+}
+
+} // end anonymous namespace
+
+const std::map<char, IelePassManager::PassInfo> &IelePassManager::allPasses() {
+  static const std::map<char, PassInfo> Passes = {
+    {'c', {"ConstantPropagation",
+           withoutOptions<createConstantPropagationPass>}},
+    {'d', {"DeadCodeElimination",
+           withoutOptions<createDeadCodeEliminationPass>}},
+    {'e', {"CommonSubexpressionElimination",
+           withoutOptions<createCommonSubexpressionEliminationPass>}},
+    {'i', {"FunctionInlining",
+           [](const IelePassManager &PM) {
+             return createFunctionInliningPass(PM.InlineThreshold);
+           }}},
+    {'l', {"LoopInvariantCodeMotion",
+           withoutOptions<createLoopInvariantCodeMotionPass>}},
+    {'p', {"CopyPropagation", withoutOptions<createCopyPropagationPass>}},
+    {'r', {"RegisterCoalescing",
+           withoutOptions<createRegisterCoalescingPass>}},
+    {'s', {"StorageValueNumbering",
+           withoutOptions<createStorageValueNumberingPass>}},
+    {'v', {"RangeCheckElimination",
+           withoutOptions<createRangeCheckEliminationPass>}},
+  };
+  return Passes;
+}
+
+const std::map<char, std::string> &IelePassManager::passNames() {
+  static const std::map<char, std::string> Names = [] {
+    std::map<char, std::string> Result;
+    for (const auto &Entry : allPasses())
+      Result[Entry.first] = Entry.second.Name;
+    return Result;
+  }();
+  return Names;
+}
+
+void IelePassManager::validatePipeline(const std::string &Pipeline) {
+  bool InsideLoop = false;
+  for (char Abbreviation : Pipeline) {
+    switch (Abbreviation) {
+    case ' ':
+    case '\n':
+      break;
+    case '[':
+      assertThrow(!InsideLoop, IelePipelineError,
+                  "Nested brackets are not supported");
+      InsideLoop = true;
+      break;
+    case ']':
+      assertThrow(InsideLoop, IelePipelineError, "Unbalanced brackets");
+      InsideLoop = false;
+      break;
+    default:
+      assertThrow(allPasses().count(Abbreviation), IelePipelineError,
+                  std::string("'") + Abbreviation +
+                  "' is not a valid IELE pass abbreviation");
+    }
+  }
+  assertThrow(!InsideLoop, IelePipelineError, "Unbalanced brackets");
+}
+
+IelePassManager::IelePassManager(std::string P) : Pipeline(std::move(P)) {
+  validatePipeline(Pipeline);
+}
+
+size_t IelePassManager::countInstructions(const IeleContract &Contract) {
+  size_t Count = 0;
+  for (const IeleFunction &F : Contract.functions())
+    for (const IeleBlock &B : F.blocks())
+      Count += B.size();
+  return Count;
+}
+
+bool IelePassManager::run(IeleContractPass &Pass, IeleContract &Contract) {
+  if (MeasureCodeSize && MeasuredContract != &Contract) {
+    MeasuredContract = &Contract;
+    MeasuredCodeSize = IeleAssembler::assemble(Contract).size();
+  }
+
+  size_t InstructionsBefore = countInstructions(Contract);
+  auto Start = std::chrono::steady_clock::now();
+  bool Changed = Pass.runOnContract(Contract);
+  auto End = std::chrono::steady_clock::now();
+  size_t InstructionsAfter = countInstructions(Contract);
+
+  auto Inserted = StatisticsIndex.emplace(Pass.getName(), Statistics.size());
+  if (Inserted.second) {
+    Statistics.emplace_back();
+    Statistics.back().Name = Pass.getName();
+    if (const char *Description = Pass.getCountDescription())
+      Statistics.back().CountDescription = Description;
+  }
+  PassStatistics &Stats = Statistics[Inserted.first->second];
+  Stats.Runs++;
+  if (Changed)
+    Stats.Changes++;
+  Stats.WallTime += End - Start;
+  for (const auto &Count : Pass.getFunctionCounts())
+    Stats.FunctionCounts[Count.first] += Count.second;
+  Stats.InstructionDelta += static_cast<long long>(InstructionsAfter) -
+                            static_cast<long long>(InstructionsBefore);
+  if (MeasureCodeSize && Changed) {
+    size_t CodeSize = IeleAssembler::assemble(Contract).size();
+    Stats.ByteDelta += static_cast<long long>(CodeSize) -
+                       static_cast<long long>(MeasuredCodeSize);
+    MeasuredCodeSize = CodeSize;
+  }
+  return Changed;
+}
+
+bool IelePassManager::runSequence(const std::string &Abbreviations,
+                                  IeleContract &Contract) {
+  bool Changed = false;
+  for (char Abbreviation : Abbreviations) {
+    std::unique_ptr<IeleContractPass> Pass =
+      allPasses().at(Abbreviation).Create(*this);
+    Changed |= run(*Pass, Contract);
+  }
+  return Changed;
+}
+
+bool IelePassManager::run(IeleContract &Contract) {
+  std::string Input;
+  for (char C : Pipeline)
+    if (C != ' ' && C != '\n')
+      Input += C;
+
+  // The pipeline has been validated and consists of segments of the form
+  // `aaa[bbb]`, where either part may be empty.
+  bool Changed = false;
+  size_t SegmentStart = 0;
+  while (SegmentStart < Input.size()) {
+    size_t OpeningBracket = Input.find('[', SegmentStart);
+    size_t ClosingBracket = Input.find(']', OpeningBracket);
+    size_t FirstInside = OpeningBracket == std::string::npos ?
+                           Input.size() : OpeningBracket + 1;
+
+    Changed |= runSequence(
+      Input.substr(SegmentStart, OpeningBracket - SegmentStart), Contract);
+    std::string Loop =
+      Input.substr(FirstInside, ClosingBracket - FirstInside);
+    for (unsigned Round = 0; Round < MaxRounds; ++Round) {
+      if (!runSequence(Loop, Contract))
+        break;
+      Changed = true;
+    }
+
+    SegmentStart = ClosingBracket == std::string::npos ?
+                     Input.size() : ClosingBracket + 1;
+  }
+  return Changed;
+}
+
+void IelePassManager::printStatistics(llvm::raw_ostream &OS) const {
+  OS << llvm::left_justify("Pass", 32) << llvm::right_justify("Runs", 7)
+     << llvm::right_justify("Changed", 9) << llvm::right_justify("Time (ms)", 13)
+     << llvm::right_justify("Instructions", 15);
+  if (MeasureCodeSize)
+    OS << llvm::right_justify("Bytes", 10);
+  OS << "\n";
+
+  std::chrono::steady_clock::duration TotalTime{0};
+  long long TotalInstructions = 0, TotalBytes = 0;
+  for (const PassStatistics &Stats : Statistics) {
+    double Milliseconds =
+      std::chrono::duration<double, std::milli>(Stats.WallTime).count();
+    OS << llvm::left_justify(Stats.Name, 32)
+       << llvm::format(" %6u %8u %12.3f %+14lld", Stats.Runs, Stats.Changes,
+                       Milliseconds, Stats.InstructionDelta);
+    if (MeasureCodeSize)
+      OS << llvm::format(" %+9lld", Stats.ByteDelta);
+    OS << "\n";
+    TotalTime += Stats.WallTime;
+    TotalInstructions += Stats.InstructionDelta;
+    TotalBytes += Stats.ByteDelta;
+  }
+
+  OS << llvm::left_justify("Total", 48)
+     << llvm::format(" %12.3f %+14lld",
+                     std::chrono::duration<double, std::milli>(TotalTime)
+                       .count(),
+                     TotalInstructions);
+  if (MeasureCodeSize)
+    OS << llvm::format(" %+9lld", TotalBytes);
+  OS << "\n";
+
+  for (const PassStatistics &Stats : Statistics) {
+    if (Stats.FunctionCounts.empty())
+      continue;
+    OS << "\n" << Stats.Name << " (" << Stats.CountDescription << "):\n";
+    for (const auto &Count : Stats.FunctionCounts)
+      OS << llvm::format("%8u  ", Count.second) << Count.first << "\n";
+  }
+}
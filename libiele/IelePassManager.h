@@ -0,0 +1,107 @@
+#pragma once
+
+#include "IelePass.h"
+
+#include <libsolutil/Exceptions.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+} // end namespace llvm
+
+namespace solidity {
+namespace iele {
+
+struct IelePipelineError : virtual util::Exception {};
+
+// Runs a pipeline of IELE passes on a contract and collects statistics about
+// each pass.
+//
+// A pipeline is described by a string of pass abbreviations, in the same
+// style as the Yul optimiser step sequences: each character names one pass,
+// whitespace is ignored, and a part of the pipeline enclosed in square
+// brackets is repeated until it no longer modifies the contract (but at most
+// MaxRounds times). Brackets cannot be nested.
+//
+class IelePassManager {
+public:
+  // Statistics collected for a pass, accumulated over all of its runs.
+  struct PassStatistics {
+    std::string Name;
+    unsigned Runs = 0;
+    unsigned Changes = 0;
+    std::chrono::steady_clock::duration WallTime{0};
+    // Instructions in the contract after the runs minus instructions before.
+    long long InstructionDelta = 0;
+    // Size of the bytecode of the contract after the runs minus size before,
+    // if code sizes are measured.
+    long long ByteDelta = 0;
+    // The counts reported by the pass per function, and what they measure.
+    std::map<std::string, unsigned> FunctionCounts;
+    std::string CountDescription;
+  };
+
+  static constexpr unsigned MaxRounds = 12;
+
+  explicit IelePassManager(std::string Pipeline);
+
+  // Throws IelePipelineError if Pipeline is not a valid pipeline description.
+  static void validatePipeline(const std::string &Pipeline);
+
+  // Returns the names of all available passes by their abbreviation.
+  static const std::map<char, std::string> &passNames();
+
+  // Runs the pipeline on Contract (but not on the contracts it creates).
+  // Returns true if the contract was modified.
+  bool run(IeleContract &Contract);
+
+  // Runs a single pass on Contract, outside of the pipeline, and records its
+  // statistics. Returns true if the contract was modified.
+  bool run(IeleContractPass &Pass, IeleContract &Contract);
+
+  // Enables measuring the change in bytecode size caused by each pass. This
+  // assembles the contract after every pass that modifies it.
+  void setMeasureCodeSize(bool Measure) { MeasureCodeSize = Measure; }
+
+  // Sets the size, in instructions, up to which FunctionInlining inlines
+  // functions at every call site.
+  void setInlineThreshold(unsigned Threshold) { InlineThreshold = Threshold; }
+
+  const std::vector<PassStatistics> &getStatistics() const {
+    return Statistics;
+  }
+
+  // Prints a table with the statistics of every pass that has been run.
+  void printStatistics(llvm::raw_ostream &OS) const;
+
+  // Returns the number of instructions in all functions of Contract.
+  static size_t countInstructions(const IeleContract &Contract);
+
+private:
+  struct PassInfo {
+    std::string Name;
+    std::function<std::unique_ptr<IeleContractPass>(const IelePassManager &)>
+      Create;
+  };
+  static const std::map<char, PassInfo> &allPasses();
+
+  std::string Pipeline;
+  bool MeasureCodeSize = false;
+  unsigned InlineThreshold = 0;
+  // The contract whose bytecode size was last measured, and that size.
+  const IeleContract *MeasuredContract = nullptr;
+  size_t MeasuredCodeSize = 0;
+  std::vector<PassStatistics> Statistics;
+  std::map<std::string, size_t> StatisticsIndex;
+
+  bool runSequence(const std::string &Abbreviations, IeleContract &Contract);
+};
+
+} // end namespace iele
+} // end namespace solidity
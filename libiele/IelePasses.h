@@ -0,0 +1,68 @@
+#pragma once
+
+#include "IelePass.h"
+
+#include <memory>
+
+namespace solidity {
+namespace iele {
+
+// Factory functions for all IELE passes. Each pass is implemented in its own
+// translation unit and registered with the IelePassManager under a
+// one-character abbreviation.
+//
+
+// Folds instructions whose operands are compile-time constants and removes
+// conditional branches on constant conditions.
+std::unique_ptr<IeleContractPass> createConstantPropagationPass();
+
+// Replaces reads of registers that are copies of other registers by reads of
+// the original registers, and removes copies that are no longer read.
+std::unique_ptr<IeleContractPass> createCopyPropagationPass();
+
+// Merges registers whose live ranges do not overlap, removing copies between
+// them, and removes unused local variables.
+std::unique_ptr<IeleContractPass> createRegisterCoalescingPass();
+
+// Removes unreachable blocks and instructions, branches to the next block,
+// instructions without side effects whose results are never read, and unused
+// local variables.
+std::unique_ptr<IeleContractPass> createDeadCodeEliminationPass();
+
+// Tracks the ranges of values of registers and removes conditional branches,
+// such as the range checks inserted by the code generator, whose outcome
+// follows from them. Reports the number of removed checks per function.
+std::unique_ptr<IeleContractPass> createRangeCheckEliminationPass();
+
+// Forwards values stored to or loaded from storage to later loads of the
+// same address, and removes stores that are redundant or overwritten before
+// they can be read. Reports the number of removed accesses per function.
+std::unique_ptr<IeleContractPass> createStorageValueNumberingPass();
+
+// Replaces instructions computing a value that is already held by a register,
+// including the hashes of repeated mapping keys, by copies of that register.
+// Reports the number of eliminated expressions per function.
+std::unique_ptr<IeleContractPass> createCommonSubexpressionEliminationPass();
+
+// Inlines the calls to internal functions with at most SizeThreshold
+// instructions, and to internal functions called only once, and removes the
+// internal functions that are no longer used. Reports the number of inlined
+// calls per calling function.
+std::unique_ptr<IeleContractPass> createFunctionInliningPass(
+  unsigned SizeThreshold);
+
+// Moves instructions computing the same value in every iteration of a loop,
+// including storage reads in loops without storage writes, to a preheader
+// block before the loop. Reports the number of hoisted instructions per
+// function.
+std::unique_ptr<IeleContractPass> createLoopInvariantCodeMotionPass();
+
+// Replaces integer constant operands of all instructions other than
+// assignments with fresh local variables assigned to the constant right
+// before the instruction. This is required to be the final pass run on a
+// contract: it improves the accuracy of the source map, because the IELE
+// assembler then never needs to desugar any operand itself.
+std::unique_ptr<IeleContractPass> createDesugarConstantOperandsPass();
+
+} // end namespace iele
+} // end namespace solidity
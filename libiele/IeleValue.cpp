@@ -37,7 +37,10 @@ static bool getSymTab(IeleValue *V, IeleValueSymbolTable *&ST) {
   return false;
 }
 
-IeleValue::~IeleValue() { }
+IeleValue::~IeleValue() {
+  if (HasName)
+    destroyIeleName();
+}
 
 IeleName *IeleValue::getIeleName() const {
   if (!HasName) return nullptr;
@@ -48,6 +48,8 @@ public:
   IeleValue(const IeleValue &) = delete;
   IeleValue &operator=(const IeleValue &) = delete;
 
+  IeleContext *getContext() const { return Context; }
+
   bool hasName() const { return HasName; }
   IeleName *getIeleName() const;
   void setIeleName(IeleName *IN);
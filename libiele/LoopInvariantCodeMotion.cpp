@@ -0,0 +1,406 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleInstruction.h"
+#include "IeleLocalVariable.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+bool isCall(const IeleInstruction &I) {
+  return I.getOpcode() >= IeleInstruction::IeleCallsBegin &&
+         I.getOpcode() < IeleInstruction::IeleCallsEnd;
+}
+
+// A natural loop: its header, the blocks with a branch back to the header,
+// and all blocks of the loop, including the header and the latches.
+struct Loop {
+  IeleBlock *Header;
+  std::set<IeleBlock *> Latches;
+  std::set<IeleBlock *> Blocks;
+};
+
+// Loop-invariant code motion on IELE functions. Loops are found as the
+// natural loops of the back edges of the control flow graph, i.e. branches to
+// a block that dominates the branch. An instruction in a loop whose operands
+// are not assigned in the loop computes the same value in every iteration,
+// such as the length of an array, the base address of a struct or an array
+// in storage, or the range check of a constant. Such an instruction is moved
+// to the preheader of the loop, a block that falls through to the header and
+// is entered once before the loop, which is created if needed. It assigns a
+// fresh register there, which is copied to the original lvalue where the
+// instruction was, since the registers of IELE functions may be assigned
+// more than once. CopyPropagation then removes the copy if possible.
+//
+// Storage reads are moved only if the loop has no storage writes and no
+// calls, and only if they are executed in every iteration, i.e. their block
+// is executed in every iteration and no conditional branch precedes them in
+// it. Memory reads and the instructions that may throw, e.g. divisions, are
+// only moved from the part of the header executed before the first
+// conditional branch, and memory reads only if the loop has no memory writes
+// and no calls.
+class LoopInvariantCodeMotion : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "LoopInvariantCodeMotion"; }
+  const char *getCountDescription() const override {
+    return "instructions hoisted";
+  }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    computeDominators(F);
+    // Hoisting from a loop changes the control flow graph and adds registers
+    // assigned in the loops containing it, which are left for the next run.
+    std::set<IeleBlock *> Modified;
+    unsigned Hoisted = 0;
+    for (Loop &L : findLoops(F)) {
+      if (std::any_of(L.Blocks.begin(), L.Blocks.end(),
+                      [&](IeleBlock *B) { return Modified.count(B); }))
+        continue;
+      if (unsigned N = hoist(F, L)) {
+        Hoisted += N;
+        Modified.insert(L.Blocks.begin(), L.Blocks.end());
+      }
+    }
+    count(F, Hoisted);
+    return Hoisted != 0;
+  }
+
+private:
+  std::map<IeleBlock *, std::vector<IeleBlock *>> Successors;
+  std::map<IeleBlock *, std::vector<IeleBlock *>> Predecessors;
+  // The reachable blocks in layout order, and the blocks dominating each.
+  std::vector<IeleBlock *> Reachable;
+  std::map<IeleBlock *, std::set<IeleBlock *>> Dominators;
+
+  bool dominates(IeleBlock *A, IeleBlock *B) const {
+    return Dominators.at(B).count(A);
+  }
+
+  // Returns true if control can reach the end of B and fall through to the
+  // next block.
+  static bool fallsThrough(const IeleBlock &B) {
+    for (const IeleInstruction &I : B.instructions())
+      if (I.isTerminator())
+        return false;
+    return true;
+  }
+
+  // Returns true if a conditional branch precedes I in its block.
+  static bool afterConditionalBranch(const IeleInstruction &I) {
+    for (const IeleInstruction &Other : I.getParent()->instructions()) {
+      if (&Other == &I)
+        return false;
+      if (Other.isConditionalBranch())
+        return true;
+    }
+    return false;
+  }
+
+  void computeSuccessors(IeleFunction &F) {
+    Successors.clear();
+    Predecessors.clear();
+    for (IeleBlock &B : F.blocks()) {
+      std::vector<IeleBlock *> &Succs = Successors[&B];
+      for (IeleInstruction &I : B.instructions()) {
+        if (I.getOpcode() == IeleInstruction::Br)
+          Succs.push_back(I.getBranchTarget());
+        if (I.isTerminator())
+          break;
+      }
+      if (fallsThrough(B) && B.getNextNode())
+        Succs.push_back(B.getNextNode());
+      for (IeleBlock *S : Succs)
+        Predecessors[S].push_back(&B);
+    }
+  }
+
+  void computeDominators(IeleFunction &F) {
+    computeSuccessors(F);
+
+    std::set<IeleBlock *> Seen{&F.front()};
+    std::vector<IeleBlock *> Worklist{&F.front()};
+    while (!Worklist.empty()) {
+      IeleBlock *B = Worklist.back();
+      Worklist.pop_back();
+      for (IeleBlock *S : Successors[B])
+        if (Seen.insert(S).second)
+          Worklist.push_back(S);
+    }
+    Reachable.clear();
+    for (IeleBlock &B : F.blocks())
+      if (Seen.count(&B))
+        Reachable.push_back(&B);
+
+    Dominators.clear();
+    for (IeleBlock *B : Reachable)
+      Dominators[B] = Seen;
+    Dominators[&F.front()] = {&F.front()};
+    bool Changed = true;
+    while (Changed) {
+      Changed = false;
+      for (IeleBlock *B : Reachable) {
+        if (B == &F.front())
+          continue;
+        std::set<IeleBlock *> Dom = Seen;
+        for (IeleBlock *P : Predecessors[B]) {
+          if (!Seen.count(P))
+            continue;
+          std::set<IeleBlock *> Meet;
+          const std::set<IeleBlock *> &PDom = Dominators[P];
+          std::set_intersection(Dom.begin(), Dom.end(), PDom.begin(),
+                                PDom.end(), std::inserter(Meet, Meet.end()));
+          Dom = std::move(Meet);
+        }
+        Dom.insert(B);
+        if (Dom != Dominators[B]) {
+          Dominators[B] = std::move(Dom);
+          Changed = true;
+        }
+      }
+    }
+  }
+
+  // Returns the natural loops of F, innermost loops first. Back edges to the
+  // same header form a single loop.
+  std::vector<Loop> findLoops(IeleFunction &F) {
+    std::map<IeleBlock *, Loop> Loops;
+    for (IeleBlock *B : Reachable)
+      for (IeleBlock *S : Successors[B])
+        if (dominates(S, B)) {
+          Loop &L = Loops.emplace(S, Loop{S, {}, {S}}).first->second;
+          L.Latches.insert(B);
+        }
+
+    std::vector<Loop> Result;
+    for (IeleBlock *B : Reachable) {
+      auto It = Loops.find(B);
+      if (It == Loops.end() || B == &F.front())
+        continue;
+      Loop &L = It->second;
+      std::vector<IeleBlock *> Worklist(L.Latches.begin(), L.Latches.end());
+      while (!Worklist.empty()) {
+        IeleBlock *Block = Worklist.back();
+        Worklist.pop_back();
+        if (Block == L.Header || !L.Blocks.insert(Block).second)
+          continue;
+        for (IeleBlock *P : Predecessors[Block])
+          if (Dominators.count(P) && !L.Blocks.count(P))
+            Worklist.push_back(P);
+      }
+      Result.push_back(std::move(L));
+    }
+    std::stable_sort(Result.begin(), Result.end(),
+                     [](const Loop &A, const Loop &B) {
+                       return A.Blocks.size() < B.Blocks.size();
+                     });
+    return Result;
+  }
+
+  // Returns the block whose end is the only entry to the loop, creating it if
+  // needed.
+  IeleBlock *getOrCreatePreheader(Loop &L) {
+    IeleBlock *Header = L.Header;
+    std::set<IeleBlock *> Outside;
+    for (IeleBlock *P : Predecessors[Header])
+      if (!L.Blocks.count(P))
+        Outside.insert(P);
+
+    // An existing block can be used if it enters the header only at its end.
+    if (Outside.size() == 1) {
+      IeleBlock *P = *Outside.begin();
+      const IeleInstruction *Terminator = nullptr;
+      unsigned Branches = 0;
+      for (IeleInstruction &I : P->instructions()) {
+        if (I.getOpcode() == IeleInstruction::Br &&
+            I.getBranchTarget() == Header)
+          Branches++;
+        if (I.isTerminator()) {
+          Terminator = &I;
+          break;
+        }
+      }
+      bool EntersAtEnd =
+        Terminator ? Branches == 1 && Terminator == &P->back() &&
+                       Terminator->getOpcode() == IeleInstruction::Br
+                   : Branches == 0 && P->getNextNode() == Header;
+      if (EntersAtEnd)
+        return P;
+    }
+
+    // Otherwise, insert a new block before the header and redirect the
+    // branches from outside the loop to it.
+    IeleBlock *Layout = Header->getPrevNode();
+    if (Layout && L.Blocks.count(Layout) && fallsThrough(*Layout)) {
+      solAssert(!Header->empty(), "Loop header without instructions");
+      IeleInstruction::CreateUncondBr(Header, Header->front().location(),
+                                      Layout);
+    }
+    IeleBlock *Preheader =
+      IeleBlock::Create(Header->getContext(), Header->getName() + ".preheader",
+                        Header->getParent(), Header);
+    for (IeleBlock *P : Outside)
+      for (IeleInstruction &I : P->instructions())
+        if (I.getOpcode() == IeleInstruction::Br &&
+            I.getBranchTarget() == Header)
+          I.getIeleOperandList().back() = Preheader;
+    return Preheader;
+  }
+
+  unsigned hoist(IeleFunction &F, Loop &L) {
+    // Registers assigned in the loop, with the number of assignments and an
+    // instruction assigning each, and the effects of the loop on memory and
+    // storage.
+    std::map<const IeleLocalVariable *, unsigned> Assignments;
+    std::map<const IeleLocalVariable *, IeleInstruction *> Definitions;
+    bool WritesMemory = false, WritesStorage = false;
+    for (IeleBlock *B : L.Blocks)
+      for (IeleInstruction &I : B->instructions()) {
+        for (const IeleLocalVariable *LV : I.lvalues()) {
+          Assignments[LV]++;
+          Definitions[LV] = &I;
+        }
+        if (isCall(I))
+          WritesMemory = WritesStorage = true;
+        else if (I.getOpcode() == IeleInstruction::Store)
+          WritesMemory = true;
+        else if (I.getOpcode() == IeleInstruction::SStore ||
+                 I.getOpcode() == IeleInstruction::Selfdestruct)
+          WritesStorage = true;
+      }
+
+    // The instructions of the header executed whenever the loop is entered.
+    // A conditional branch may skip the rest of the header, even if it
+    // branches to a block of the loop, e.g. for the conditions with && and ||.
+    std::set<const IeleInstruction *> AlwaysExecuted;
+    for (IeleInstruction &I : L.Header->instructions()) {
+      if (I.isTerminator() || I.isConditionalBranch())
+        break;
+      AlwaysExecuted.insert(&I);
+    }
+
+    IeleBlock *Preheader = nullptr;
+    unsigned Hoisted = 0;
+
+    // Returns the value V holds at I in every iteration, if it is invariant:
+    // V itself if it is not a register assigned in the loop, or the invariant
+    // value assigned to the register by the assignment that reaches I, such as
+    // a constant or the copy of a hoisted instruction.
+    auto invariantValue = [&](IeleValue *V,
+                              IeleInstruction &I) -> IeleValue * {
+      IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V);
+      if (!LV || !Assignments.count(LV))
+        return V;
+
+      IeleInstruction *Def = nullptr;
+      for (IeleInstruction &Other : I.getParent()->instructions()) {
+        if (&Other == &I)
+          break;
+        if (std::find(Other.lvalue_begin(), Other.lvalue_end(), LV) !=
+            Other.lvalue_end())
+          Def = &Other;
+      }
+      // Without an assignment before I in its block, the only assignment in
+      // the loop reaches I if it dominates I, and no conditional branch
+      // before it in its block can skip it.
+      if (!Def) {
+        Def = Definitions.at(LV);
+        if (Assignments.at(LV) != 1 || Def->getParent() == I.getParent() ||
+            !dominates(Def->getParent(), I.getParent()) ||
+            afterConditionalBranch(*Def))
+          return nullptr;
+      }
+
+      if (Def->getOpcode() != IeleInstruction::Assign)
+        return nullptr;
+      IeleValue *Value = *Def->begin();
+      IeleLocalVariable *Source = llvm::dyn_cast<IeleLocalVariable>(Value);
+      return Source && Assignments.count(Source) ? nullptr : Value;
+    };
+
+    bool Changed = true;
+    while (Changed) {
+      Changed = false;
+      for (IeleBlock *B : Reachable) {
+        if (!L.Blocks.count(B))
+          continue;
+        bool EveryIteration =
+          std::all_of(L.Latches.begin(), L.Latches.end(),
+                      [&](IeleBlock *Latch) { return dominates(B, Latch); });
+        for (auto It = B->begin(), End = B->end(); It != End;) {
+          IeleInstruction &I = *It++;
+          if (I.isTerminator())
+            break;
+          if (I.isConditionalBranch())
+            EveryIteration = false;
+          if (I.lvalue_size() != 1)
+            continue;
+
+          IeleInstruction::IeleOps Opcode = I.getOpcode();
+          bool ReadsMemory =
+            Opcode == IeleInstruction::Load || Opcode == IeleInstruction::Sha3;
+          if (Opcode == IeleInstruction::SLoad) {
+            if (WritesStorage || !EveryIteration)
+              continue;
+          } else if (ReadsMemory) {
+            if (WritesMemory)
+              continue;
+          } else if (!I.isPure())
+            continue;
+          if (I.mayHaveSideEffects() && !AlwaysExecuted.count(&I))
+            continue;
+
+          IeleInstruction::IeleOperandListType Operands;
+          for (IeleValue *V : I.operands())
+            if (IeleValue *Invariant = invariantValue(V, I))
+              Operands.push_back(Invariant);
+          if (Operands.size() != I.size())
+            continue;
+
+          if (!Preheader)
+            Preheader = getOrCreatePreheader(L);
+          IeleLocalVariable *LV = I.getIeleLValueList()[0];
+          IeleLocalVariable *Result =
+            IeleLocalVariable::Create(F.getContext(), LV->getName(), &F);
+          IeleInstruction *Copy =
+            It == End ? IeleInstruction::CreateAssign(LV, Result,
+                                                      I.location(), B)
+                      : IeleInstruction::CreateAssign(LV, Result,
+                                                      I.location(), &*It);
+          auto InsertPos = !Preheader->empty() &&
+                               Preheader->back().isTerminator()
+                             ? Preheader->back().getIterator()
+                             : Preheader->end();
+          Preheader->getIeleInstructionList().splice(
+            InsertPos, B->getIeleInstructionList(), I.getIterator());
+          I.getIeleOperandList() = Operands;
+          I.getIeleLValueList()[0] = Result;
+          if (AlwaysExecuted.erase(&I))
+            AlwaysExecuted.insert(Copy);
+          if (Definitions.at(LV) == &I)
+            Definitions[LV] = Copy;
+          Hoisted++;
+          Changed = true;
+        }
+      }
+    }
+    return Hoisted;
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createLoopInvariantCodeMotionPass() {
+  return std::make_unique<LoopInvariantCodeMotion>();
+}
@@ -0,0 +1,618 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleGlobalVariable.h"
+#include "IeleInstruction.h"
+#include "IeleIntConstant.h"
+#include "IeleLocalVariable.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// Bounds wider than this are dropped, so that computing the ranges of
+// multiplications in loops stays cheap.
+const unsigned MaxBoundBits = 4096;
+
+// Number of times the entry state of a block may grow before its bounds are
+// widened, i.e. bounds that are still moving are dropped. This guarantees
+// that the analysis of loops terminates.
+const unsigned WideningThreshold = 3;
+
+unsigned bitWidth(const bigint &V) {
+  return V == 0 ? 0 : boost::multiprecision::msb(abs(V)) + 1;
+}
+
+// The values a register may hold: all integers between Lo and Hi, where a
+// missing bound means that the range is unbounded in that direction.
+struct Range {
+  std::optional<bigint> Lo, Hi;
+
+  static Range constant(const bigint &V) { return Range{V, V}; }
+  static Range nonNegative() { return Range{bigint(0), std::nullopt}; }
+  static Range unsignedBytes(unsigned NBytes) {
+    return Range{bigint(0), (bigint(1) << (8 * NBytes)) - 1};
+  }
+
+  bool isFull() const { return !Lo && !Hi; }
+  bool isEmpty() const { return Lo && Hi && *Lo > *Hi; }
+  bool isNonNegative() const { return Lo && *Lo >= 0; }
+  bool contains(const Range &R) const {
+    return (!Lo || (R.Lo && *R.Lo >= *Lo)) && (!Hi || (R.Hi && *R.Hi <= *Hi));
+  }
+  std::optional<bigint> getConstant() const {
+    if (Lo && Hi && *Lo == *Hi)
+      return *Lo;
+    return std::nullopt;
+  }
+
+  bool operator==(const Range &R) const { return Lo == R.Lo && Hi == R.Hi; }
+  bool operator!=(const Range &R) const { return !(*this == R); }
+};
+
+std::optional<bigint> limit(std::optional<bigint> Bound) {
+  if (Bound && bitWidth(*Bound) > MaxBoundBits)
+    return std::nullopt;
+  return Bound;
+}
+
+Range intersect(const Range &A, const Range &B) {
+  Range Result = A;
+  if (B.Lo && (!Result.Lo || *B.Lo > *Result.Lo))
+    Result.Lo = B.Lo;
+  if (B.Hi && (!Result.Hi || *B.Hi < *Result.Hi))
+    Result.Hi = B.Hi;
+  return Result;
+}
+
+// Returns the smallest range containing both A and B.
+Range hull(const Range &A, const Range &B) {
+  Range Result;
+  if (A.Lo && B.Lo)
+    Result.Lo = std::min(*A.Lo, *B.Lo);
+  if (A.Hi && B.Hi)
+    Result.Hi = std::max(*A.Hi, *B.Hi);
+  return Result;
+}
+
+// The known ranges of local variables at some program point. A variable that
+// is not in the map may have any value.
+using RangeMap = std::map<const IeleLocalVariable *, Range>;
+
+Range rangeOf(const IeleValue *V, const RangeMap &State) {
+  if (const IeleIntConstant *IC = llvm::dyn_cast<IeleIntConstant>(V))
+    return Range::constant(IC->getValue());
+  if (const IeleGlobalVariable *GV = llvm::dyn_cast<IeleGlobalVariable>(V))
+    if (GV->getStorageAddress())
+      return Range::constant(GV->getStorageAddress()->getValue());
+  if (const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V)) {
+    auto It = State.find(LV);
+    if (It != State.end())
+      return It->second;
+  }
+  return Range();
+}
+
+void setRange(RangeMap &State, const IeleLocalVariable *LV, const Range &R) {
+  if (R.isFull())
+    State.erase(LV);
+  else
+    State[LV] = R;
+}
+
+// Returns 1 or 0 if the comparison of values in the ranges A and B always or
+// never holds.
+std::optional<bool> compare(IeleInstruction::IeleOps Opcode, const Range &A,
+                            const Range &B) {
+  auto Less = [](const Range &X, const Range &Y) -> std::optional<bool> {
+    if (X.Hi && Y.Lo && *X.Hi < *Y.Lo)
+      return true;
+    if (X.Lo && Y.Hi && *X.Lo >= *Y.Hi)
+      return false;
+    return std::nullopt;
+  };
+  auto Negate = [](std::optional<bool> V) -> std::optional<bool> {
+    if (V)
+      return !*V;
+    return std::nullopt;
+  };
+  switch (Opcode) {
+  case IeleInstruction::CmpLt: return Less(A, B);
+  case IeleInstruction::CmpGt: return Less(B, A);
+  case IeleInstruction::CmpGe: return Negate(Less(A, B));
+  case IeleInstruction::CmpLe: return Negate(Less(B, A));
+  case IeleInstruction::CmpEq:
+  case IeleInstruction::CmpNe: {
+    std::optional<bool> Equal;
+    if (intersect(A, B).isEmpty())
+      Equal = false;
+    else if (A.getConstant() && A == B)
+      Equal = true;
+    return Opcode == IeleInstruction::CmpEq ? Equal : Negate(Equal);
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+Range booleanRange(std::optional<bool> V) {
+  if (V)
+    return Range::constant(*V ? 1 : 0);
+  return Range{bigint(0), bigint(1)};
+}
+
+// Computes the range of the result of I from the ranges of its operands.
+Range evaluate(const IeleInstruction &I, const RangeMap &State) {
+  if (I.getOpcode() >= IeleInstruction::IeleIntrinsicsBegin &&
+      I.getOpcode() < IeleInstruction::IeleIntrinsicsEnd) {
+    switch (I.getOpcode()) {
+    case IeleInstruction::Address:
+    case IeleInstruction::Origin:
+    case IeleInstruction::Caller:
+    case IeleInstruction::Beneficiary:
+      return Range::unsignedBytes(20);
+    default:
+      return Range::nonNegative();
+    }
+  }
+
+  std::vector<Range> Ops;
+  for (const IeleValue *V : I.operands())
+    Ops.push_back(rangeOf(V, State));
+  auto Both = [](const std::optional<bigint> &X,
+                 const std::optional<bigint> &Y) { return X && Y; };
+
+  switch (I.getOpcode()) {
+  case IeleInstruction::Assign:
+    return Ops[0];
+  case IeleInstruction::IsZero:
+    return booleanRange(
+      compare(IeleInstruction::CmpEq, Ops[0], Range::constant(0)));
+  case IeleInstruction::CmpLt:
+  case IeleInstruction::CmpLe:
+  case IeleInstruction::CmpGt:
+  case IeleInstruction::CmpGe:
+  case IeleInstruction::CmpEq:
+  case IeleInstruction::CmpNe:
+    return booleanRange(compare(I.getOpcode(), Ops[0], Ops[1]));
+  case IeleInstruction::Not: {
+    Range Result;
+    if (Ops[0].Hi)
+      Result.Lo = -*Ops[0].Hi - 1;
+    if (Ops[0].Lo)
+      Result.Hi = -*Ops[0].Lo - 1;
+    return Result;
+  }
+  case IeleInstruction::Add: {
+    Range Result;
+    if (Both(Ops[0].Lo, Ops[1].Lo))
+      Result.Lo = limit(*Ops[0].Lo + *Ops[1].Lo);
+    if (Both(Ops[0].Hi, Ops[1].Hi))
+      Result.Hi = limit(*Ops[0].Hi + *Ops[1].Hi);
+    return Result;
+  }
+  case IeleInstruction::Sub: {
+    Range Result;
+    if (Both(Ops[0].Lo, Ops[1].Hi))
+      Result.Lo = limit(*Ops[0].Lo - *Ops[1].Hi);
+    if (Both(Ops[0].Hi, Ops[1].Lo))
+      Result.Hi = limit(*Ops[0].Hi - *Ops[1].Lo);
+    return Result;
+  }
+  case IeleInstruction::Mul: {
+    const Range &A = Ops[0], &B = Ops[1];
+    if (A.Lo && A.Hi && B.Lo && B.Hi) {
+      bigint Corners[] = {*A.Lo * *B.Lo, *A.Lo * *B.Hi, *A.Hi * *B.Lo,
+                          *A.Hi * *B.Hi};
+      return Range{limit(*std::min_element(Corners, Corners + 4)),
+                   limit(*std::max_element(Corners, Corners + 4))};
+    }
+    if (A.isNonNegative() && B.isNonNegative())
+      return Range{*A.Lo * *B.Lo, std::nullopt};
+    return Range();
+  }
+  case IeleInstruction::Div: {
+    const Range &A = Ops[0], &B = Ops[1];
+    if (!A.isNonNegative() || !B.Lo || *B.Lo <= 0)
+      return Range();
+    Range Result = Range::nonNegative();
+    if (B.Hi)
+      Result.Lo = bigint(*A.Lo / *B.Hi);
+    if (A.Hi)
+      Result.Hi = bigint(*A.Hi / *B.Lo);
+    return Result;
+  }
+  case IeleInstruction::Mod: {
+    const Range &A = Ops[0], &B = Ops[1];
+    if (!A.isNonNegative() || !B.Lo || *B.Lo <= 0)
+      return Range();
+    Range Result = Range::nonNegative();
+    Result.Hi = A.Hi;
+    if (B.Hi && (!Result.Hi || *B.Hi - 1 < *Result.Hi))
+      Result.Hi = *B.Hi - 1;
+    return Result;
+  }
+  case IeleInstruction::Log2:
+  case IeleInstruction::Exp:
+    // The result of log2 is non-negative whenever it does not throw, and so
+    // is a non-negative power of a non-negative base.
+    if (I.getOpcode() == IeleInstruction::Log2 ||
+        (Ops[0].isNonNegative() && Ops[1].isNonNegative()))
+      return Range::nonNegative();
+    return Range();
+  case IeleInstruction::AddMod:
+  case IeleInstruction::MulMod:
+  case IeleInstruction::ExpMod: {
+    const Range &M = Ops.back();
+    if (M.Lo && *M.Lo > 0 && Ops[0].isNonNegative() &&
+        Ops[1].isNonNegative())
+      return Range{bigint(0), M.Hi ? std::optional<bigint>(*M.Hi - 1)
+                                   : std::nullopt};
+    return Range();
+  }
+  case IeleInstruction::Byte:
+    return Range::unsignedBytes(1);
+  case IeleInstruction::Sha3:
+    return Range::unsignedBytes(32);
+  case IeleInstruction::Twos:
+  case IeleInstruction::SExt: {
+    std::optional<bigint> NBytes = Ops[0].getConstant();
+    if (!NBytes || *NBytes <= 0 || *NBytes * 8 > MaxBoundBits)
+      return I.getOpcode() == IeleInstruction::Twos ? Range::nonNegative()
+                                                     : Range();
+    Range Result = Range::unsignedBytes(unsigned(*NBytes));
+    if (I.getOpcode() == IeleInstruction::SExt) {
+      bigint Half = bigint(1) << (8 * unsigned(*NBytes) - 1);
+      Result = Range{-Half, Half - 1};
+    }
+    // Values that already fit are left unchanged.
+    if (Result.contains(Ops[1]))
+      return Ops[1];
+    return Result;
+  }
+  case IeleInstruction::And: {
+    // The result has a subset of the bits of each non-negative operand.
+    Range Result;
+    for (const Range &Op : Ops)
+      if (Op.isNonNegative())
+        Result = intersect(Result, Range{bigint(0), Op.Hi});
+    return Result;
+  }
+  case IeleInstruction::Or:
+  case IeleInstruction::Xor: {
+    const Range &A = Ops[0], &B = Ops[1];
+    if (!A.isNonNegative() || !B.isNonNegative())
+      return Range();
+    if (!A.Hi || !B.Hi)
+      return Range::nonNegative();
+    unsigned Bits = std::max(bitWidth(*A.Hi), bitWidth(*B.Hi));
+    return Range{bigint(0), (bigint(1) << Bits) - 1};
+  }
+  case IeleInstruction::Shift: {
+    const Range &A = Ops[0];
+    std::optional<bigint> Amount = Ops[1].getConstant();
+    if (!Amount || !A.isNonNegative() || abs(*Amount) > MaxBoundBits)
+      return Range();
+    Range Result;
+    if (*Amount >= 0) {
+      Result.Lo = limit(bigint(*A.Lo << unsigned(*Amount)));
+      if (A.Hi)
+        Result.Hi = limit(bigint(*A.Hi << unsigned(*Amount)));
+    } else {
+      Result.Lo = bigint(*A.Lo >> unsigned(-*Amount));
+      if (A.Hi)
+        Result.Hi = bigint(*A.Hi >> unsigned(-*Amount));
+    }
+    return Result;
+  }
+  default:
+    return Range();
+  }
+}
+
+// A comparison known to have produced the value of a register, as in
+// `%c = cmp lt %x, %y`, possibly negated by `iszero`.
+struct Condition {
+  IeleInstruction::IeleOps Opcode;
+  const IeleValue *LHS, *RHS;
+};
+
+using ConditionMap = std::map<const IeleLocalVariable *, Condition>;
+
+IeleInstruction::IeleOps negate(IeleInstruction::IeleOps Opcode) {
+  switch (Opcode) {
+  case IeleInstruction::CmpLt: return IeleInstruction::CmpGe;
+  case IeleInstruction::CmpLe: return IeleInstruction::CmpGt;
+  case IeleInstruction::CmpGt: return IeleInstruction::CmpLe;
+  case IeleInstruction::CmpGe: return IeleInstruction::CmpLt;
+  case IeleInstruction::CmpEq: return IeleInstruction::CmpNe;
+  default:                     return IeleInstruction::CmpEq;
+  }
+}
+
+IeleInstruction::IeleOps swapOperands(IeleInstruction::IeleOps Opcode) {
+  switch (Opcode) {
+  case IeleInstruction::CmpLt: return IeleInstruction::CmpGt;
+  case IeleInstruction::CmpLe: return IeleInstruction::CmpGe;
+  case IeleInstruction::CmpGt: return IeleInstruction::CmpLt;
+  case IeleInstruction::CmpGe: return IeleInstruction::CmpLe;
+  default:                     return Opcode;
+  }
+}
+
+// Narrows the range of X in State, assuming that `X Opcode Y` holds and that
+// Y is in the range RHS. Returns false if the assumption cannot hold.
+bool refine(RangeMap &State, const IeleValue *X, IeleInstruction::IeleOps Opcode,
+            const Range &RHS) {
+  Range Old = rangeOf(X, State), New = Old;
+  switch (Opcode) {
+  case IeleInstruction::CmpLt:
+    if (RHS.Hi)
+      New = intersect(Old, Range{std::nullopt, *RHS.Hi - 1});
+    break;
+  case IeleInstruction::CmpLe:
+    New = intersect(Old, Range{std::nullopt, RHS.Hi});
+    break;
+  case IeleInstruction::CmpGt:
+    if (RHS.Lo)
+      New = intersect(Old, Range{*RHS.Lo + 1, std::nullopt});
+    break;
+  case IeleInstruction::CmpGe:
+    New = intersect(Old, Range{RHS.Lo, std::nullopt});
+    break;
+  case IeleInstruction::CmpEq:
+    New = intersect(Old, RHS);
+    break;
+  case IeleInstruction::CmpNe:
+    if (std::optional<bigint> C = RHS.getConstant()) {
+      if (New.Lo && *New.Lo == *C)
+        New.Lo = *C + 1;
+      if (New.Hi && *New.Hi == *C)
+        New.Hi = *C - 1;
+    }
+    break;
+  default:
+    break;
+  }
+  if (New.isEmpty())
+    return false;
+  if (const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(X))
+    setRange(State, LV, New);
+  return true;
+}
+
+// Narrows State assuming that `LHS Opcode RHS` holds. Returns false if it
+// cannot hold.
+bool assume(RangeMap &State, const Condition &C) {
+  Range L = rangeOf(C.LHS, State), R = rangeOf(C.RHS, State);
+  return refine(State, C.LHS, C.Opcode, R) &&
+         refine(State, C.RHS, swapOperands(C.Opcode), L);
+}
+
+// Value-range analysis on IELE functions, used to remove the range checks
+// that the code generator emits around conversions, assignments, array
+// accesses and unsigned subtractions when they can never fail.
+//
+// The analysis tracks an interval for every local variable at the entry of
+// each block. Along the edges of a conditional branch it also narrows the
+// intervals of the registers compared to compute the condition, so that
+// e.g. a loop counter that starts at zero and is only incremented is known
+// to be non-negative, and `x - 1` cannot underflow after a check of `x > 0`.
+// Conditional branches whose condition is then known are made unconditional
+// or removed; the comparisons feeding them are left for dead code
+// elimination. Relations between different registers, such as an index being
+// smaller than a length loaded from memory, are not tracked.
+class RangeCheckElimination : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "RangeCheckElimination"; }
+  const char *getCountDescription() const override {
+    return "checks removed";
+  }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    EntryStates.clear();
+    Updates.clear();
+    Worklist.clear();
+    EntryStates.emplace(&F.front(), RangeMap());
+    Worklist.push_back(&F.front());
+    while (!Worklist.empty()) {
+      IeleBlock *B = Worklist.back();
+      Worklist.pop_back();
+      analyze(*B);
+    }
+
+    unsigned Removed = 0;
+    for (auto &Entry : EntryStates)
+      Removed += rewrite(*Entry.first, Entry.second);
+    count(F, Removed);
+    return Removed != 0;
+  }
+
+private:
+  std::map<IeleBlock *, RangeMap> EntryStates;
+  std::map<IeleBlock *, unsigned> Updates;
+  std::vector<IeleBlock *> Worklist;
+
+  // Merges State into the entry state of B, scheduling B for analysis if its
+  // entry state changed.
+  void propagate(IeleBlock *B, const RangeMap &State) {
+    auto Inserted = EntryStates.emplace(B, State);
+    bool Changed = Inserted.second;
+    if (!Changed) {
+      bool Widen = Updates[B] >= WideningThreshold;
+      RangeMap &Entry = Inserted.first->second;
+      for (auto It = Entry.begin(); It != Entry.end();) {
+        auto Other = State.find(It->first);
+        Range Merged = Other == State.end() ? Range()
+                                            : hull(It->second, Other->second);
+        if (Widen) {
+          if (Merged.Lo != It->second.Lo)
+            Merged.Lo.reset();
+          if (Merged.Hi != It->second.Hi)
+            Merged.Hi.reset();
+        }
+        if (Merged == It->second) {
+          ++It;
+          continue;
+        }
+        Changed = true;
+        if (Merged.isFull())
+          It = Entry.erase(It);
+        else
+          (It++)->second = Merged;
+      }
+    }
+    if (!Changed)
+      return;
+    Updates[B]++;
+    if (std::find(Worklist.begin(), Worklist.end(), B) == Worklist.end())
+      Worklist.push_back(B);
+  }
+
+  // Updates State and Conditions with the effect of I.
+  static void transfer(const IeleInstruction &I, RangeMap &State,
+                       ConditionMap &Conditions) {
+    Range Result = I.lvalue_size() == 1 ? evaluate(I, State) : Range();
+
+    std::optional<Condition> Cond;
+    IeleInstruction::IeleOps Opcode = I.getOpcode();
+    if (Opcode >= IeleInstruction::CmpLt && Opcode <= IeleInstruction::CmpNe)
+      Cond = Condition{Opcode, *I.begin(), *(I.begin() + 1)};
+    else if (Opcode == IeleInstruction::IsZero) {
+      const IeleValue *Operand = *I.begin();
+      auto It = Conditions.end();
+      if (const IeleLocalVariable *LV =
+            llvm::dyn_cast<IeleLocalVariable>(Operand))
+        It = Conditions.find(LV);
+      if (It != Conditions.end())
+        Cond = Condition{negate(It->second.Opcode), It->second.LHS,
+                         It->second.RHS};
+      else
+        Cond = Condition{IeleInstruction::CmpEq, Operand,
+                         IeleIntConstant::getZero(I.getParent()->getContext())};
+    }
+
+    for (const IeleLocalVariable *LV : I.lvalues()) {
+      State.erase(LV);
+      for (auto It = Conditions.begin(); It != Conditions.end();) {
+        if (It->first == LV || It->second.LHS == LV || It->second.RHS == LV)
+          It = Conditions.erase(It);
+        else
+          ++It;
+      }
+      // A condition on the previous value of a register cannot be recorded.
+      if (Cond && (Cond->LHS == LV || Cond->RHS == LV))
+        Cond.reset();
+    }
+
+    if (I.lvalue_size() != 1)
+      return;
+    const IeleLocalVariable *LV = I.getIeleLValueList().front();
+    setRange(State, LV, Result);
+    if (Cond)
+      Conditions[LV] = *Cond;
+  }
+
+  // Computes the states on the taken and the fall-through edge of the
+  // conditional branch I, or nothing for an edge that cannot be taken.
+  static std::pair<std::optional<RangeMap>, std::optional<RangeMap>>
+  branch(const IeleInstruction &I, const RangeMap &State,
+         const ConditionMap &Conditions) {
+    const IeleValue *Value = *I.begin();
+    Condition IsTrue{IeleInstruction::CmpNe, Value,
+                     IeleIntConstant::getZero(I.getParent()->getContext())};
+    std::optional<Condition> Compared;
+    if (const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(Value)) {
+      auto It = Conditions.find(LV);
+      if (It != Conditions.end())
+        Compared = It->second;
+    }
+
+    std::optional<RangeMap> Taken = State, FallThrough = State;
+    if (!assume(*Taken, IsTrue) ||
+        (Compared && !assume(*Taken, *Compared)))
+      Taken.reset();
+    Condition IsFalse = IsTrue;
+    IsFalse.Opcode = IeleInstruction::CmpEq;
+    if (!assume(*FallThrough, IsFalse) ||
+        (Compared && !assume(*FallThrough,
+                             Condition{negate(Compared->Opcode),
+                                       Compared->LHS, Compared->RHS})))
+      FallThrough.reset();
+    return {Taken, FallThrough};
+  }
+
+  void analyze(IeleBlock &B) {
+    RangeMap State = EntryStates.at(&B);
+    ConditionMap Conditions;
+    for (IeleInstruction &I : B.instructions()) {
+      if (I.isConditionalBranch()) {
+        auto Edges = branch(I, State, Conditions);
+        if (Edges.first)
+          propagate(I.getBranchTarget(), *Edges.first);
+        if (!Edges.second)
+          return;
+        State = *Edges.second;
+        continue;
+      }
+      if (I.getOpcode() == IeleInstruction::Br)
+        propagate(I.getBranchTarget(), State);
+      if (I.isTerminator())
+        return;
+      transfer(I, State, Conditions);
+    }
+    if (IeleBlock *Next = B.getNextNode())
+      propagate(Next, State);
+  }
+
+  // Removes the conditional branches of B whose outcome is known, and returns
+  // their number.
+  unsigned rewrite(IeleBlock &B, RangeMap State) {
+    ConditionMap Conditions;
+    unsigned Removed = 0;
+    for (auto It = B.begin(), End = B.end(); It != End;) {
+      IeleInstruction &I = *It++;
+      if (I.isConditionalBranch()) {
+        auto Edges = branch(I, State, Conditions);
+        // Both edges are infeasible only in code that is never executed.
+        if (!Edges.first && !Edges.second)
+          break;
+        if (Edges.first && Edges.second) {
+          State = *Edges.second;
+          continue;
+        }
+        Removed++;
+        if (!Edges.second) {
+          IeleInstruction::CreateUncondBr(I.getBranchTarget(), I.location(),
+                                          &I);
+          I.eraseFromParent();
+          break;
+        }
+        I.eraseFromParent();
+        State = *Edges.second;
+        continue;
+      }
+      if (I.isTerminator())
+        break;
+      transfer(I, State, Conditions);
+    }
+    return Removed;
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createRangeCheckEliminationPass() {
+  return std::make_unique<RangeCheckElimination>();
+}
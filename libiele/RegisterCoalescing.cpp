@@ -0,0 +1,178 @@
+#include "IelePasses.h"
+
+#include "IeleArgument.h"
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleInstruction.h"
+#include "IeleLiveness.h"
+#include "IeleLocalVariable.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// Register coalescing on IELE functions. Two registers interfere if one of
+// them is assigned while the other is live, unless the assignment copies the
+// other register. Registers that do not interfere can share a single register:
+// first the two sides of each copy are merged when possible, which turns the
+// copy into a self-assignment that is then removed, and then the remaining
+// local variables are greedily packed into as few registers as possible.
+// Local variables that are no longer used are removed from the function, so
+// that the VM allocates fewer registers per call.
+//
+// Arguments are never merged with each other, and a local variable merged
+// with an argument is renamed to the argument.
+class RegisterCoalescing : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "RegisterCoalescing"; }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    Interference.clear();
+    Leader.clear();
+    buildInterference(F);
+
+    // Merge the two sides of copies.
+    bool Merged = false;
+    for (IeleBlock &B : F.blocks())
+      for (IeleInstruction &I : B.instructions())
+        if (I.getOpcode() == IeleInstruction::Assign)
+          if (IeleLocalVariable *Source =
+                llvm::dyn_cast<IeleLocalVariable>(*I.begin()))
+            Merged |= merge(I.getIeleLValueList().front(), Source);
+
+    // Pack the remaining local variables into as few registers as possible,
+    // reusing arguments first.
+    std::vector<IeleLocalVariable *> Registers;
+    for (IeleArgument &A : F.args())
+      Registers.push_back(&A);
+    for (IeleLocalVariable &LV : F.lvars()) {
+      IeleLocalVariable *Root = find(&LV);
+      if (Root != &LV)
+        continue;
+      bool Packed = false;
+      for (IeleLocalVariable *R : Registers)
+        if ((Packed = merge(R, Root)))
+          break;
+      if (Packed)
+        Merged = true;
+      else
+        Registers.push_back(Root);
+    }
+
+    bool Changed = Merged && rename(F);
+    Changed |= F.removeUnusedLocalVariables();
+    return Changed;
+  }
+
+private:
+  std::map<IeleLocalVariable *, std::set<IeleLocalVariable *>> Interference;
+  // Maps each merged register to the register it was merged into.
+  std::map<IeleLocalVariable *, IeleLocalVariable *> Leader;
+
+  void addInterference(const IeleLocalVariable *A, const IeleLocalVariable *B) {
+    if (A == B)
+      return;
+    IeleLocalVariable *LA = const_cast<IeleLocalVariable *>(A);
+    IeleLocalVariable *LB = const_cast<IeleLocalVariable *>(B);
+    Interference[LA].insert(LB);
+    Interference[LB].insert(LA);
+  }
+
+  void buildInterference(const IeleFunction &F) {
+    IeleLiveness Liveness(F);
+    for (const IeleBlock &B : F.blocks())
+      Liveness.forEachInstruction(
+        B, [&](const IeleInstruction &I,
+               const IeleLiveness::RegisterSet &LiveOut) {
+          const IeleLocalVariable *Copied = nullptr;
+          if (I.getOpcode() == IeleInstruction::Assign)
+            Copied = IeleLiveness::asRegister(*I.begin());
+          for (const IeleLocalVariable *Def : I.lvalues()) {
+            for (const IeleLocalVariable *Live : LiveOut)
+              if (Live != Copied)
+                addInterference(Def, Live);
+            for (const IeleLocalVariable *Other : I.lvalues())
+              addInterference(Def, Other);
+          }
+        });
+
+    // Arguments are assigned on entry to the function.
+    const IeleLiveness::RegisterSet &LiveIn = Liveness.getLiveIn(F.front());
+    for (const IeleArgument &A : F.args()) {
+      for (const IeleLocalVariable *Live : LiveIn)
+        addInterference(&A, Live);
+      for (const IeleArgument &Other : F.args())
+        addInterference(&A, &Other);
+    }
+  }
+
+  IeleLocalVariable *find(IeleLocalVariable *V) {
+    auto It = Leader.find(V);
+    if (It == Leader.end())
+      return V;
+    IeleLocalVariable *Root = find(It->second);
+    It->second = Root;
+    return Root;
+  }
+
+  // Merges the registers of A and B if they do not interfere, preferring to
+  // keep A. Returns true if they were merged.
+  bool merge(IeleLocalVariable *A, IeleLocalVariable *B) {
+    IeleLocalVariable *Keep = find(A), *Drop = find(B);
+    if (Keep == Drop)
+      return false;
+    bool KeepIsArgument = llvm::isa<IeleArgument>(Keep);
+    bool DropIsArgument = llvm::isa<IeleArgument>(Drop);
+    if (KeepIsArgument && DropIsArgument)
+      return false;
+    if (Interference[Keep].count(Drop))
+      return false;
+    if (DropIsArgument)
+      std::swap(Keep, Drop);
+
+    std::set<IeleLocalVariable *> &KeepNeighbors = Interference[Keep];
+    for (IeleLocalVariable *N : Interference[Drop]) {
+      KeepNeighbors.insert(N);
+      std::set<IeleLocalVariable *> &Neighbors = Interference[N];
+      Neighbors.erase(Drop);
+      Neighbors.insert(Keep);
+    }
+    Interference.erase(Drop);
+    Leader[Drop] = Keep;
+    return true;
+  }
+
+  // Replaces every register by the register it was merged into and removes
+  // the resulting self-assignments.
+  bool rename(IeleFunction &F) {
+    for (IeleBlock &B : F.blocks()) {
+      for (auto It = B.begin(), End = B.end(); It != End;) {
+        IeleInstruction &I = *It++;
+        for (IeleValue *&V : I.getIeleOperandList())
+          if (IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V))
+            V = find(LV);
+        for (IeleLocalVariable *&LV : I.getIeleLValueList())
+          LV = find(LV);
+        if (I.getOpcode() == IeleInstruction::Assign &&
+            *I.begin() == I.getIeleLValueList().front())
+          I.eraseFromParent();
+      }
+    }
+    return true;
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createRegisterCoalescingPass() {
+  return std::make_unique<RegisterCoalescing>();
+}
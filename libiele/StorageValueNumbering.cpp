@@ -0,0 +1,371 @@
+#include "IelePasses.h"
+
+#include "IeleBlock.h"
+#include "IeleFunction.h"
+#include "IeleGlobalVariable.h"
+#include "IeleInstruction.h"
+#include "IeleIntConstant.h"
+#include "IeleLocalVariable.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <vector>
+
+using namespace solidity;
+using namespace solidity::iele;
+
+namespace {
+
+// Returns true if the block only assigns registers and then throws, so that
+// the effects of any storage writes performed before entering it are undone.
+bool alwaysReverts(const IeleBlock &B) {
+  for (const IeleInstruction &I : B.instructions()) {
+    if (I.getOpcode() == IeleInstruction::Assign)
+      continue;
+    return I.getOpcode() == IeleInstruction::Revert ||
+           I.getOpcode() == IeleInstruction::Invalid;
+  }
+  return false;
+}
+
+// Storage value numbering on IELE blocks. Every value computed in a block is
+// given a value number, such that registers with equal value numbers are
+// known to hold equal values; in particular, storage addresses computed twice
+// from the same operands, as in `balance[x] += a; balance[x] -= fee;`, get
+// the same value number. The analysis then tracks the value last loaded from
+// or stored to each storage address, and
+//   - replaces an `sload` of an address whose value is known by a copy of a
+//     register holding that value,
+//   - removes an `sstore` of the value the address is known to hold, and
+//   - removes an `sstore` that is overwritten by a later `sstore` to the same
+//     address before the storage can be read.
+//
+// Calls may read and write any storage address, and a store is only known to
+// leave another address unchanged if both addresses are the same value plus
+// different constant offsets. Conditional branches may leave the block, so
+// they end the range over which an overwritten store can be removed, unless
+// their target reverts.
+//
+// Value numbers are local to a block. The values known to be held by storage
+// addresses are carried across blocks as facts relating the registers or
+// constants that hold the address and the value at the end of a predecessor,
+// and are intersected where control flow joins, in the same way as the
+// available expressions of CommonSubexpressionElimination. Overwritten stores
+// are only removed within a block.
+class StorageValueNumbering : public IeleFunctionPass {
+public:
+  const char *getName() const override { return "StorageValueNumbering"; }
+  const char *getCountDescription() const override {
+    return "storage accesses removed";
+  }
+
+  bool runOnFunction(IeleFunction &F) override {
+    if (F.empty())
+      return false;
+
+    EntryFacts.clear();
+    Worklist.clear();
+    EntryFacts.emplace(&F.front(), StorageFacts());
+    Worklist.push_back(&F.front());
+    while (!Worklist.empty()) {
+      IeleBlock *B = Worklist.back();
+      Worklist.pop_back();
+      runOnBlock(*B, /*Rewrite=*/false);
+    }
+
+    unsigned Removed = 0;
+    for (IeleBlock &B : F.blocks())
+      Removed += runOnBlock(B, /*Rewrite=*/true);
+    count(F, Removed);
+    return Removed != 0;
+  }
+
+private:
+  // The values held by storage addresses at some program point, by the
+  // address. Both are given by values that hold them at that point.
+  using StorageFacts = std::map<IeleValue *, IeleValue *>;
+
+  std::map<IeleBlock *, StorageFacts> EntryFacts;
+  std::vector<IeleBlock *> Worklist;
+
+  // A storage address in the form Base + Offset, where Base is a value number
+  // or NoBase for constant addresses.
+  struct Address {
+    unsigned Base;
+    bigint Offset;
+  };
+  static constexpr unsigned NoBase = 0;
+
+  unsigned NextValueNumber;
+  std::map<const IeleLocalVariable *, unsigned> RegisterNumbers;
+  std::map<bigint, unsigned> ConstantNumbers;
+  std::map<const IeleValue *, unsigned> OtherNumbers;
+  std::map<std::vector<unsigned>, unsigned> ExpressionNumbers;
+  // A value known to hold each value number, if any.
+  std::map<unsigned, IeleValue *> Holders;
+  std::map<unsigned, Address> Addresses;
+  // The value numbers of the values held by storage addresses, by the value
+  // number of the address.
+  std::map<unsigned, unsigned> Storage;
+  // The stores whose value has not been read since, by the value number of
+  // their address.
+  std::map<unsigned, IeleInstruction *> PendingStores;
+
+  unsigned freshNumber() { return NextValueNumber++; }
+
+  unsigned numberOf(IeleValue *V) {
+    std::optional<bigint> Constant;
+    if (IeleIntConstant *IC = llvm::dyn_cast<IeleIntConstant>(V))
+      Constant = IC->getValue();
+    else if (IeleGlobalVariable *GV = llvm::dyn_cast<IeleGlobalVariable>(V))
+      if (GV->getStorageAddress())
+        Constant = GV->getStorageAddress()->getValue();
+
+    if (Constant) {
+      auto Inserted = ConstantNumbers.emplace(*Constant, NextValueNumber);
+      if (Inserted.second) {
+        unsigned N = freshNumber();
+        Holders[N] = V;
+        Addresses[N] = Address{NoBase, *Constant};
+      }
+      return Inserted.first->second;
+    }
+
+    if (IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V)) {
+      // Registers read before being assigned in the block hold their value at
+      // the entry of the block.
+      auto Inserted = RegisterNumbers.emplace(LV, NextValueNumber);
+      if (Inserted.second)
+        Holders[freshNumber()] = LV;
+      return Inserted.first->second;
+    }
+
+    auto Inserted = OtherNumbers.emplace(V, NextValueNumber);
+    if (Inserted.second)
+      Holders[freshNumber()] = V;
+    return Inserted.first->second;
+  }
+
+  bool holds(const IeleValue *V, unsigned N) const {
+    const IeleLocalVariable *LV = llvm::dyn_cast<IeleLocalVariable>(V);
+    return !LV || RegisterNumbers.at(LV) == N;
+  }
+
+  // Returns a value known to hold the value number N, if there is one.
+  IeleValue *holderOf(unsigned N) const {
+    auto It = Holders.find(N);
+    if (It != Holders.end() && holds(It->second, N))
+      return It->second;
+    for (const auto &Entry : RegisterNumbers)
+      if (Entry.second == N)
+        return const_cast<IeleLocalVariable *>(Entry.first);
+    return nullptr;
+  }
+
+  Address addressOf(unsigned N) const {
+    auto It = Addresses.find(N);
+    if (It != Addresses.end())
+      return It->second;
+    return Address{N, 0};
+  }
+
+  bool mayAlias(unsigned A, unsigned B) const {
+    if (A == B)
+      return true;
+    Address AddrA = addressOf(A), AddrB = addressOf(B);
+    return AddrA.Base != AddrB.Base || AddrA.Offset == AddrB.Offset;
+  }
+
+  void define(IeleLocalVariable *LV, unsigned N) {
+    RegisterNumbers[LV] = N;
+    auto It = Holders.find(N);
+    if (It == Holders.end() || !holds(It->second, N))
+      Holders[N] = LV;
+  }
+
+  // Assigns a value number to the result of the pure instruction I.
+  void numberExpression(IeleInstruction &I) {
+    std::vector<unsigned> Key{unsigned(I.getOpcode())};
+    for (IeleValue *V : I.operands())
+      Key.push_back(numberOf(V));
+    if (I.isCommutative())
+      std::sort(Key.begin() + 1, Key.end());
+
+    auto Inserted = ExpressionNumbers.emplace(Key, NextValueNumber);
+    unsigned N = Inserted.first->second;
+    if (Inserted.second) {
+      freshNumber();
+      // Remember addresses of the form Base + Offset.
+      if (I.getOpcode() == IeleInstruction::Add) {
+        Address L = addressOf(Key[1]), R = addressOf(Key[2]);
+        if (L.Base == NoBase || R.Base == NoBase)
+          Addresses[N] = Address{L.Base == NoBase ? R.Base : L.Base,
+                                 L.Offset + R.Offset};
+      }
+    }
+    define(I.getIeleLValueList().front(), N);
+  }
+
+  // Forgets the values of the addresses that may alias Addr.
+  void clobber(unsigned Addr) {
+    for (auto It = Storage.begin(); It != Storage.end();) {
+      if (mayAlias(It->first, Addr))
+        It = Storage.erase(It);
+      else
+        ++It;
+    }
+  }
+
+  // Keeps the stores to addresses that may alias Addr.
+  void read(unsigned Addr) {
+    for (auto It = PendingStores.begin(); It != PendingStores.end();) {
+      if (mayAlias(It->first, Addr))
+        It = PendingStores.erase(It);
+      else
+        ++It;
+    }
+  }
+
+  // Returns the facts about storage that hold at the current point.
+  StorageFacts currentFacts() const {
+    StorageFacts Facts;
+    for (const auto &Entry : Storage) {
+      IeleValue *Addr = holderOf(Entry.first);
+      IeleValue *Value = holderOf(Entry.second);
+      if (Addr && Value)
+        Facts[Addr] = Value;
+    }
+    return Facts;
+  }
+
+  // Merges Facts into the entry facts of B, scheduling B for analysis if its
+  // entry facts changed.
+  void propagate(IeleBlock *B, const StorageFacts &Facts) {
+    auto Inserted = EntryFacts.emplace(B, Facts);
+    bool Changed = Inserted.second;
+    if (!Changed) {
+      StorageFacts &Entry = Inserted.first->second;
+      for (auto It = Entry.begin(); It != Entry.end();) {
+        auto Other = Facts.find(It->first);
+        if (Other == Facts.end() || Other->second != It->second) {
+          It = Entry.erase(It);
+          Changed = true;
+        } else
+          ++It;
+      }
+    }
+    if (Changed && std::find(Worklist.begin(), Worklist.end(), B) ==
+                     Worklist.end())
+      Worklist.push_back(B);
+  }
+
+  // Analyzes B starting from its entry facts. Without Rewrite, propagates
+  // the facts at the exits of B to its successors. With Rewrite, removes the
+  // redundant storage accesses of B and returns their number.
+  unsigned runOnBlock(IeleBlock &B, bool Rewrite) {
+    NextValueNumber = NoBase + 1;
+    RegisterNumbers.clear();
+    ConstantNumbers.clear();
+    OtherNumbers.clear();
+    ExpressionNumbers.clear();
+    Holders.clear();
+    Addresses.clear();
+    Storage.clear();
+    PendingStores.clear();
+
+    auto Entry = EntryFacts.find(&B);
+    if (Entry != EntryFacts.end())
+      for (const auto &Fact : Entry->second)
+        Storage[numberOf(Fact.first)] = numberOf(Fact.second);
+
+    unsigned Removed = 0;
+    bool FallsThrough = true;
+    for (auto It = B.begin(), End = B.end(); It != End;) {
+      IeleInstruction &I = *It++;
+      IeleInstruction::IeleOps Opcode = I.getOpcode();
+
+      if (Opcode == IeleInstruction::SLoad) {
+        unsigned Addr = numberOf(*I.begin());
+        IeleLocalVariable *LV = I.getIeleLValueList().front();
+        auto Known = Storage.find(Addr);
+        IeleValue *Holder =
+          Known == Storage.end() ? nullptr : holderOf(Known->second);
+        if (!Holder) {
+          read(Addr);
+          unsigned N = freshNumber();
+          define(LV, N);
+          Storage[Addr] = N;
+          continue;
+        }
+        if (Rewrite) {
+          if (Holder != LV)
+            IeleInstruction::CreateAssign(LV, Holder, I.location(), &I);
+          I.eraseFromParent();
+          Removed++;
+        }
+        define(LV, Known->second);
+        continue;
+      }
+
+      if (Opcode == IeleInstruction::SStore) {
+        unsigned Value = numberOf(*I.begin());
+        unsigned Addr = numberOf(*(I.begin() + 1));
+        auto Known = Storage.find(Addr);
+        if (Known != Storage.end() && Known->second == Value) {
+          if (Rewrite) {
+            I.eraseFromParent();
+            Removed++;
+          }
+          continue;
+        }
+        auto Pending = PendingStores.find(Addr);
+        if (Rewrite && Pending != PendingStores.end()) {
+          Pending->second->eraseFromParent();
+          Removed++;
+        }
+        clobber(Addr);
+        Storage[Addr] = Value;
+        PendingStores[Addr] = &I;
+        continue;
+      }
+
+      if (!Rewrite && Opcode == IeleInstruction::Br)
+        propagate(I.getBranchTarget(), currentFacts());
+      if (I.isConditionalBranch() && !alwaysReverts(*I.getBranchTarget()))
+        PendingStores.clear();
+      if (I.isTerminator()) {
+        FallsThrough = false;
+        break;
+      }
+
+      // Calls may access any storage address, e.g. by calling back into the
+      // contract, and selfdestruct clears the storage.
+      if ((Opcode >= IeleInstruction::IeleCallsBegin &&
+           Opcode < IeleInstruction::IeleCallsEnd) ||
+          Opcode == IeleInstruction::Selfdestruct) {
+        Storage.clear();
+        PendingStores.clear();
+      }
+
+      if (Opcode == IeleInstruction::Assign)
+        define(I.getIeleLValueList().front(), numberOf(*I.begin()));
+      else if (I.isPure() && I.lvalue_size() == 1)
+        numberExpression(I);
+      else
+        for (IeleLocalVariable *LV : I.lvalues())
+          define(LV, freshNumber());
+    }
+    if (!Rewrite && FallsThrough)
+      if (IeleBlock *Next = B.getNextNode())
+        propagate(Next, currentFacts());
+    return Removed;
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<IeleContractPass>
+solidity::iele::createStorageValueNumberingPass() {
+  return std::make_unique<StorageValueNumbering>();
+}
@@ -17,6 +17,34 @@ entry:
   ret %next.free.ptr
 }
 
+define @ielert.memory.mark() {
+entry:
+  // return the current allocation state, so that the memory allocated after
+  // this point can be released with @ielert.memory.reset
+  %last.allocd = load 1
+  ret %last.allocd
+}
+
+define @ielert.memory.reset(%mark) {
+entry:
+  %last.allocd = load 1
+
+  // release the memory allocated since the mark
+  store %mark, 1
+
+  // clear the released slots, since allocated memory is expected to be zero
+release.loop:
+  %done = cmp le %last.allocd, %mark
+  br %done, exit
+  %slot = add %last.allocd, 1
+  store 0, %slot
+  %last.allocd = sub %last.allocd, 1
+  br release.loop
+
+exit:
+  ret void
+}
+
 define @ielert.memory.fill(%to, %size, %data) {
 fill.loop:
   %done = iszero %size
@@ -8,9 +8,12 @@
 #include <libsolutil/Keccak256.h>
 
 #include "libiele/IeleContract.h"
+#include "libiele/IeleGasEstimator.h"
 #include "libiele/IeleGlobalVariable.h"
 #include "libiele/IeleIntConstant.h"
+#include "libiele/IelePasses.h"
 
+#include <algorithm>
 #include <iostream>
 #include "llvm/Support/raw_ostream.h"
 
@@ -100,6 +103,32 @@ const ModifierDefinition *IeleCompiler::functionModifier(
   solAssert(false, "IeleCompiler: Function modifier not found.");
 }
 
+const ModifierDefinition *IeleCompiler::resolveModifier(
+    const FunctionDefinition &function,
+    const ModifierInvocation &modifierInvocation) const {
+  if (dynamic_cast<ContractDefinition const*>(modifierInvocation.name().annotation().referencedDeclaration))
+    return nullptr;
+
+  const ModifierDefinition *modifier = nullptr;
+  if (modifierInvocation.name().path().size() > 1) {
+    modifier =
+      dynamic_cast<const ModifierDefinition *>(
+        modifierInvocation.name().annotation().referencedDeclaration);
+  } else {
+    const ASTString &modName = modifierInvocation.name().path().at(0);
+    solAssert(!function.isFree(), "IeleCompiler: found free function with modifier");
+    if (contractFor(&function)->isLibrary()) {
+      for (ModifierDefinition const* mod: contractFor(&function)->functionModifiers())
+        if (mod->name() == modName)
+          modifier = mod;
+    } else {
+      modifier = functionModifier(modName);
+    }
+  }
+  solAssert(modifier, "Could not find modifier");
+  return modifier;
+}
+
 bool IeleCompiler::isMostDerived(const FunctionDefinition *d) const {
   solAssert(!CompilingContractInheritanceHierarchy.empty(), "IeleCompiler: current contract not set.");
   const FunctionType *functionType = FunctionType(*d).asExternallyCallableFunction(false);
@@ -261,6 +290,28 @@ static bool checkForRecursiveStructs(const ContractDefinition &contract) {
   return Locator.recursiveStructFound();
 }
 
+class ModifierControlFlowLocator : public ASTConstVisitor {
+public:
+  ModifierControlFlowLocator() : Placeholders(0), ReturnFound(false) { }
+
+  virtual bool visit(const PlaceholderStatement &) override {
+    Placeholders++;
+    return false;
+  }
+
+  virtual bool visit(const Return &) override {
+    ReturnFound = true;
+    return false;
+  }
+
+  unsigned placeholders() const { return Placeholders; }
+  bool returnFound() const { return ReturnFound; }
+
+private:
+  unsigned Placeholders;
+  bool ReturnFound;
+};
+
 } // end anonymous namespace
 
 void IeleCompiler::compileContract(
@@ -433,6 +484,9 @@ void IeleCompiler::compileContract(
     CurrentLoc = EmptyLoc;
   }
 
+  if (Optimiser.runIeleOptimiser)
+    outlineModifiers();
+
   // Visit base constructors. If any don't exist create an
   // @<base-contract-name>init function that contains only state variable
   // initialization.
@@ -581,11 +635,12 @@ void IeleCompiler::compileContract(
         &InitFunction->front().front());
   }
 
-  // Desugar constants out of operands of all instructions other than assignment.
-  // This is done to improve the accuracy of the source map information, because
-  // the IELE binary generated by the compiler would not need further desugarring
-  // by the IELE assembler.
-  desugarConstantOperands();
+  if (Optimiser.runIeleOptimiser)
+    releaseScratchMemory();
+  reserveSpillSlots();
+
+  // Optimize the generated code and prepare it for assembly.
+  runPasses();
 
   // Store compilation result.
   CompiledContract = CompilingContract;
@@ -594,36 +649,58 @@ void IeleCompiler::compileContract(
   CompiledContract->appendAuxiliaryDataToEnd(metadata);
 }
 
-void IeleCompiler::desugarConstantOperands() {
-  // Collect instructions to desugar.
-  std::vector<iele::IeleInstruction *> DesugarWorklist;
-  for (iele::IeleFunction &F : CompilingContract->functions()) {
-    for (iele::IeleBlock &B : F.blocks()) {
-      for (iele::IeleInstruction &I : B.instructions()) {
-        if (I.getOpcode() == iele::IeleInstruction::Assign)
-          continue;
-        for (iele::IeleValue *V : I.operands()) {
-          if (llvm::isa<iele::IeleIntConstant>(V)) {
-            DesugarWorklist.push_back(&I);
-            break;
-          }
-        }
-      }
-    }
+Json::Value IeleCompiler::gasEstimates() const {
+  solAssert(CompiledContract,
+            "Attempted access to compiled contract before compiling successfully.");
+  iele::IeleGasEstimator Estimator(*CompiledContract);
+  auto toJson = [](const iele::IeleGasEstimate &Estimate,
+                   const iele::IeleFunction &F) {
+    Json::Value Bounds(Json::objectValue);
+    Bounds["min"] = Estimate.minString();
+    Bounds["max"] = Estimate.maxString(F);
+    return Bounds;
+  };
+
+  Json::Value Output(Json::objectValue);
+  Json::Value External(Json::objectValue);
+  Json::Value Internal(Json::objectValue);
+  for (const iele::IeleFunction &F : CompiledContract->functions()) {
+    const iele::IeleGasEstimate &Estimate = Estimator.estimate(F);
+    if (F.isInit()) {
+      uint64_t CodeDeposit =
+        Estimator.getCodeDepositCost(assembledObject().bytecode.size());
+      iele::IeleGasEstimate Total = Estimate;
+      Total.Min += CodeDeposit;
+      Total.Max += CodeDeposit;
+      Json::Value Creation(Json::objectValue);
+      Creation["codeDepositCost"] = std::to_string(CodeDeposit);
+      Creation["executionCost"] = toJson(Estimate, F);
+      Creation["totalCost"] = toJson(Total, F);
+      Output["creation"] = Creation;
+    } else if (F.isPublic() || F.isDeposit())
+      External[F.getName().str()] = toJson(Estimate, F);
+    else
+      Internal[F.getName().str()] = toJson(Estimate, F);
   }
+  if (!External.empty())
+    Output["external"] = External;
+  if (!Internal.empty())
+    Output["internal"] = Internal;
+  return Output;
+}
 
-  // Desugar constant operands.
-  for (iele::IeleInstruction *I : DesugarWorklist) {
-    for (auto it = I->begin(), itEnd = I->end(); it != itEnd; ++it) {
-      iele::IeleValue *V = *it;
-      if (iele::IeleIntConstant *IC = llvm::dyn_cast<iele::IeleIntConstant>(V)) {
-        iele::IeleLocalVariable *ConstTmp =
-          iele::IeleLocalVariable::Create(&Context, "const.tmp", I->getParent()->getParent());
-        iele::IeleInstruction::CreateAssign(ConstTmp, IC, I->location(), I);
-        *it = ConstTmp;
-      }
-    }
-  }
+void IeleCompiler::runPasses() {
+  PassManager.emplace(Optimiser.runIeleOptimiser ? Optimiser.ielePasses : "");
+  PassManager->setMeasureCodeSize(MeasurePassCodeSizes);
+  PassManager->setInlineThreshold(unsigned(Optimiser.ieleInlineThreshold));
+  PassManager->run(*CompilingContract);
+
+  // Desugar constants out of operands of all instructions other than
+  // assignment. This is done last, because it only makes the code harder to
+  // optimize.
+  std::unique_ptr<iele::IeleContractPass> Desugar =
+    iele::createDesugarConstantOperandsPass();
+  PassManager->run(*Desugar, *CompilingContract);
 }
 
 int IeleCompiler::getNextUniqueIntToken() {
@@ -809,6 +886,9 @@ bool IeleCompiler::visit(const FunctionDefinition &function) {
   solAssert(CompilingFunction,
             "IeleCompiler: failed to find function in compiling contract's"
             " symbol table");
+  if (!CompilingFunction->isPublic() && !function.isConstructor() &&
+      !mayRetainMemory(function))
+    ScratchMemoryFunctions.insert(CompilingFunction);
 
   unsigned NumOfModifiers = CompilingFunctionASTNode->modifiers().size();
 
@@ -1196,29 +1276,18 @@ void IeleCompiler::appendModifierOrFunctionCode() {
     ASTPointer<ModifierInvocation> const& modifierInvocation =
       CompilingFunctionASTNode->modifiers()[ModifierDepth];
 
+    const ModifierDefinition *modifier =
+      resolveModifier(*CompilingFunctionASTNode, *modifierInvocation);
+
     // constructor call should be excluded (and managed separeately)
-    if (dynamic_cast<ContractDefinition const*>(modifierInvocation->name().annotation().referencedDeclaration)) {
+    if (!modifier) {
       appendModifierOrFunctionCode();
     }
     else {
-      // Retrieve modifier definition
-      const ModifierDefinition *modifier = nullptr;
-      if (modifierInvocation->name().path().size() > 1) {
-        modifier =
-          dynamic_cast<const ModifierDefinition *>(
-            modifierInvocation->name().annotation().referencedDeclaration);
-      } else {
-        const ASTString &modName = modifierInvocation->name().path().at(0);
-        solAssert(!CompilingFunctionASTNode->isFree(), "IeleCompiler: found free function with modifier");
-        if (contractFor(CompilingFunctionASTNode)->isLibrary()) {
-          for (ModifierDefinition const* mod: contractFor(CompilingFunctionASTNode)->functionModifiers())
-            if (mod->name() == modName)
-              modifier = mod;
-        } else {
-          modifier = functionModifier(modName);
-        }
-      }
-      solAssert(modifier, "Could not find modifier");
+      auto Outlined = OutlinedModifiers.find(modifier);
+      bool IsOutlined = Outlined != OutlinedModifiers.end();
+      llvm::SmallVector<iele::IeleLocalVariable *, 4> ParamRegisters;
+      llvm::SmallVector<iele::IeleLocalVariable *, 4> LocalRegisters;
 
       // Visit the modifier's parameters
       for (const ASTPointer<const VariableDeclaration> arg : modifier->parameters()) {
@@ -1227,12 +1296,14 @@ void IeleCompiler::appendModifierOrFunctionCode() {
           std::string genName = arg->name() + getNextVarSuffix();
           auto reg = iele::IeleLocalVariable::Create(&Context, genName, CompilingFunction);
           param.push_back(reg);
+          ParamRegisters.push_back(reg);
         }
         IeleLValue *lvalue = RegisterLValue::Create(param);
         VarNameMap[ModifierDepth][arg->name()] = lvalue;
       }
 
-      // Visit and initialize the modifier's local variables
+      // Visit and initialize the modifier's local variables. The outlined
+      // parts of a modifier initialize its local variables themselves.
       for (const VariableDeclaration *local: modifier->localVariables()) {
         std::string localName = getIeleNameForLocalVariable(local);
         std::vector<iele::IeleLocalVariable *> param;
@@ -1241,10 +1312,12 @@ void IeleCompiler::appendModifierOrFunctionCode() {
           iele::IeleLocalVariable *Local =
             iele::IeleLocalVariable::Create(&Context, genName, CompilingFunction);
           param.push_back(Local);
+          LocalRegisters.push_back(Local);
         }
         IeleLValue *lvalue = RegisterLValue::Create(param);
         VarNameMap[ModifierDepth][localName] = lvalue;
-        appendLocalVariableInitialization(lvalue, local);
+        if (!IsOutlined)
+          appendLocalVariableInitialization(lvalue, local);
       }
 
       std::vector<ASTPointer<Expression>> const& modifierArguments =
@@ -1283,8 +1356,37 @@ void IeleCompiler::appendModifierOrFunctionCode() {
         LHSValue->write(RHSValue, var.location(), CompilingBlock);
       }
 
-      // Arguments to the modifier have been taken care off. Now move to modifier's body.
-      codeBlock = &modifier->body();
+      if (IsOutlined) {
+        // Call the shared code before the placeholder, which returns the
+        // modifier's frame for the code after it, and continue with the next
+        // layer in between the calls.
+        const OutlinedModifier &Parts = Outlined->second;
+        llvm::SmallVector<iele::IeleValue *, 4> Arguments(
+          ParamRegisters.begin(), ParamRegisters.end());
+        if (Parts.Entry) {
+          llvm::SmallVector<iele::IeleLocalVariable *, 4> Frame;
+          if (Parts.Exit) {
+            Frame.append(ParamRegisters.begin(), ParamRegisters.end());
+            Frame.append(LocalRegisters.begin(), LocalRegisters.end());
+          }
+          iele::IeleInstruction::CreateInternalCall(
+            Frame, Parts.Entry, Arguments, modifierInvocation->location(),
+            CompilingBlock);
+          Arguments.assign(Frame.begin(), Frame.end());
+        }
+
+        appendModifierOrFunctionCode();
+
+        if (Parts.Exit) {
+          llvm::SmallVector<iele::IeleLocalVariable *, 4> NoResults;
+          iele::IeleInstruction::CreateInternalCall(
+            NoResults, Parts.Exit, Arguments, modifierInvocation->location(),
+            CompilingBlock);
+        }
+      } else {
+        // Arguments to the modifier have been taken care off. Now move to modifier's body.
+        codeBlock = &modifier->body();
+      }
     }
   }
 
@@ -1310,6 +1412,166 @@ void IeleCompiler::appendModifierOrFunctionCode() {
   ModifierDepth--;
 }
 
+bool IeleCompiler::canOutlineModifier(const ModifierDefinition &modifier) const {
+  if (contractFor(&modifier)->isLibrary())
+    return false;
+
+  // The placeholder must be a statement of the body itself, so that it is
+  // reached exactly once whenever the modifier does not revert.
+  const std::vector<ASTPointer<Statement>> &Statements =
+    modifier.body().statements();
+  if (std::none_of(Statements.begin(), Statements.end(),
+                   [](const ASTPointer<Statement> &S) {
+                     return dynamic_cast<const PlaceholderStatement *>(S.get());
+                   }))
+    return false;
+
+  ModifierControlFlowLocator Locator;
+  modifier.body().accept(Locator);
+  return Locator.placeholders() == 1 && !Locator.returnFound();
+}
+
+void IeleCompiler::outlineModifiers() {
+  // Count the invocations of each modifier by the functions of the contract.
+  std::map<const ModifierDefinition *, unsigned> Uses;
+  for (const ContractDefinition *base : CompilingContractInheritanceHierarchy)
+    for (const FunctionDefinition *function : base->definedFunctions()) {
+      if (!function->isImplemented())
+        continue;
+      for (const ASTPointer<ModifierInvocation> &invocation : function->modifiers())
+        if (const ModifierDefinition *modifier = resolveModifier(*function, *invocation))
+          Uses[modifier]++;
+    }
+
+  for (const auto &Entry : Uses) {
+    const ModifierDefinition &modifier = *Entry.first;
+    bigint NumUses = Entry.second;
+    if (NumUses < 2 || !canOutlineModifier(modifier))
+      continue;
+
+    const std::vector<ASTPointer<Statement>> &Statements =
+      modifier.body().statements();
+    auto Placeholder =
+      std::find_if(Statements.begin(), Statements.end(),
+                   [](const ASTPointer<Statement> &S) {
+                     return dynamic_cast<const PlaceholderStatement *>(S.get());
+                   });
+    bool HasEntry = Placeholder != Statements.begin();
+    bool HasExit = Placeholder + 1 != Statements.end();
+    if (!HasEntry && !HasExit)
+      continue;
+
+    OutlinedModifier Parts{nullptr, nullptr};
+    if (HasEntry)
+      Parts.Entry =
+        appendOutlinedModifierPart(modifier, modifier.name() + ".entry",
+                                   Statements.begin(), Placeholder,
+                                   true, HasExit);
+    if (HasExit)
+      Parts.Exit =
+        appendOutlinedModifierPart(modifier, modifier.name() + ".exit",
+                                   Placeholder + 1, Statements.end(),
+                                   !HasEntry, false);
+
+    // Compare the deposit for the bytes saved by sharing the parts with the
+    // gas spent on the calls to them. Each use calls every part, and each
+    // part adds its instructions, including the return, and its name to the
+    // contract.
+    bigint Calls = unsigned(HasEntry) + unsigned(HasExit);
+    bigint Size = -Calls, OutlinedBytes = NumUses * Calls * OutlinedModifierCallBytes;
+    for (iele::IeleFunction *F : {Parts.Entry, Parts.Exit})
+      if (F) {
+        for (const iele::IeleBlock &B : F->blocks())
+          Size += B.size();
+        OutlinedBytes += F->getName().size();
+      }
+    OutlinedBytes += (Size + Calls) * OutlinedModifierInstructionBytes;
+    bigint Saved = NumUses * Size * OutlinedModifierInstructionBytes - OutlinedBytes;
+    if (Saved * OutlinedModifierByteGas >
+        Calls * OutlinedModifierCallGas *
+          Optimiser.expectedExecutionsPerDeployment) {
+      OutlinedModifiers[&modifier] = Parts;
+      continue;
+    }
+
+    for (iele::IeleFunction *F : {Parts.Entry, Parts.Exit})
+      if (F)
+        CompilingContract->getIeleFunctionList().erase(F);
+  }
+}
+
+iele::IeleFunction *IeleCompiler::appendOutlinedModifierPart(
+    const ModifierDefinition &modifier, const std::string &Name,
+    std::vector<ASTPointer<Statement>>::const_iterator Begin,
+    std::vector<ASTPointer<Statement>>::const_iterator End,
+    bool InitializeLocals, bool ReturnFrame) {
+  CurrentLoc = modifier.location();
+  CompilingContractASTNode = contractFor(&modifier);
+  CompilingFunctionASTNode = nullptr;
+  CompilingFunction =
+    iele::IeleFunction::Create(&Context, false, Name, CompilingContract);
+  // The cost model of outlineModifiers decides whether the part is shared,
+  // which the inliner must not undo.
+  CompilingFunction->setNoInline(true);
+  ModifierDepth = 0;
+  VarNameMap.clear();
+
+  // The part takes the modifier's parameters, followed by its local variables
+  // unless it initializes them.
+  llvm::SmallVector<iele::IeleValue *, 4> Frame;
+  for (const ASTPointer<const VariableDeclaration> arg : modifier.parameters()) {
+    std::vector<iele::IeleLocalVariable *> param;
+    for (unsigned i = 0; i < arg->type()->sizeInRegisters(); i++) {
+      std::string genName = arg->name() + getNextVarSuffix();
+      auto reg = iele::IeleArgument::Create(&Context, genName, CompilingFunction);
+      param.push_back(reg);
+      Frame.push_back(reg);
+    }
+    VarNameMap[0][arg->name()] = RegisterLValue::Create(param);
+  }
+  for (const VariableDeclaration *local: modifier.localVariables()) {
+    std::string localName = getIeleNameForLocalVariable(local);
+    std::vector<iele::IeleLocalVariable *> param;
+    for (unsigned i = 0; i < local->type()->sizeInRegisters(); i++) {
+      std::string genName = localName + getNextVarSuffix();
+      iele::IeleLocalVariable *Local =
+        InitializeLocals ?
+          iele::IeleLocalVariable::Create(&Context, genName, CompilingFunction) :
+          iele::IeleArgument::Create(&Context, genName, CompilingFunction);
+      param.push_back(Local);
+      Frame.push_back(Local);
+    }
+    VarNameMap[0][localName] = RegisterLValue::Create(param);
+  }
+
+  CompilingFunctionStatus =
+    iele::IeleLocalVariable::Create(&Context, "status", CompilingFunction);
+  CompilingBlock =
+    iele::IeleBlock::Create(&Context, "entry", CompilingFunction);
+
+  if (InitializeLocals)
+    for (const VariableDeclaration *local: modifier.localVariables())
+      appendLocalVariableInitialization(
+        VarNameMap[0][getIeleNameForLocalVariable(local)], local);
+
+  for (auto It = Begin; It != End; ++It)
+    (*It)->accept(*this);
+
+  CurrentLoc = modifier.location();
+  if (ReturnFrame)
+    iele::IeleInstruction::CreateRet(Frame, CurrentLoc, CompilingBlock);
+  else
+    iele::IeleInstruction::CreateRetVoid(CurrentLoc, CompilingBlock);
+  appendRevertBlocks();
+
+  iele::IeleFunction *Part = CompilingFunction;
+  CompilingBlock = nullptr;
+  CompilingFunction = nullptr;
+  VarNameMap.clear();
+  CurrentLoc = EmptyLoc;
+  return Part;
+}
+
 bool IeleCompiler::visit(const Throw &throwStatement) {
   CurrentLoc = throwStatement.location();
 
@@ -2777,6 +3039,8 @@ iele::IeleValue *IeleCompiler::encoding(
   if (types.size() == 1 && types[0]->isValueType()) {
     appendWidths = false;
   }
+  if (hasFixedWidthLayout(types))
+    return appendFixedWidthEncoding(arguments, types, NextFree, bigEndian);
 
   // Create local vars needed for encoding
   iele::IeleLocalVariable *CrntPos = 
@@ -2798,6 +3062,91 @@ iele::IeleValue *IeleCompiler::encoding(
   return CrntPos;
 }
 
+bool IeleCompiler::hasFixedWidthLayout(const TypePointers &types) {
+  for (TypePointer type : types) {
+    switch (type->category()) {
+    case Type::Category::Contract:
+    case Type::Category::Address:
+    case Type::Category::FixedBytes:
+    case Type::Category::Enum:
+    case Type::Category::Bool:
+    case Type::Category::Integer:
+      if (type->getFixedBitwidth() == 0)
+        return false;
+      break;
+    default:
+      return false;
+    }
+  }
+  return !types.empty();
+}
+
+/// Perform encoding of values of fixed-width types. The encoding is the
+/// concatenation of the bytes of all values, so instead of storing each value
+/// at a position computed at run time, the values are shifted to their offsets
+/// and combined into a single integer, which is byte-swapped and stored once.
+iele::IeleValue *IeleCompiler::appendFixedWidthEncoding(
+    llvm::SmallVectorImpl<IeleRValue *> &arguments,
+    const TypePointers &types,
+    iele::IeleLocalVariable *NextFree,
+    bool bigEndian) {
+  bigint Width = 0;
+  for (TypePointer type : types)
+    Width += (type->getFixedBitwidth() + 7) / 8;
+
+  iele::IeleLocalVariable *Encoded =
+    iele::IeleLocalVariable::Create(&Context, "encoded.val", CompilingFunction);
+  iele::IeleValue *Combined = nullptr;
+  bigint Offset = 0;
+  for (unsigned i = 0; i < arguments.size(); i++) {
+    bigint Size = (types[i]->getFixedBitwidth() + 7) / 8;
+    iele::IeleValue *Part = arguments[i]->getValue();
+    // Negative values are encoded in two's complement.
+    if (const IntegerType *intType = dynamic_cast<const IntegerType *>(types[i]))
+      if (intType->isSigned()) {
+        iele::IeleLocalVariable *Twos =
+          iele::IeleLocalVariable::Create(&Context, "twos", CompilingFunction);
+        iele::IeleInstruction::CreateBinOp(
+          iele::IeleInstruction::Twos, Twos,
+          iele::IeleIntConstant::Create(&Context, Size), Part,
+          CurrentLoc, CompilingBlock);
+        Part = Twos;
+      }
+    // In big-endian order the first value is in the most significant bytes,
+    // in little-endian order in the least significant ones.
+    bigint Shift = bigEndian ? Width - Offset - Size : Offset;
+    if (Shift != 0) {
+      iele::IeleLocalVariable *Shifted =
+        iele::IeleLocalVariable::Create(&Context, "shifted", CompilingFunction);
+      iele::IeleInstruction::CreateBinOp(
+        iele::IeleInstruction::Shift, Shifted, Part,
+        iele::IeleIntConstant::Create(&Context, Shift * 8),
+        CurrentLoc, CompilingBlock);
+      Part = Shifted;
+    }
+    if (Combined) {
+      iele::IeleInstruction::CreateBinOp(
+        iele::IeleInstruction::Or, Encoded, Combined, Part,
+        CurrentLoc, CompilingBlock);
+      Combined = Encoded;
+    } else
+      Combined = Part;
+    Offset += Size;
+  }
+
+  iele::IeleIntConstant *WidthValue = iele::IeleIntConstant::Create(&Context, Width);
+  if (bigEndian) {
+    iele::IeleInstruction::CreateBinOp(
+      iele::IeleInstruction::BSwap, Encoded, WidthValue, Combined,
+      CurrentLoc, CompilingBlock);
+    Combined = Encoded;
+  }
+  iele::IeleInstruction::CreateStore(
+    Combined, NextFree, iele::IeleIntConstant::getZero(&Context), WidthValue,
+    CurrentLoc, CompilingBlock);
+  return WidthValue;
+}
+
 void IeleCompiler::doEncode(
     iele::IeleValue *NextFree,
     iele::IeleLocalVariable *CrntPos, IeleLValue *LValue, 
@@ -3200,7 +3549,7 @@ void IeleCompiler::appendStructEncode(
 
 void IeleCompiler::decoding(IeleRValue *encoded, TypePointers types,
                             llvm::SmallVectorImpl<IeleRValue *> &results) {
-  iele::IeleLocalVariable *NextFree = appendMemorySpill();
+  iele::IeleLocalVariable *NextFree = appendSpillSlot();
   iele::IeleInstruction::CreateStore(
     encoded->getValue(), NextFree, CurrentLoc, CompilingBlock);
 
@@ -3231,7 +3580,7 @@ IeleRValue *IeleCompiler::decoding(IeleRValue *encoded, TypePointer type) {
   }
 
   // Allocate cell 
-  iele::IeleLocalVariable *NextFree = appendMemorySpill();
+  iele::IeleLocalVariable *NextFree = appendSpillSlot();
 
   iele::IeleInstruction::CreateStore(
     encoded->getValue(), NextFree, CurrentLoc, CompilingBlock);
@@ -4125,7 +4474,8 @@ bool IeleCompiler::visit(const FunctionCall &functionCall) {
       }
     }
     // Find out next free location (will store encoding of non-indexed args)     
-    iele::IeleLocalVariable *NextFree = appendMemorySpill();
+    iele::IeleLocalVariable *NextFree =
+      hasFixedEncodingSize(nonIndexedTypes) ? appendSpillSlot() : appendMemorySpill();
 
     // Store non-indexed args in memory
     if (NonIndexedArguments.size() > 0) {
@@ -4506,7 +4856,7 @@ bool IeleCompiler::visit(const FunctionCall &functionCall) {
       Lengths.push_back(Length);
       iele::IeleInstruction::CreateLoad(
         Length, ArgValue->getValue(), CurrentLoc, CompilingBlock);
-      iele::IeleLocalVariable *NextFree = appendMemorySpill();
+      iele::IeleLocalVariable *NextFree = appendSpillSlot();
       llvm::SmallVector<IeleRValue *, 1> Args;
       Args.push_back(ArgValue);
       TypePointers types;
@@ -4662,8 +5012,11 @@ bool IeleCompiler::visit(const FunctionCall &functionCall) {
       iele::IeleLocalVariable::Create(&Context, "computed.hash", CompilingFunction);
     Returns.push_back(Return);
 
-    // Allocate cell 
-    iele::IeleLocalVariable *NextFree = appendMemorySpill();
+    // Allocate cell. The hash covers the whole cell, so a spill slot can only be
+    // used if the encoding always has the same size.
+    iele::IeleLocalVariable *NextFree =
+      function.kind() != FunctionType::Kind::KECCAK256 || hasFixedEncodingSize(Types) ?
+        appendSpillSlot() : appendMemorySpill();
     iele::IeleValue *ByteWidth = encoding(Arguments, Types, NextFree, false);
     if (function.kind() == FunctionType::Kind::KECCAK256) {
       iele::IeleInstruction::CreateSha3(
@@ -5875,9 +6228,12 @@ IeleLValue *IeleCompiler::appendArrayAccess(const ArrayType &type, iele::IeleVal
   }
   if (type.isDynamicallySized() && !type.isByteArray()) {
     // Add 1 to skip the first slot that holds the size.
+    iele::IeleLocalVariable *ElementsOffsetValue =
+      iele::IeleLocalVariable::Create(&Context, "tmp", CompilingFunction);
     iele::IeleInstruction::CreateBinOp(
-        iele::IeleInstruction::Add, OffsetValue, OffsetValue,
+        iele::IeleInstruction::Add, ElementsOffsetValue, OffsetValue,
         iele::IeleIntConstant::getOne(&Context), CurrentLoc, CompilingBlock);
+    OffsetValue = ElementsOffsetValue;
   }
 
   // Generate code for the out-of-bounds check.
@@ -5975,7 +6331,7 @@ IeleLValue *IeleCompiler::appendMappingAccess(const MappingType &type, iele::Iel
   TypePointer valueType = type.valueType();
   // Hash index if needed.
   if (type.hasHashedKeyspace()) {
-    iele::IeleLocalVariable *MemorySpillAddress = appendMemorySpill();
+    iele::IeleLocalVariable *MemorySpillAddress = appendSpillSlot();
     iele::IeleInstruction::CreateStore(
         IndexValue, MemorySpillAddress, CurrentLoc, CompilingBlock);
     iele::IeleLocalVariable *HashedIndexValue =
@@ -5986,23 +6342,24 @@ IeleLValue *IeleCompiler::appendMappingAccess(const MappingType &type, iele::Iel
   }
 
   // Generate code for the access.
-  // First compute the address of the accessed value.
-  iele::IeleLocalVariable *AddressValue =
+  // First compute the address of the accessed value. The offset gets a
+  // register of its own, so that both computations can be reused by common
+  // subexpression elimination.
+  iele::IeleLocalVariable *OffsetValue =
     iele::IeleLocalVariable::Create(&Context, "tmp", CompilingFunction);
   if (type.hasInfiniteKeyspace()) {
     // In this case AddressValue = ExprValue + IndexValue < nbits(StorageSize)
-    appendShiftBy(AddressValue, IndexValue,
+    appendShiftBy(OffsetValue, IndexValue,
                   util::bitsRequired(NextStorageAddress));
-    iele::IeleInstruction::CreateBinOp(
-        iele::IeleInstruction::Add, AddressValue, ExprValue, AddressValue,
-        CurrentLoc, CompilingBlock);
   } else {
     // In this case AddressValue = ExprValue + IndexValue * ValueTypeSize
-    appendMul(AddressValue, IndexValue, valueType->storageSize());
-    iele::IeleInstruction::CreateBinOp(
-        iele::IeleInstruction::Add, AddressValue, ExprValue, AddressValue,
-        CurrentLoc, CompilingBlock);
+    appendMul(OffsetValue, IndexValue, valueType->storageSize());
   }
+  iele::IeleLocalVariable *AddressValue =
+    iele::IeleLocalVariable::Create(&Context, "tmp", CompilingFunction);
+  iele::IeleInstruction::CreateBinOp(
+      iele::IeleInstruction::Add, AddressValue, ExprValue, OffsetValue,
+      CurrentLoc, CompilingBlock);
   return makeLValue(AddressValue, valueType, DataLocation::Storage);
 }
 
@@ -6992,12 +7349,18 @@ iele::IeleLocalVariable *IeleCompiler::appendRecursiveStructAllocation(
   return RecStructAllocValue;
 }
 
-void IeleCompiler::appendByteArrayCopyLoop(
+void IeleCompiler::appendByteArrayCopy(
     IeleLValue *To, IeleRValue *From,
     DataLocation ToLoc, DataLocation FromLoc,
-    iele::IeleLocalVariable *SizeVariableFrom,
-    iele::IeleLocalVariable *IndexTo, iele::IeleLocalVariable *IndexFrom) {
-
+    iele::IeleValue *SizeValue,
+    iele::IeleValue *IndexTo, iele::IeleValue *IndexFrom) {
+
+    // The bytes of a byte array are held by a single memory cell after its
+    // length, so the whole range is moved with one wide load and one wide
+    // store. Only slices, which are never in storage, are copied this way;
+    // whole byte arrays are copied by the runtime.
+    solAssert(ToLoc != DataLocation::Storage && FromLoc != DataLocation::Storage,
+              "IeleCompiler: byte array range copy to or from storage.");
     iele::IeleLocalVariable *AddressFrom =
       iele::IeleLocalVariable::Create(&Context, "string.address.from", CompilingFunction);
     iele::IeleLocalVariable *AddressTo =
@@ -7011,40 +7374,12 @@ void IeleCompiler::appendByteArrayCopyLoop(
         iele::IeleIntConstant::getOne(&Context),
         CurrentLoc, CompilingBlock);
 
-    iele::IeleBlock *LoopBodyBlock =
-      iele::IeleBlock::Create(&Context, "copy.loop", CompilingFunction);
-    CompilingBlock = LoopBodyBlock;
-
-    iele::IeleBlock *LoopExitBlock =
-      iele::IeleBlock::Create(&Context, "copy.loop.end");
-
-    iele::IeleLocalVariable *DoneValue =
-      iele::IeleLocalVariable::Create(&Context, "done", CompilingFunction);
-    iele::IeleInstruction::CreateIsZero(
-      DoneValue, SizeVariableFrom, CurrentLoc, CompilingBlock);
-    connectWithConditionalJump(DoneValue, CompilingBlock, LoopExitBlock);
-
-    IeleRValue *FromValue = makeLValue(AddressFrom, UInt8, FromLoc, IndexFrom)->read(CurrentLoc, CompilingBlock);
-    makeLValue(AddressTo, UInt8, ToLoc, IndexTo)->write(FromValue, CurrentLoc, CompilingBlock);
-
-    iele::IeleInstruction::CreateBinOp(
-        iele::IeleInstruction::Add, IndexFrom, IndexFrom,
-        iele::IeleIntConstant::getOne(&Context),
-        CurrentLoc, CompilingBlock);
-    iele::IeleInstruction::CreateBinOp(
-        iele::IeleInstruction::Add, IndexTo, IndexTo,
-        iele::IeleIntConstant::getOne(&Context),
-        CurrentLoc, CompilingBlock);
-    iele::IeleInstruction::CreateBinOp(
-        iele::IeleInstruction::Sub, SizeVariableFrom, SizeVariableFrom,
-        iele::IeleIntConstant::getOne(&Context),
-        CurrentLoc, CompilingBlock);
-
-    connectWithUnconditionalJump(CompilingBlock, LoopBodyBlock);
-    LoopExitBlock->insertInto(CompilingFunction);
-    CompilingBlock = LoopExitBlock;
-
-    return;
+    iele::IeleLocalVariable *Bytes =
+      iele::IeleLocalVariable::Create(&Context, "string.bytes", CompilingFunction);
+    iele::IeleInstruction::CreateLoad(
+      Bytes, AddressFrom, IndexFrom, SizeValue, CurrentLoc, CompilingBlock);
+    iele::IeleInstruction::CreateStore(
+      Bytes, AddressTo, IndexTo, SizeValue, CurrentLoc, CompilingBlock);
 }
 
 void IeleCompiler::appendArrayCopyLoop(
@@ -7052,7 +7387,8 @@ void IeleCompiler::appendArrayCopyLoop(
     IeleRValue *From, const ArrayType &arrayType,
     DataLocation ToLoc, DataLocation FromLoc,
     iele::IeleLocalVariable *SizeVariableTo, iele::IeleLocalVariable *SizeVariableFrom,
-    iele::IeleLocalVariable *ElementTo, iele::IeleLocalVariable *ElementFrom) {
+    iele::IeleLocalVariable *ElementTo, iele::IeleLocalVariable *ElementFrom,
+    bool ToIsFresh) {
 
     TypePointer elementType = arrayType.baseType();
     TypePointer toElementType = toArrayType.baseType();
@@ -7088,12 +7424,23 @@ void IeleCompiler::appendArrayCopyLoop(
     iele::IeleValue *ToElementSizeValue =
         iele::IeleIntConstant::Create(&Context, toElementSize);
 
+    // The elements of the destination that are not copied are cleared, unless
+    // the destination was just allocated and is still zero.
+    bool NeedsFill = !(ToIsFresh && AllocatedMemoryIsZero);
     iele::IeleLocalVariable *FillLoc, *FillSize;
     if (!elementType->isDynamicallyEncoded() && *elementType == *toElementType) {
       iele::IeleLocalVariable *CopySize =
         iele::IeleLocalVariable::Create(&Context, "copy.size", CompilingFunction);
       appendMul(CopySize, SizeVariableFrom, elementSize);
-      appendIeleRuntimeCopy(ElementFrom, ElementTo, CopySize, FromLoc, ToLoc);
+      // The size of a statically sized array is known at compile time, which
+      // allows copying small arrays without a runtime loop.
+      iele::IeleValue *CopySizeValue = CopySize;
+      if (!arrayType.isDynamicallySized())
+        CopySizeValue =
+          iele::IeleIntConstant::Create(&Context, arrayType.length() * elementSize);
+      appendIeleRuntimeCopy(ElementFrom, ElementTo, CopySizeValue, FromLoc, ToLoc);
+      if (!NeedsFill)
+        return;
 
       FillLoc = iele::IeleLocalVariable::Create(&Context, "fill.address", CompilingFunction);
       iele::IeleInstruction::CreateBinOp(
@@ -7141,6 +7488,8 @@ void IeleCompiler::appendArrayCopyLoop(
       connectWithUnconditionalJump(CompilingBlock, LoopBodyBlock);
       LoopExitBlock->insertInto(CompilingFunction);
       CompilingBlock = LoopExitBlock;
+      if (!NeedsFill)
+        return;
 
       FillLoc = ElementTo;
       FillSize = SizeVariableTo;
@@ -7270,6 +7619,9 @@ void IeleCompiler::appendCopy(
         ElementFrom, From->getValue(), CurrentLoc, CompilingBlock);
     }
 
+    // Whether the destination array is allocated here.
+    bool ToIsFresh = false;
+
     // copy the size field
     if (ToType->isDynamicallySized()) {
       if (ToLoc == DataLocation::Storage) {
@@ -7285,6 +7637,7 @@ void IeleCompiler::appendCopy(
           SizeVariableTo, SizeVariableFrom,
           CurrentLoc, CompilingBlock);
         AllocedValue = appendArrayAllocation(toArrayType, SizeVariableTo);
+        ToIsFresh = true;
         To->write(IeleRValue::Create(AllocedValue), CurrentLoc, CompilingBlock);
       }
 
@@ -7296,6 +7649,7 @@ void IeleCompiler::appendCopy(
       if (dynamic_cast<RegisterLValue *>(To)) {
         AllocedValue = appendArrayAllocation(toArrayType);
         To->write(IeleRValue::Create(AllocedValue), CurrentLoc, CompilingBlock);
+        ToIsFresh = true;
       } else {
         AllocedValue = To->read(CurrentLoc, CompilingBlock)->getValue();
       }
@@ -7311,7 +7665,7 @@ void IeleCompiler::appendCopy(
        From, arrayType,
        ToLoc, FromLoc,
        SizeVariableTo, SizeVariableFrom,
-       ElementTo, ElementFrom);
+       ElementTo, ElementFrom, ToIsFresh);
 
     break;
   }
@@ -7342,22 +7696,11 @@ void IeleCompiler::appendCopy(
         SizeVariableFrom, AllocedValue,
         CurrentLoc, CompilingBlock);
 
-      iele::IeleLocalVariable *IndexFrom =
-        iele::IeleLocalVariable::Create(&Context, "index.from", CompilingFunction);
-      iele::IeleLocalVariable *IndexTo =
-        iele::IeleLocalVariable::Create(&Context, "index.to", CompilingFunction);
-      iele::IeleInstruction::CreateAssign(
-        IndexFrom, From->getValues()[1],
-        CurrentLoc, CompilingBlock);
-      iele::IeleInstruction::CreateAssign(
-        IndexTo, iele::IeleIntConstant::getZero(&Context),
-        CurrentLoc, CompilingBlock);
-
-      appendByteArrayCopyLoop(
+      appendByteArrayCopy(
          To, From,
          ToLoc, FromLoc,
          SizeVariableFrom,
-         IndexTo, IndexFrom);
+         iele::IeleIntConstant::getZero(&Context), From->getValues()[1]);
       return;
     }
     solAssert(!arrayType.isByteArray() && !toArrayType.isByteArray(),
@@ -7404,6 +7747,9 @@ void IeleCompiler::appendCopy(
         StartOffsetValue,
         CurrentLoc, CompilingBlock);
 
+    // Whether the destination array is allocated here.
+    bool ToIsFresh = false;
+
     // copy the size field
     if (ToType->isDynamicallySized()) {
       if (ToLoc == DataLocation::Storage) {
@@ -7419,6 +7765,7 @@ void IeleCompiler::appendCopy(
           SizeVariableTo, SizeVariableFrom,
           CurrentLoc, CompilingBlock);
         AllocedValue = appendArrayAllocation(toArrayType, SizeVariableTo);
+        ToIsFresh = true;
         To->write(IeleRValue::Create(AllocedValue), CurrentLoc, CompilingBlock);
       }
 
@@ -7430,6 +7777,7 @@ void IeleCompiler::appendCopy(
       if (dynamic_cast<RegisterLValue *>(To)) {
         AllocedValue = appendArrayAllocation(toArrayType);
         To->write(IeleRValue::Create(AllocedValue), CurrentLoc, CompilingBlock);
+        ToIsFresh = true;
       } else {
         AllocedValue = To->read(CurrentLoc, CompilingBlock)->getValue();
       }
@@ -7445,7 +7793,7 @@ void IeleCompiler::appendCopy(
        From, arrayType,
        ToLoc, FromLoc,
        SizeVariableTo, SizeVariableFrom,
-       ElementTo, ElementFrom);
+       ElementTo, ElementFrom, ToIsFresh);
 
     break;
   }
@@ -8163,6 +8511,239 @@ iele::IeleLocalVariable *IeleCompiler::appendMemorySpill() {
   return NextFree;
 }
 
+// Memory cell 1 holds the address of the last allocated cell minus one, and
+// allocation starts at cell 2. The cells 2 to NextSpillSlot + 1 are reserved
+// for spill slots by reserveSpillSlots.
+iele::IeleLocalVariable *IeleCompiler::appendSpillSlot() {
+  iele::IeleLocalVariable *Slot =
+      iele::IeleLocalVariable::Create(&Context, "spill.slot", CompilingFunction);
+  iele::IeleInstruction::CreateAssign(
+      Slot, iele::IeleIntConstant::Create(&Context, bigint(2 + NextSpillSlot++)),
+      CurrentLoc, CompilingBlock);
+  SpillSlotUsers.insert(CompilingFunction);
+  return Slot;
+}
+
+void IeleCompiler::reserveSpillSlots() {
+  if (NextSpillSlot == 0)
+    return;
+
+  // Find the functions that may call a function using spill slots. Calls
+  // through function pointers may call any function.
+  iele::IeleValueSymbolTable *ST = CompilingContract->getIeleValueSymbolTable();
+  std::set<const iele::IeleFunction *> Reaching = SpillSlotUsers;
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (const iele::IeleFunction &F : CompilingContract->functions()) {
+      if (Reaching.count(&F))
+        continue;
+      bool Reaches = false;
+      for (const iele::IeleBlock &B : F.blocks())
+        for (const iele::IeleInstruction &I : B.instructions()) {
+          if (I.getOpcode() != iele::IeleInstruction::Call)
+            continue;
+          const iele::IeleValue *Callee = *I.begin();
+          const iele::IeleFunction *Target =
+            llvm::dyn_cast<iele::IeleFunction>(Callee);
+          if (const iele::IeleGlobalVariable *GV =
+                llvm::dyn_cast<iele::IeleGlobalVariable>(Callee))
+            Target = llvm::dyn_cast_or_null<iele::IeleFunction>(
+              ST->lookup(GV->getName()));
+          Reaches |= llvm::isa<iele::IeleLocalVariable>(Callee) ||
+                     Reaching.count(Target);
+        }
+      if (Reaches) {
+        Reaching.insert(&F);
+        Changed = true;
+      }
+    }
+  }
+
+  // Memory is empty when the contract is called, but public functions may
+  // also be called internally, after memory has been allocated. Reserve the
+  // spill slots only if nothing has been allocated yet:
+  //   last.allocd += iszero(last.allocd) * NextSpillSlot
+  iele::IeleValue *One = iele::IeleIntConstant::getOne(&Context);
+  iele::IeleValue *NumSlots =
+    iele::IeleIntConstant::Create(&Context, bigint(NextSpillSlot));
+  for (iele::IeleFunction &F : CompilingContract->functions()) {
+    if ((!F.isPublic() && !F.isInit()) || !Reaching.count(&F))
+      continue;
+    solAssert(!F.empty() && !F.front().empty(),
+              "IeleCompiler: public function without entry instructions");
+    iele::IeleInstruction *InsertBefore = &F.front().front();
+    const langutil::SourceLocation &Loc = InsertBefore->location();
+    iele::IeleLocalVariable *LastAllocated =
+      iele::IeleLocalVariable::Create(&Context, "last.allocd", &F);
+    iele::IeleLocalVariable *Reserved =
+      iele::IeleLocalVariable::Create(&Context, "spill.slots", &F);
+    iele::IeleInstruction::CreateLoad(LastAllocated, One, Loc, InsertBefore);
+    iele::IeleInstruction::CreateIsZero(Reserved, LastAllocated, Loc,
+                                        InsertBefore);
+    iele::IeleInstruction::CreateBinOp(
+      iele::IeleInstruction::Mul, Reserved, Reserved, NumSlots, Loc,
+      InsertBefore);
+    iele::IeleInstruction::CreateBinOp(
+      iele::IeleInstruction::Add, LastAllocated, LastAllocated, Reserved, Loc,
+      InsertBefore);
+    iele::IeleInstruction::CreateStore(LastAllocated, One, Loc, InsertBefore);
+  }
+}
+
+bool IeleCompiler::mayRetainMemory(const FunctionDefinition &function) {
+  // Storage references and values cannot point to memory.
+  auto pointsToMemory = [](const ASTPointer<VariableDeclaration> &param) {
+    TypePointer type = param->annotation().type;
+    return !type->isValueType() && !type->dataStoredIn(DataLocation::Storage);
+  };
+  return std::any_of(function.parameters().begin(), function.parameters().end(),
+                     pointsToMemory) ||
+         std::any_of(function.returnParameters().begin(),
+                     function.returnParameters().end(), pointsToMemory);
+}
+
+void IeleCompiler::releaseScratchMemory() {
+  if (ScratchMemoryFunctions.empty())
+    return;
+
+  iele::IeleValueSymbolTable *ST = CompilingContract->getIeleValueSymbolTable();
+  auto calleeOf = [ST](const iele::IeleInstruction &I)
+    -> const iele::IeleFunction * {
+    const iele::IeleValue *Callee = *I.begin();
+    if (const iele::IeleGlobalVariable *GV =
+          llvm::dyn_cast<iele::IeleGlobalVariable>(Callee))
+      return llvm::dyn_cast_or_null<iele::IeleFunction>(
+        ST->lookup(GV->getName()));
+    return llvm::dyn_cast<iele::IeleFunction>(Callee);
+  };
+
+  // Releasing memory costs a loop over the released cells on every return,
+  // which only pays off if the function may be called many times in the same
+  // transaction. Find the functions called inside a loop, and the functions
+  // called by those.
+  std::set<const iele::IeleFunction *> Repeated;
+  for (const iele::IeleFunction &F : CompilingContract->functions()) {
+    std::map<const iele::IeleBlock *, std::vector<const iele::IeleBlock *>>
+      Successors;
+    for (const iele::IeleBlock &B : F.blocks()) {
+      bool FallsThrough = true;
+      for (const iele::IeleInstruction &I : B.instructions()) {
+        if (I.getOpcode() == iele::IeleInstruction::Br)
+          Successors[&B].push_back(I.getBranchTarget());
+        if (I.isTerminator()) {
+          FallsThrough = false;
+          break;
+        }
+      }
+      if (FallsThrough && B.getNextNode())
+        Successors[&B].push_back(B.getNextNode());
+    }
+    for (const iele::IeleBlock &B : F.blocks()) {
+      std::set<const iele::IeleFunction *> Callees;
+      for (const iele::IeleInstruction &I : B.instructions())
+        if (I.getOpcode() == iele::IeleInstruction::Call)
+          if (const iele::IeleFunction *Callee = calleeOf(I))
+            Callees.insert(Callee);
+      if (Callees.empty())
+        continue;
+      std::set<const iele::IeleBlock *> Seen;
+      std::vector<const iele::IeleBlock *> Worklist(Successors[&B].begin(),
+                                                    Successors[&B].end());
+      while (!Worklist.empty() && !Seen.count(&B)) {
+        const iele::IeleBlock *Block = Worklist.back();
+        Worklist.pop_back();
+        if (Seen.insert(Block).second)
+          Worklist.insert(Worklist.end(), Successors[Block].begin(),
+                          Successors[Block].end());
+      }
+      if (Seen.count(&B))
+        Repeated.insert(Callees.begin(), Callees.end());
+    }
+  }
+  std::vector<const iele::IeleFunction *> Worklist(Repeated.begin(),
+                                                   Repeated.end());
+  while (!Worklist.empty()) {
+    const iele::IeleFunction *F = Worklist.back();
+    Worklist.pop_back();
+    for (const iele::IeleBlock &B : F->blocks())
+      for (const iele::IeleInstruction &I : B.instructions())
+        if (I.getOpcode() == iele::IeleInstruction::Call)
+          if (const iele::IeleFunction *Callee = calleeOf(I))
+            if (Repeated.insert(Callee).second)
+              Worklist.push_back(Callee);
+  }
+
+  // Find the functions that may allocate memory, either directly, as spills,
+  // or by calling a function that does. Calls through function pointers may
+  // call any function.
+  std::set<const iele::IeleFunction *> Allocating;
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (const iele::IeleFunction &F : CompilingContract->functions()) {
+      if (Allocating.count(&F))
+        continue;
+      bool Allocates = false;
+      for (const iele::IeleBlock &B : F.blocks())
+        for (const iele::IeleInstruction &I : B.instructions()) {
+          if (I.getOpcode() == iele::IeleInstruction::Store) {
+            const iele::IeleIntConstant *Address =
+              llvm::dyn_cast<iele::IeleIntConstant>(*(I.begin() + 1));
+            Allocates |= Address && Address->getValue() == 1;
+            continue;
+          }
+          if (I.getOpcode() != iele::IeleInstruction::Call)
+            continue;
+          const iele::IeleValue *Callee = *I.begin();
+          if (const iele::IeleGlobalVariable *GV =
+                llvm::dyn_cast<iele::IeleGlobalVariable>(Callee))
+            Allocates |= GV->getName() == "ielert.memory.allocate";
+          Allocates |= llvm::isa<iele::IeleLocalVariable>(Callee) ||
+                       Allocating.count(calleeOf(I));
+        }
+      if (Allocates) {
+        Allocating.insert(&F);
+        Changed = true;
+      }
+    }
+  }
+
+  for (iele::IeleFunction &F : CompilingContract->functions()) {
+    if (!ScratchMemoryFunctions.count(&F) || !Allocating.count(&F) ||
+        !Repeated.count(&F))
+      continue;
+    CompilingContract->setIncludeMemoryRuntime(true);
+    iele::IeleLocalVariable *Mark =
+      iele::IeleLocalVariable::Create(&Context, "memory.mark", &F);
+    iele::IeleInstruction *Entry = &F.front().front();
+    llvm::SmallVector<iele::IeleLocalVariable *, 1> Results(1, Mark);
+    llvm::SmallVector<iele::IeleValue *, 0> NoArguments;
+    iele::IeleInstruction::CreateInternalCall(
+      Results, iele::IeleGlobalVariable::Create(&Context, "ielert.memory.mark"),
+      NoArguments, Entry->location(), Entry);
+
+    for (iele::IeleBlock &B : F.blocks())
+      for (iele::IeleInstruction &I : B.instructions()) {
+        if (I.getOpcode() != iele::IeleInstruction::Ret)
+          continue;
+        llvm::SmallVector<iele::IeleLocalVariable *, 0> NoResults;
+        llvm::SmallVector<iele::IeleValue *, 1> Arguments(1, Mark);
+        iele::IeleInstruction::CreateInternalCall(
+          NoResults,
+          iele::IeleGlobalVariable::Create(&Context, "ielert.memory.reset"),
+          Arguments, I.location(), &I);
+      }
+  }
+}
+
+bool IeleCompiler::hasFixedEncodingSize(const TypePointers &types) {
+  for (TypePointer type : types)
+    if (!type->isValueType() || type->getFixedBitwidth() == 0)
+      return false;
+  return true;
+}
+
 bool IeleCompiler::shouldCopyStorageToStorage(const Type &ToType, const IeleLValue *To,
                                               const Type &From) const {
   return dynamic_cast<const ReadOnlyLValue *>(To) &&
@@ -8194,9 +8775,45 @@ bool IeleCompiler::shouldCopyStorageToMemory(const Type &ToType,
          FromType.dataStoredIn(DataLocation::Storage);
 }
 
+std::optional<unsigned> IeleCompiler::getInlineSlotCount(
+     iele::IeleValue *NumSlots) const {
+  iele::IeleIntConstant *Constant =
+    llvm::dyn_cast<iele::IeleIntConstant>(NumSlots);
+  if (!Constant || !Optimiser.runIeleOptimiser ||
+      Constant->getValue() > Optimiser.ieleInlineCopySlots)
+    return std::nullopt;
+  return unsigned(Constant->getValue());
+}
+
+iele::IeleValue *IeleCompiler::appendSlotAddress(
+     iele::IeleValue *Base, unsigned Offset) {
+  if (Offset == 0)
+    return Base;
+  iele::IeleLocalVariable *Address =
+    iele::IeleLocalVariable::Create(&Context, "slot.address", CompilingFunction);
+  iele::IeleInstruction::CreateBinOp(
+    iele::IeleInstruction::Add, Address, Base,
+    iele::IeleIntConstant::Create(&Context, bigint(Offset)),
+    CurrentLoc, CompilingBlock);
+  return Address;
+}
+
 void IeleCompiler::appendIeleRuntimeFill(
      iele::IeleValue *To, iele::IeleValue *NumSlots, iele::IeleValue *Value,
      DataLocation Loc) {
+  if (std::optional<unsigned> Count = getInlineSlotCount(NumSlots)) {
+    for (unsigned i = 0; i < *Count; ++i) {
+      iele::IeleValue *Address = appendSlotAddress(To, i);
+      if (Loc == DataLocation::Storage)
+        iele::IeleInstruction::CreateSStore(
+          Value, Address, CurrentLoc, CompilingBlock);
+      else
+        iele::IeleInstruction::CreateStore(
+          Value, Address, CurrentLoc, CompilingBlock);
+    }
+    return;
+  }
+
   std::string name;
   switch(Loc) {
   case DataLocation::Storage:
@@ -8250,7 +8867,6 @@ iele::IeleLocalVariable *IeleCompiler::appendIeleRuntimeAllocateStorage(
 void IeleCompiler::appendIeleRuntimeCopy(
     iele::IeleValue *From, iele::IeleValue *To, iele::IeleValue *NumSlots,
     DataLocation FromLoc, DataLocation ToLoc) {
-  CompilingContract->setIncludeMemoryRuntime(true);
   std::string name;
   if (FromLoc == DataLocation::Storage && ToLoc == DataLocation::Storage) {
     name = "ielert.storage.copy.to.storage";
@@ -8263,7 +8879,31 @@ void IeleCompiler::appendIeleRuntimeCopy(
   } else {
     solAssert(false, "Not implemented in IELE");
   }
-  
+
+  if (std::optional<unsigned> Count = getInlineSlotCount(NumSlots)) {
+    for (unsigned i = 0; i < *Count; ++i) {
+      iele::IeleLocalVariable *Data =
+        iele::IeleLocalVariable::Create(&Context, "copy.data", CompilingFunction);
+      iele::IeleValue *FromAddress = appendSlotAddress(From, i);
+      if (FromLoc == DataLocation::Storage)
+        iele::IeleInstruction::CreateSLoad(
+          Data, FromAddress, CurrentLoc, CompilingBlock);
+      else
+        iele::IeleInstruction::CreateLoad(
+          Data, FromAddress, CurrentLoc, CompilingBlock);
+      iele::IeleValue *ToAddress = appendSlotAddress(To, i);
+      if (ToLoc == DataLocation::Storage)
+        iele::IeleInstruction::CreateSStore(
+          Data, ToAddress, CurrentLoc, CompilingBlock);
+      else
+        iele::IeleInstruction::CreateStore(
+          Data, ToAddress, CurrentLoc, CompilingBlock);
+    }
+    return;
+  }
+
+  CompilingContract->setIncludeMemoryRuntime(true);
+
   iele::IeleGlobalVariable *Callee =
     iele::IeleGlobalVariable::Create(&Context, name);
   llvm::SmallVector<iele::IeleLocalVariable *, 0> EmptyResults;
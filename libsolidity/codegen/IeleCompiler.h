@@ -2,14 +2,18 @@
 
 #include "libiele/IeleContext.h"
 #include "libiele/IeleContract.h"
+#include "libiele/IelePassManager.h"
 #include "libsolidity/ast/ASTVisitor.h"
 #include "libevmasm/LinkerObject.h"
 
 #include "libsolidity/codegen/IeleRValue.h"
+#include "libsolidity/interface/OptimiserSettings.h"
 
 #include "llvm/Support/raw_ostream.h"
 
 #include <map>
+#include <optional>
+#include <set>
 
 namespace solidity {
 namespace iele {
@@ -72,7 +76,8 @@ public:
   }
 
   evmasm::LinkerObject assembledObject() const {
-    bytes bytecode = CompiledContract->toBinary();
+    bytes bytecode =
+      CompiledContract->toBinary(AssemblerCrossCheck, AssemblyCache);
     return {bytecode,
             std::map<size_t, std::string>(),
             std::map<u256, std::pair<std::string, std::vector<size_t>>>()};
@@ -98,6 +103,46 @@ public:
     return ExperimentalFeatures.count(feature);
   }
 
+  // Enables checking the bytecode produced by the in-process IELE assembler
+  // against the output of the external kiele assembler.
+  void setAssemblerCrossCheck(bool crossCheck) {
+    AssemblerCrossCheck = crossCheck;
+  }
+
+  // Sets the cache consulted for assembled bytecode, or nullptr for none.
+  void setAssemblyCache(iele::IeleAssemblyCache *cache) {
+    AssemblyCache = cache;
+  }
+
+  // Sets the optimizations applied to the generated IELE IR.
+  void setOptimiserSettings(const OptimiserSettings &settings) {
+    Optimiser = settings;
+  }
+
+  // Enables measuring the change in bytecode size caused by each pass.
+  void setMeasurePassCodeSizes(bool measure) {
+    MeasurePassCodeSizes = measure;
+  }
+
+  // Returns the statistics of the passes run on the compiled contract.
+  const std::vector<iele::IelePassManager::PassStatistics> &
+  passStatistics() const {
+    return PassManager->getStatistics();
+  }
+
+  // Prints a report with the statistics of the passes run on the compiled
+  // contract.
+  std::string passStatisticsString() const {
+    std::string ret;
+    llvm::raw_string_ostream OS(ret);
+    PassManager->printStatistics(OS);
+    return OS.str();
+  }
+
+  // Returns the static gas estimates of the compiled contract: the cost of
+  // its creation and the bounds for each of its public and internal functions.
+  Json::Value gasEstimates() const;
+
   // Visitor interface.
   virtual bool visit(const FunctionDefinition &function) override;
   virtual bool visit(const Block &block) override;
@@ -195,6 +240,11 @@ private:
   std::string getIeleNameForLocalVariable(const VariableDeclaration *localVariable);
 
   std::set<ExperimentalFeature> ExperimentalFeatures;
+  bool AssemblerCrossCheck = false;
+  iele::IeleAssemblyCache *AssemblyCache = nullptr;
+  OptimiserSettings Optimiser = OptimiserSettings::minimal();
+  bool MeasurePassCodeSizes = false;
+  std::optional<iele::IelePassManager> PassManager;
 
   // Fills in the ctorAuxParams data structure i.e. for each constructor in the 
   // class hierarchy, it computes the needed extra parameters and the additional
@@ -213,10 +263,46 @@ private:
   const ModifierDefinition *functionModifier(const std::string &_name) const;
   void appendReturn(const FunctionDefinition &function, 
                     llvm::SmallVector<TypePointer, 4> ReturnParameterTypes); 
+  // Returns the modifier invoked by modifierInvocation on function, or nullptr
+  // if the invocation is a call to a base constructor.
+  const ModifierDefinition *resolveModifier(
+      const FunctionDefinition &function,
+      const ModifierInvocation &modifierInvocation) const;
   // Appends one layer of function modifier code of the current function, or the
   // function body itself if the last modifier was reached.
   void appendModifierOrFunctionCode();
   unsigned ModifierDepth;
+
+  // A modifier compiled into shared internal functions: Entry runs the code
+  // before the placeholder and returns the modifier's parameters and local
+  // variables, which Exit takes to run the code after the placeholder. Either
+  // one is nullptr if there is no code on its side of the placeholder.
+  struct OutlinedModifier {
+    iele::IeleFunction *Entry;
+    iele::IeleFunction *Exit;
+  };
+  std::map<const ModifierDefinition *, OutlinedModifier> OutlinedModifiers;
+  // Estimates for the cost model of outlining modifiers: the bytes taken by
+  // an instruction and by a call with its operands, the deposit paid per byte
+  // on deployment, and the gas a call to an outlined part costs on every
+  // execution on top of running the code inline.
+  static constexpr unsigned OutlinedModifierInstructionBytes = 4;
+  static constexpr unsigned OutlinedModifierCallBytes = 8;
+  static constexpr unsigned OutlinedModifierByteGas = 200;
+  static constexpr unsigned OutlinedModifierCallGas = 40;
+  // Returns true if the body of modifier runs its placeholder exactly once
+  // and always falls through to it, so that it can be split into the code
+  // before and after the placeholder.
+  bool canOutlineModifier(const ModifierDefinition &modifier) const;
+  // Outlines the modifiers used by the functions of the compiling contract
+  // for which the instructions saved outweigh the cost of the added calls,
+  // given the expected number of executions per deployment.
+  void outlineModifiers();
+  iele::IeleFunction *appendOutlinedModifierPart(
+      const ModifierDefinition &modifier, const std::string &Name,
+      std::vector<ASTPointer<Statement>>::const_iterator Begin,
+      std::vector<ASTPointer<Statement>>::const_iterator End,
+      bool InitializeLocals, bool ReturnFrame);
   // Maps each level of modifiers with a return target
   std::stack<iele::IeleBlock *> ReturnBlocks;  
   // Return parameters of the current function 
@@ -231,6 +317,14 @@ private:
       const std::vector<ASTPointer<ExpressionClass>> &arguments,
       const FunctionType &function, bool encode);
 
+  // Number of memory cells handed out by appendSpillSlot so far, and the
+  // functions using them.
+  unsigned NextSpillSlot = 0;
+  std::set<const iele::IeleFunction *> SpillSlotUsers;
+  // Internal functions through which no pointer to memory allocated during a
+  // call can outlive the call.
+  std::set<const iele::IeleFunction *> ScratchMemoryFunctions;
+
   // Infrastructure for unique variable names generation and mapping
   int NextUniqueIntToken = 0;
   int getNextUniqueIntToken();
@@ -308,18 +402,21 @@ private:
   iele::IeleValue *appendCopyFromStorageToMemory(
     TypePointer ToType, IeleRValue *From, TypePointer FromType);
 
-  void appendByteArrayCopyLoop(
+  // Copies SizeValue bytes of the byte array From, starting at IndexFrom, to
+  // the byte array To, starting at IndexTo. Neither may be in storage.
+  void appendByteArrayCopy(
       IeleLValue *To, IeleRValue *From,
       DataLocation ToLoc, DataLocation FromLoc,
-      iele::IeleLocalVariable *SizeVariableFrom,
-      iele::IeleLocalVariable *IndexTo, iele::IeleLocalVariable *IndexFrom);
+      iele::IeleValue *SizeValue,
+      iele::IeleValue *IndexTo, iele::IeleValue *IndexFrom);
 
   void appendArrayCopyLoop(
       IeleLValue *To, const ArrayType &toArrayType,
       IeleRValue *From, const ArrayType &arrayType,
       DataLocation ToLoc, DataLocation FromLoc,
       iele::IeleLocalVariable *SizeVariableTo, iele::IeleLocalVariable *SizeVariableFrom,
-      iele::IeleLocalVariable *ElementTo, iele::IeleLocalVariable *ElementFrom);
+      iele::IeleLocalVariable *ElementTo, iele::IeleLocalVariable *ElementFrom,
+      bool ToIsFresh);
 
   void appendCopy(
       IeleLValue *To, TypePointer ToType, IeleRValue *From,
@@ -398,6 +495,26 @@ private:
     TypePointer Type);
 
   iele::IeleLocalVariable *appendMemorySpill();
+  // Returns a register holding the address of a memory cell reserved for the
+  // spill at the current code location. The cell is reused every time this
+  // code runs, so it may only be used for values that are consumed before the
+  // code can run again, and whose encoding either overwrites the whole cell or
+  // always has the same size.
+  iele::IeleLocalVariable *appendSpillSlot();
+  // Reserves the memory cells handed out by appendSpillSlot at the entry of
+  // every function that can be called from outside the contract and may reach
+  // a function using them.
+  void reserveSpillSlots();
+  // Returns true if a pointer to memory allocated during a call to function
+  // can outlive the call, i.e. if it can be returned or stored into memory
+  // that is reachable from the arguments.
+  static bool mayRetainMemory(const FunctionDefinition &function);
+  // Makes the functions in ScratchMemoryFunctions that may allocate memory
+  // and are called inside a loop, directly or through other functions,
+  // release it when they return, using the mark/reset primitives of the
+  // memory runtime.
+  void releaseScratchMemory();
+  static bool hasFixedEncodingSize(const TypePointers &types);
 
   bool shouldCopyStorageToStorage(const Type &ToType, const IeleLValue *To, const Type &From) const;
   bool shouldCopyMemoryToStorage(const Type &ToType, const IeleLValue *To, const Type &FromType) const;
@@ -417,14 +534,27 @@ private:
   // of the compiling contract.
   iele::IeleLocalVariable *appendIeleRuntimeAllocateMemory(
       iele::IeleValue *NumSlots);
+  // The memory runtime only hands out cells that are zero: it allocates fresh
+  // cells, and clears the cells it releases on reset. So freshly allocated
+  // memory is not cleared again. This must be set to false if the allocator
+  // ever starts recycling memory without clearing it.
+  static constexpr bool AllocatedMemoryIsZero = true;
   iele::IeleLocalVariable *appendIeleRuntimeAllocateStorage(
       iele::IeleValue *NumSlots);
+  // Fills and copies of a constant number of slots no larger than the
+  // threshold in the optimiser settings are emitted as straight-line code
+  // instead of calls to the runtime loops.
   void appendIeleRuntimeFill(
       iele::IeleValue *To, iele::IeleValue *NumSlots, iele::IeleValue *Value,
       DataLocation Loc);
   void appendIeleRuntimeCopy(
       iele::IeleValue *From, iele::IeleValue *To, iele::IeleValue *NumSlots,
       DataLocation FromLoc, DataLocation ToLoc);
+  // Returns NumSlots if it is a constant small enough to be filled or copied
+  // with straight-line code.
+  std::optional<unsigned> getInlineSlotCount(iele::IeleValue *NumSlots) const;
+  // Returns the address of the slot at Offset from Base.
+  iele::IeleValue *appendSlotAddress(iele::IeleValue *Base, unsigned Offset);
   
   // Encoding functionality
   IeleRValue *encoding(
@@ -436,6 +566,16 @@ private:
     TypePointers types,
     iele::IeleLocalVariable *NextFree,
     bool appendWidths);
+  // Returns true if all types are encoded as integers of a fixed width, so
+  // that the offset of every value in their encoding is known at compile time.
+  static bool hasFixedWidthLayout(const TypePointers &types);
+  // Encodes values of such types with a single store of a constant width,
+  // and returns that width.
+  iele::IeleValue *appendFixedWidthEncoding(
+    llvm::SmallVectorImpl<IeleRValue *> &arguments,
+    const TypePointers &types,
+    iele::IeleLocalVariable *NextFree,
+    bool bigEndian);
 
   IeleRValue *decoding(
     IeleRValue *encoded,
@@ -478,9 +618,9 @@ private:
 
   void appendByteWidth(iele::IeleLocalVariable *Result, iele::IeleValue *Value);
 
-  // Helper function that desugars constant operands from all iele instructions except
-  // assignment.
-  void desugarConstantOperands();
+  // Runs the IELE pass pipeline selected by the optimiser settings on the
+  // compiling contract, followed by the passes required for every contract.
+  void runPasses();
 };
 
 } // end namespace frontend
@@ -230,6 +230,9 @@ void CompilerStack::reset(bool _keepSettings)
 		m_enabledSMTSolvers = smtutil::SMTSolverChoice::All();
 		m_generateIR = false;
 		m_generateEwasm = false;
+		m_ieleAssemblerCrossCheck = false;
+		m_ielePassCodeSizes = false;
+		m_ieleAssemblyCache.reset();
 		m_revertStrings = RevertStrings::Default;
 		m_optimiserSettings = OptimiserSettings::minimal();
 		m_metadataLiteralSources = false;
@@ -782,6 +785,19 @@ evmasm::LinkerObject const& CompilerStack::object(string const& _contractName) c
 
 	return contract(_contractName).object;
 }
+
+shared_ptr<iele::IeleContract const> CompilerStack::ieleContract(string const& _contractName) const
+{
+	if (m_stackState != CompilationSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+
+	shared_ptr<IeleCompiler> const& compiler = contract(_contractName).compiler;
+	if (!compiler)
+		return nullptr;
+	// The IR is owned by its compiler, which also keeps the compilers of the
+	// contracts it creates alive.
+	return shared_ptr<iele::IeleContract const>(compiler, &compiler->assembly());
+}
 /*
 evmasm::LinkerObject const& CompilerStack::runtimeObject(string const& _contractName) const
 {
@@ -804,6 +820,18 @@ string CompilerStack::assemblyString(string const& _contractName, StringMap _sou
 		return string();
 }
 
+string CompilerStack::ielePassStatistics(string const& _contractName) const
+{
+	if (m_stackState != CompilationSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+
+	Contract const& currentContract = contract(_contractName);
+	if (currentContract.compiler)
+		return currentContract.compiler->passStatisticsString();
+	else
+		return string();
+}
+
 /// TODO: cache the JSON
 Json::Value CompilerStack::assemblyJSON(string const& _contractName, StringMap _sourceCodes) const
 {
@@ -1195,6 +1223,10 @@ void CompilerStack::compileContract(
 
 	shared_ptr<IeleCompiler> compiler = make_shared<IeleCompiler>();
 	compiler->setExperimentalFeatures(_contract.sourceUnit().annotation().experimentalFeatures);
+	compiler->setAssemblerCrossCheck(m_ieleAssemblerCrossCheck);
+	compiler->setAssemblyCache(m_ieleAssemblyCache.get());
+	compiler->setOptimiserSettings(m_optimiserSettings);
+	compiler->setMeasurePassCodeSizes(m_ielePassCodeSizes);
 	compiledContract.compiler = compiler;
 
 	bytes cborEncodedMetadata = createCBORMetadata(compiledContract);
@@ -1453,6 +1485,14 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 			details["yulDetails"]["stackAllocation"] = m_optimiserSettings.optimizeStackAllocation;
 			details["yulDetails"]["optimizerSteps"] = m_optimiserSettings.yulOptimiserSteps;
 		}
+		details["iele"] = m_optimiserSettings.runIeleOptimiser;
+		if (m_optimiserSettings.runIeleOptimiser)
+		{
+			details["ieleDetails"] = Json::objectValue;
+			details["ieleDetails"]["passes"] = m_optimiserSettings.ielePasses;
+			details["ieleDetails"]["inlineCopySlots"] = Json::UInt64(m_optimiserSettings.ieleInlineCopySlots);
+			details["ieleDetails"]["inlineThreshold"] = Json::UInt64(m_optimiserSettings.ieleInlineThreshold);
+		}
 
 		meta["settings"]["optimizer"]["details"] = std::move(details);
 	}
@@ -1598,94 +1638,15 @@ bytes CompilerStack::createCBORMetadata(Contract const& _contract) const
 		encoder.pushString("solc", VersionStringStrict);
 	return encoder.serialise();
 }
-/*
-namespace
-{
-
-Json::Value gasToJson(GasEstimator::GasConsumption const& _gas)
-{
-	if (_gas.isInfinite)
-		return Json::Value("infinite");
-	else
-		return Json::Value(util::toString(_gas.value));
-}
-
-}
 
 Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 {
 	if (m_stackState != CompilationSuccessful)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
-	if (!assemblyItems(_contractName) && !runtimeAssemblyItems(_contractName))
+	Contract const& currentContract = contract(_contractName);
+	if (currentContract.compiler)
+		return currentContract.compiler->gasEstimates();
+	else
 		return Json::Value();
-
-	using Gas = GasEstimator::GasConsumption;
-	GasEstimator gasEstimator(m_evmVersion);
-	Json::Value output(Json::objectValue);
-
-	if (evmasm::AssemblyItems const* items = assemblyItems(_contractName))
-	{
-		Gas executionGas = gasEstimator.functionalEstimation(*items);
-		Gas codeDepositGas{evmasm::GasMeter::dataGas(runtimeObject(_contractName).bytecode, false, m_evmVersion)};
-
-		Json::Value creation(Json::objectValue);
-		creation["codeDepositCost"] = gasToJson(codeDepositGas);
-		creation["executionCost"] = gasToJson(executionGas);
-		/// TODO: implement + overload to avoid the need of +=
-		executionGas += codeDepositGas;
-		creation["totalCost"] = gasToJson(executionGas);
-		output["creation"] = creation;
-	}
-
-	if (evmasm::AssemblyItems const* items = runtimeAssemblyItems(_contractName))
-	{
-		/// External functions
-		ContractDefinition const& contract = contractDefinition(_contractName);
-		Json::Value externalFunctions(Json::objectValue);
-		for (auto it: contract.interfaceFunctions())
-		{
-			string sig = it.second->externalSignature();
-			externalFunctions[sig] = gasToJson(gasEstimator.functionalEstimation(*items, sig));
-		}
-
-		if (contract.fallbackFunction())
-			/// This needs to be set to an invalid signature in order to trigger the fallback,
-			/// without the shortcut (of CALLDATSIZE == 0), and therefore to receive the upper bound.
-			/// An empty string ("") would work to trigger the shortcut only.
-			externalFunctions[""] = gasToJson(gasEstimator.functionalEstimation(*items, "INVALID"));
-
-		if (!externalFunctions.empty())
-			output["external"] = externalFunctions;
-
-		/// Internal functions
-		Json::Value internalFunctions(Json::objectValue);
-		for (auto const& it: contract.definedFunctions())
-		{
-			/// Exclude externally visible functions, constructor, fallback and receive ether function
-			if (it->isPartOfExternalInterface() || !it->isOrdinary())
-				continue;
-
-			size_t entry = functionEntryPoint(_contractName, *it);
-			GasEstimator::GasConsumption gas = GasEstimator::GasConsumption::infinite();
-			if (entry > 0)
-				gas = gasEstimator.functionalEstimation(*items, entry, *it);
-
-			/// TODO: This could move into a method shared with externalSignature()
-			FunctionType type(*it);
-			string sig = it->name() + "(";
-			auto paramTypes = type.parameterTypes();
-			for (auto it = paramTypes.begin(); it != paramTypes.end(); ++it)
-				sig += (*it)->toString() + (it + 1 == paramTypes.end() ? "" : ",");
-			sig += ")";
-
-			internalFunctions[sig] = gasToJson(gas);
-		}
-
-		if (!internalFunctions.empty())
-			output["internal"] = internalFunctions;
-	}
-
-	return output;
 }
-*/
@@ -68,6 +68,7 @@ using AssemblyItems = std::vector<AssemblyItem>;
 
 namespace solidity::iele
 {
+class IeleAssemblyCache;
 class IeleContract;
 }
 
@@ -192,6 +193,21 @@ public:
 		m_requestedContractNames = _contractNames;
 	}
 
+	/// Enable comparing the output of the in-process IELE assembler against
+	/// the external kiele assembler. Requires kiele to be in the PATH.
+	void enableIeleAssemblerCrossCheck(bool _enable = true) { m_ieleAssemblerCrossCheck = _enable; }
+
+	/// Enable measuring the change in bytecode size caused by each IELE pass, which is then
+	/// included in ielePassStatistics. This assembles each contract once per pass.
+	void enableIelePassCodeSizes(bool _enable = true) { m_ielePassCodeSizes = _enable; }
+
+	/// Sets the persistent cache consulted for assembled IELE bytecode.
+	/// A null pointer disables caching, which is the default.
+	void setIeleAssemblyCache(std::shared_ptr<iele::IeleAssemblyCache> _cache) { m_ieleAssemblyCache = std::move(_cache); }
+
+	/// @returns the cache of assembled IELE bytecode, if any.
+	std::shared_ptr<iele::IeleAssemblyCache> ieleAssemblyCache() const { return m_ieleAssemblyCache; }
+
 	/// Enable EVM Bytecode generation. This is enabled by default.
 	void enableEvmBytecodeGeneration(bool _enable = true) { m_generateEvmBytecode = _enable; }
 
@@ -283,6 +299,10 @@ public:
 
 	/// @returns the assembled object for a contract.
 	evmasm::LinkerObject const& object(std::string const& _contractName) const;
+
+	/// @returns the IELE IR of a contract, or nullptr if it has no code. The IR stays
+	/// valid after the compiler stack is reset.
+	std::shared_ptr<iele::IeleContract const> ieleContract(std::string const& _contractName) const;
 /*
 	/// @returns the runtime object for the contract.
 	evmasm::LinkerObject const& runtimeObject(std::string const& _contractName) const;
@@ -309,6 +329,10 @@ public:
 	/// @arg _sourceCodes is the map of input files to source code strings
 	/// Prerequisite: Successful compilation.
 	std::string assemblyString(std::string const& _contractName, StringMap _sourceCodes = StringMap()) const;
+	/// @returns a report of the wall time spent in each IELE pass run on the contract and
+	/// of the change of its instruction count.
+	/// Prerequisite: Successful compilation.
+	std::string ielePassStatistics(std::string const& _contractName) const;
 	/// @returns a JSON representation of the assembly.
 	/// @arg _sourceCodes is the map of input files to source code strings
 	/// Prerequisite: Successful compilation.
@@ -337,10 +361,10 @@ public:
 
 	/// @returns the cbor-encoded metadata.
 	bytes cborMetadata(std::string const& _contractName) const;
-/*
+
 	/// @returns a JSON representing the estimated gas usage for contract creation, internal and external functions
 	Json::Value gasEstimates(std::string const& _contractName) const;
-*/
+
 	/// Overwrites the release/prerelease flag. Should only be used for testing.
 	void overwriteReleaseFlag(bool release) { m_release = release; }
 
@@ -479,6 +503,9 @@ private:
 	bool m_generateEvmBytecode = true;
 	bool m_generateIR = false;
 	bool m_generateEwasm = false;
+	bool m_ieleAssemblerCrossCheck = false;
+	bool m_ielePassCodeSizes = false;
+	std::shared_ptr<iele::IeleAssemblyCache> m_ieleAssemblyCache;
 	std::map<std::string, util::h160> m_libraries;
 	/// list of path prefix remappings, e.g. mylibrary: github.com/ethereum = /usr/local/ethereum
 	/// "context:prefix=target"
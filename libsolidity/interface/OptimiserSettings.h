@@ -49,6 +49,15 @@ struct OptimiserSettings
 		"]"
 		"jmuljuljul VcTOcul jmul";     // Make source short and pretty
 
+	/// Pipeline of passes run on the IELE IR of every contract, see IelePassManager.
+	static char constexpr DefaultIelePasses[] = "[cvsepdil]r";
+	/// Largest constant number of slots the IELE code generator copies or fills with
+	/// straight-line code instead of a call to a runtime loop.
+	static size_t constexpr DefaultIeleInlineCopySlots = 4;
+	/// Largest number of instructions of an internal function that the IELE optimiser inlines
+	/// at every call site.
+	static size_t constexpr DefaultIeleInlineThreshold = 8;
+
 	/// No optimisations at all - not recommended.
 	static OptimiserSettings none()
 	{
@@ -73,6 +82,7 @@ struct OptimiserSettings
 		s.runCSE = true;
 		s.runConstantOptimiser = true;
 		s.runYulOptimiser = true;
+		s.runIeleOptimiser = true;
 		s.optimizeStackAllocation = true;
 		s.expectedExecutionsPerDeployment = 200;
 		return s;
@@ -95,6 +105,10 @@ struct OptimiserSettings
 			optimizeStackAllocation == _other.optimizeStackAllocation &&
 			runYulOptimiser == _other.runYulOptimiser &&
 			yulOptimiserSteps == _other.yulOptimiserSteps &&
+			runIeleOptimiser == _other.runIeleOptimiser &&
+			ielePasses == _other.ielePasses &&
+			ieleInlineCopySlots == _other.ieleInlineCopySlots &&
+			ieleInlineThreshold == _other.ieleInlineThreshold &&
 			expectedExecutionsPerDeployment == _other.expectedExecutionsPerDeployment;
 	}
 
@@ -121,6 +135,16 @@ struct OptimiserSettings
 	/// them just by setting this to an empty string. Set @a runYulOptimiser to false if you want
 	/// no optimisations.
 	std::string yulOptimiserSteps = DefaultYulOptimiserSteps;
+	/// Optimiser for the IELE IR generated from Solidity.
+	bool runIeleOptimiser = false;
+	/// Sequence of IELE IR passes to be performed by the IELE optimiser.
+	std::string ielePasses = DefaultIelePasses;
+	/// Copies and fills of at most this many slots are emitted as straight-line code by the
+	/// IELE code generator, if the IELE optimiser is enabled.
+	size_t ieleInlineCopySlots = DefaultIeleInlineCopySlots;
+	/// Internal functions with at most this many IELE instructions are inlined at every call
+	/// site by the IELE optimiser. Functions called only once are inlined regardless of size.
+	size_t ieleInlineThreshold = DefaultIeleInlineThreshold;
 	/// This specifies an estimate on how often each opcode in this assembly will be executed,
 	/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 	size_t expectedExecutionsPerDeployment = 200;
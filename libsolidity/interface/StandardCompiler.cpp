@@ -33,6 +33,8 @@
 #include <libsolutil/JSON.h>
 #include <libsolutil/Keccak256.h>
 #include <libsolutil/CommonData.h>
+#include <libiele/IeleAssemblyCache.h>
+#include <libiele/IelePassManager.h>
 
 #include <boost/algorithm/string/predicate.hpp>
 
@@ -428,10 +430,16 @@ std::optional<Json::Value> checkAuxiliaryInputKeys(Json::Value const& _input)
 
 std::optional<Json::Value> checkSettingsKeys(Json::Value const& _input)
 {
-	static set<string> keys{"parserErrorRecovery", "debug", "evmVersion", "libraries", "metadata", "modelChecker", "optimizer", "outputSelection", "remappings", "stopAfter", "viaIR"};
+	static set<string> keys{"parserErrorRecovery", "debug", "evmVersion", "ieleAssemblyCache", "libraries", "metadata", "modelChecker", "optimizer", "outputSelection", "remappings", "stopAfter", "viaIR"};
 	return checkKeys(_input, keys, "settings");
 }
 
+std::optional<Json::Value> checkIeleAssemblyCacheKeys(Json::Value const& _input)
+{
+	static set<string> keys{"directory", "maxSize"};
+	return checkKeys(_input, keys, "settings.ieleAssemblyCache");
+}
+
 std::optional<Json::Value> checkModelCheckerSettingsKeys(Json::Value const& _input)
 {
 	static set<string> keys{"engine", "timeout"};
@@ -446,7 +454,7 @@ std::optional<Json::Value> checkOptimizerKeys(Json::Value const& _input)
 
 std::optional<Json::Value> checkOptimizerDetailsKeys(Json::Value const& _input)
 {
-	static set<string> keys{"peephole", "jumpdestRemover", "orderLiterals", "deduplicate", "cse", "constantOptimizer", "yul", "yulDetails"};
+	static set<string> keys{"peephole", "jumpdestRemover", "orderLiterals", "deduplicate", "cse", "constantOptimizer", "yul", "yulDetails", "iele", "ieleDetails"};
 	return checkKeys(_input, keys, "settings.optimizer.details");
 }
 
@@ -488,6 +496,32 @@ std::optional<Json::Value> checkOptimizerDetailSteps(Json::Value const& _details
 	return {};
 }
 
+std::optional<Json::Value> checkOptimizerDetailPasses(Json::Value const& _details, std::string const& _name, string& _setting)
+{
+	if (_details.isMember(_name))
+	{
+		if (_details[_name].isString())
+		{
+			try
+			{
+				iele::IelePassManager::validatePipeline(_details[_name].asString());
+			}
+			catch (iele::IelePipelineError const& _exception)
+			{
+				return formatFatalError(
+					"JSONError",
+					"Invalid pass sequence in \"settings.optimizer.details.ieleDetails." + _name + "\": " + _exception.what()
+				);
+			}
+
+			_setting = _details[_name].asString();
+		}
+		else
+			return formatFatalError("JSONError", "\"settings.optimizer.details.ieleDetails." + _name + "\" must be a string");
+	}
+	return {};
+}
+
 std::optional<Json::Value> checkMetadataKeys(Json::Value const& _input)
 {
 	if (_input.isObject())
@@ -605,6 +639,30 @@ std::variant<OptimiserSettings, Json::Value> parseOptimizerSettings(Json::Value
 			if (auto error = checkOptimizerDetailSteps(details["yulDetails"], "optimizerSteps", settings.yulOptimiserSteps))
 				return *error;
 		}
+		if (auto error = checkOptimizerDetail(details, "iele", settings.runIeleOptimiser))
+			return *error;
+		if (details.isMember("ieleDetails"))
+		{
+			if (!settings.runIeleOptimiser)
+				return formatFatalError("JSONError", "\"Providing ieleDetails requires IELE optimizer to be enabled.");
+
+			if (auto result = checkKeys(details["ieleDetails"], {"passes", "inlineCopySlots", "inlineThreshold"}, "settings.optimizer.details.ieleDetails"))
+				return *result;
+			if (auto error = checkOptimizerDetailPasses(details["ieleDetails"], "passes", settings.ielePasses))
+				return *error;
+			if (details["ieleDetails"].isMember("inlineCopySlots"))
+			{
+				if (!details["ieleDetails"]["inlineCopySlots"].isUInt())
+					return formatFatalError("JSONError", "\"settings.optimizer.details.ieleDetails.inlineCopySlots\" must be an unsigned number");
+				settings.ieleInlineCopySlots = details["ieleDetails"]["inlineCopySlots"].asUInt();
+			}
+			if (details["ieleDetails"].isMember("inlineThreshold"))
+			{
+				if (!details["ieleDetails"]["inlineThreshold"].isUInt())
+					return formatFatalError("JSONError", "\"settings.optimizer.details.ieleDetails.inlineThreshold\" must be an unsigned number");
+				settings.ieleInlineThreshold = details["ieleDetails"]["inlineThreshold"].asUInt();
+			}
+		}
 	}
 	return { std::move(settings) };
 }
@@ -915,6 +973,28 @@ std::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompiler:
 		ret.modelCheckerSettings.timeout = modelCheckerSettings["timeout"].asUInt();
 	}
 
+	Json::Value const& ieleAssemblyCacheSettings = settings.get("ieleAssemblyCache", Json::Value());
+
+	if (auto result = checkIeleAssemblyCacheKeys(ieleAssemblyCacheSettings))
+		return *result;
+
+	if (ieleAssemblyCacheSettings.isMember("directory"))
+	{
+		if (!ieleAssemblyCacheSettings["directory"].isString())
+			return formatFatalError("JSONError", "settings.ieleAssemblyCache.directory must be a string.");
+		ret.ieleAssemblyCacheDirectory = ieleAssemblyCacheSettings["directory"].asString();
+	}
+
+	ret.ieleAssemblyCacheMaxSize = iele::IeleAssemblyCache::DefaultMaxSize;
+	if (ieleAssemblyCacheSettings.isMember("maxSize"))
+	{
+		if (!ieleAssemblyCacheSettings["maxSize"].isUInt64())
+			return formatFatalError("JSONError", "settings.ieleAssemblyCache.maxSize must be an unsigned integer.");
+		if (!ret.ieleAssemblyCacheDirectory)
+			return formatFatalError("JSONError", "settings.ieleAssemblyCache.maxSize requires settings.ieleAssemblyCache.directory.");
+		ret.ieleAssemblyCacheMaxSize = ieleAssemblyCacheSettings["maxSize"].asUInt64();
+	}
+
 	return { std::move(ret) };
 }
 
@@ -937,6 +1017,11 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 	compilerStack.setMetadataHash(_inputsAndSettings.metadataHash);
 	compilerStack.setRequestedContractNames(requestedContractNames(_inputsAndSettings.outputSelection));
 	compilerStack.setModelCheckerSettings(_inputsAndSettings.modelCheckerSettings);
+	if (_inputsAndSettings.ieleAssemblyCacheDirectory)
+		compilerStack.setIeleAssemblyCache(make_shared<iele::IeleAssemblyCache>(
+			*_inputsAndSettings.ieleAssemblyCacheDirectory,
+			_inputsAndSettings.ieleAssemblyCacheMaxSize
+		));
 
 	compilerStack.enableEvmBytecodeGeneration(isEvmBytecodeRequested(_inputsAndSettings.outputSelection));
 	compilerStack.enableIRGeneration(isIRRequested(_inputsAndSettings.outputSelection));
@@ -1145,10 +1230,8 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 */
 		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.methodIdentifiers", wildcardMatchesExperimental))
 			evmData["methodIdentifiers"] = compilerStack.methodIdentifiers(contractName);
-/*
 		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.gasEstimates", wildcardMatchesExperimental))
 			evmData["gasEstimates"] = compilerStack.gasEstimates(contractName);
-*/
 
 		if (compilationSuccess && isArtifactRequested(
 			_inputsAndSettings.outputSelection,
@@ -1207,6 +1290,15 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 	if (!contractsOutput.empty())
 		output["contracts"] = contractsOutput;
 
+	if (auto cache = compilerStack.ieleAssemblyCache())
+	{
+		Json::Value cacheStatistics = Json::objectValue;
+		cacheStatistics["hits"] = cache->hits();
+		cacheStatistics["misses"] = cache->misses();
+		cacheStatistics["evictions"] = cache->evictions();
+		output["ieleAssemblyCache"] = cacheStatistics;
+	}
+
 	return output;
 }
 
@@ -73,6 +73,8 @@ private:
 		Json::Value outputSelection;
 		ModelCheckerSettings modelCheckerSettings = ModelCheckerSettings{};
 		bool viaIR = false;
+		std::optional<std::string> ieleAssemblyCacheDirectory;
+		uint64_t ieleAssemblyCacheMaxSize = 0;
 	};
 
 	/// Parses the input json (and potentially invokes the read callback) and either returns
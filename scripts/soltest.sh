@@ -6,6 +6,9 @@ USE_DEBUGGER=0
 DEBUGGER="gdb --args"
 BOOST_OPTIONS=
 SOLTEST_OPTIONS=
+BATCHES=1
+IPC_PATHS=0
+USE_NODES=1
 SOLIDITY_BUILD_DIR=${SOLIDITY_BUILD_DIR:-${REPO_ROOT}/build}
 
 usage() {
@@ -20,6 +23,10 @@ Options:
                            This  option can be given several times.
   --boost-options *x*      Set BOOST option *x*.
   --show-progress | -p     Set BOOST option --show-progress.
+  --batches *n*            Split the tests into n batches and run them concurrently, one
+                           soltest process per batch. Batch i runs against the node of the
+                           i-th --ipcpath, so at least n of them are needed, unless the
+                           tests run with --iele-interpreter or --no-ipc.
 
 Important environment variables:
 
@@ -54,6 +61,19 @@ do
 		--show-progress | -p)
 			BOOST_OPTIONS="${BOOST_OPTIONS} $1"
 			;;
+		--batches)
+			shift
+			BATCHES="$1"
+			;;
+		--ipcpath)
+			SOLTEST_OPTIONS="${SOLTEST_OPTIONS} $1 $2"
+			IPC_PATHS=$((IPC_PATHS + 1))
+			shift
+			;;
+		--iele-interpreter | --no-ipc)
+			SOLTEST_OPTIONS="${SOLTEST_OPTIONS} $1"
+			USE_NODES=0
+			;;
 		*)
 			SOLTEST_OPTIONS="${SOLTEST_OPTIONS} $1"
 			;;
@@ -64,4 +84,35 @@ if [ "$USE_DEBUGGER" -ne "0" ]; then
 	DEBUG_PREFIX=${DEBUGGER}
 fi
 
-exec ${DEBUG_PREFIX} ${SOLIDITY_BUILD_DIR}/test/soltest ${BOOST_OPTIONS} -- --testpath ${REPO_ROOT}/test ${SOLTEST_OPTIONS}
+if [ "$BATCHES" -le 1 ]; then
+	exec ${DEBUG_PREFIX} ${SOLIDITY_BUILD_DIR}/test/soltest ${BOOST_OPTIONS} -- --testpath ${REPO_ROOT}/test ${SOLTEST_OPTIONS}
+fi
+
+if [ "$IPC_PATHS" -eq 0 ] && [ -n "${ETH_TEST_IPC:-}" ]; then
+	IPC_PATHS=1
+fi
+if [ "$USE_NODES" -ne 0 ] && [ "$BATCHES" -gt "$IPC_PATHS" ]; then
+	echo >&2 "Error: --batches $BATCHES needs as many --ipcpath options, one node per batch, unless --iele-interpreter or --no-ipc is used."
+	exit 1
+fi
+
+LOG_DIR="$(mktemp -d)"
+trap 'rm -rf "$LOG_DIR"' EXIT
+PIDS=()
+for (( batch = 0; batch < BATCHES; batch++ ))
+do
+	${SOLIDITY_BUILD_DIR}/test/soltest ${BOOST_OPTIONS} -- --testpath ${REPO_ROOT}/test ${SOLTEST_OPTIONS} \
+		--batches "$BATCHES" --selected-batch "$batch" > "$LOG_DIR/batch$batch.log" 2>&1 &
+	PIDS+=($!)
+done
+
+FAILED=0
+for (( batch = 0; batch < BATCHES; batch++ ))
+do
+	if ! wait "${PIDS[$batch]}"; then
+		FAILED=1
+	fi
+	echo "--- batch $batch of $BATCHES ---"
+	cat "$LOG_DIR/batch$batch.log"
+done
+exit $FAILED
@@ -43,6 +43,9 @@
 #include <libevmasm/Instruction.h>
 #include <libevmasm/GasMeter.h>
 
+#include <libiele/IeleAssemblyCache.h>
+#include <libiele/IelePassManager.h>
+
 #include <liblangutil/Exceptions.h>
 #include <liblangutil/Scanner.h>
 #include <liblangutil/SourceReferenceFormatter.h>
@@ -137,6 +140,12 @@ static string const g_strGeneratedSources = "generated-sources";
 static string const g_strGeneratedSourcesRuntime = "generated-sources-runtime";
 static string const g_strGas = "gas";
 static string const g_strHelp = "help";
+static string const g_strIeleAssemblerCrossCheck = "iele-assembler-crosscheck";
+static string const g_strIeleAssemblyCache = "iele-assembly-cache";
+static string const g_strIeleInlineCopySlots = "iele-inline-copy-slots";
+static string const g_strIeleInlineThreshold = "iele-inline-threshold";
+static string const g_strIeleOptimizations = "iele-optimizations";
+static string const g_strIelePassStatistics = "iele-pass-stats";
 static string const g_strImportAst = "import-ast";
 static string const g_strInputFile = "input-file";
 static string const g_strInterface = "interface";
@@ -211,6 +220,9 @@ static string const g_argCompactJSON = g_strCompactJSON;
 static string const g_argErrorRecovery = g_strErrorRecovery;
 static string const g_argGas = g_strGas;
 static string const g_argHelp = g_strHelp;
+static string const g_argIeleAssemblerCrossCheck = g_strIeleAssemblerCrossCheck;
+static string const g_argIeleAssemblyCache = g_strIeleAssemblyCache;
+static string const g_argIelePassStatistics = g_strIelePassStatistics;
 static string const g_argImportAst = g_strImportAst;
 static string const g_argInputFile = g_strInputFile;
 static string const g_argYul = g_strYul;
@@ -322,6 +334,7 @@ static bool needsHumanTargetedStdout(po::variables_map const& _args)
 		g_argAstJson,
 		g_argBinary,
 		g_argBinaryRuntime,
+		g_argIelePassStatistics,
 		g_argMetadata,
 		g_argMetadataBin,
 		g_argNatspecUser,
@@ -552,20 +565,35 @@ void CommandLineInterface::handleNatspec(bool _natspecDev, string const& _contra
 	}
 }
 
+void CommandLineInterface::handleIelePassStatistics(string const& _contract)
+{
+	if (!m_args.count(g_argIelePassStatistics))
+		return;
+
+	string statistics = m_compiler->ielePassStatistics(_contract);
+	if (m_args.count(g_argOutputDir))
+		createFile(m_compiler->filesystemFriendlyName(_contract) + "_iele_passes.txt", statistics);
+	else
+		sout() << "IELE pass statistics:" << endl << statistics << endl;
+}
+
 void CommandLineInterface::handleGasEstimation(string const& _contract)
 {
-	//TODO: gas estimates
-/*
 	Json::Value estimates = m_compiler->gasEstimates(_contract);
 	sout() << "Gas estimation:" << endl;
 
+	auto bounds = [](Json::Value const& _estimate)
+	{
+		return "min " + _estimate["min"].asString() + ", max " + _estimate["max"].asString();
+	};
+
 	if (estimates["creation"].isObject())
 	{
 		Json::Value creation = estimates["creation"];
 		sout() << "construction:" << endl;
-		sout() << "   " << creation["executionCost"].asString();
-		sout() << " + " << creation["codeDepositCost"].asString();
-		sout() << " = " << creation["totalCost"].asString() << endl;
+		sout() << "   execution:\t" << bounds(creation["executionCost"]) << endl;
+		sout() << "   code deposit:\t" << creation["codeDepositCost"].asString() << endl;
+		sout() << "   total:\t" << bounds(creation["totalCost"]) << endl;
 	}
 
 	if (estimates["external"].isObject())
@@ -573,13 +601,7 @@ void CommandLineInterface::handleGasEstimation(string const& _contract)
 		Json::Value externalFunctions = estimates["external"];
 		sout() << "external:" << endl;
 		for (auto const& name: externalFunctions.getMemberNames())
-		{
-			if (name.empty())
-				sout() << "   fallback:\t";
-			else
-				sout() << "   " << name << ":\t";
-			sout() << externalFunctions[name].asString() << endl;
-		}
+			sout() << "   " << name << ":\t" << bounds(externalFunctions[name]) << endl;
 	}
 
 	if (estimates["internal"].isObject())
@@ -587,12 +609,8 @@ void CommandLineInterface::handleGasEstimation(string const& _contract)
 		Json::Value internalFunctions = estimates["internal"];
 		sout() << "internal:" << endl;
 		for (auto const& name: internalFunctions.getMemberNames())
-		{
-			sout() << "   " << name << ":\t";
-			sout() << internalFunctions[name].asString() << endl;
-		}
+			sout() << "   " << name << ":\t" << bounds(internalFunctions[name]) << endl;
 	}
-*/
 }
 
 bool CommandLineInterface::readInputFilesAndConfigureRemappings()
@@ -872,6 +890,16 @@ General Information)").c_str(),
 			g_strExperimentalViaIR.c_str(),
 			"Turn on experimental compilation mode via the IR (EXPERIMENTAL)."
 		)
+		(
+			g_strIeleAssemblerCrossCheck.c_str(),
+			"Also assemble the generated IELE code with the external kiele assembler and "
+			"fail if its output differs from the built-in assembler. Requires kiele in the PATH."
+		)
+		(
+			g_strIeleAssemblyCache.c_str(),
+			po::value<string>()->value_name("path"),
+			"Reuse IELE bytecode assembled by previous compiler runs, kept in the given directory."
+		)
 		(
 			g_strRevertStrings.c_str(),
 			po::value<string>()->value_name(boost::join(g_revertStringsArgs, ",")),
@@ -991,6 +1019,7 @@ General Information)").c_str(),
 		(g_argMetadata.c_str(), "Combined Metadata JSON whose Swarm hash is stored on-chain.")
 		(g_argMetadataBin.c_str(), "Swarm hash of the Combined Metadata JSON as it is stored on-chain.")
 		(g_argStorageLayout.c_str(), "Slots, offsets and types of the contract's state variables.")
+		(g_argIelePassStatistics.c_str(), "Time spent in, instructions removed and bytes saved by each IELE IR pass.")
 	;
 	desc.add(outputComponents);
 
@@ -998,7 +1027,7 @@ General Information)").c_str(),
 	extraOutput.add_options()
 		(
 			g_argGas.c_str(),
-			"Print an estimate of the maximal gas usage for each function."
+			"Print an estimate of the minimal and maximal gas usage for each function."
 		)
 		(
 			g_argCombinedJson.c_str(),
@@ -1047,6 +1076,23 @@ General Information)").c_str(),
 			po::value<string>()->value_name("steps"),
 			"Forces yul optimizer to use the specified sequence of optimization steps instead of the built-in one."
 		)
+		(
+			g_strIeleOptimizations.c_str(),
+			po::value<string>()->value_name("passes"),
+			"Forces the IELE optimizer to run the specified sequence of passes on the IELE IR instead of the built-in one."
+		)
+		(
+			g_strIeleInlineCopySlots.c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(OptimiserSettings::DefaultIeleInlineCopySlots),
+			"Copy and fill at most this many storage or memory slots with straight-line code instead of a runtime loop "
+			"when the size is known at compile time. Only used if the optimizer is enabled."
+		)
+		(
+			g_strIeleInlineThreshold.c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(OptimiserSettings::DefaultIeleInlineThreshold),
+			"Inline internal functions with at most this many IELE instructions at every call site. "
+			"Functions called only once are always inlined. Only used if the optimizer is enabled."
+		)
 	;
 	desc.add(optimizerOptions);
 
@@ -1099,7 +1145,8 @@ General Information)").c_str(),
 		g_argGas,
 		g_argAsm,
 		g_argAsmJson,
-		g_argOpcodes
+		g_argOpcodes,
+		g_argIelePassStatistics
 	};
 
 	for (auto& option: conflictingWithStopAfter)
@@ -1504,6 +1551,12 @@ bool CommandLineInterface::processInput()
 
 		m_compiler->enableIRGeneration(m_args.count(g_argIR) || m_args.count(g_argIROptimized));
 		m_compiler->enableEwasmGeneration(m_args.count(g_argEwasm));
+		m_compiler->enableIeleAssemblerCrossCheck(m_args.count(g_argIeleAssemblerCrossCheck));
+		m_compiler->enableIelePassCodeSizes(m_args.count(g_argIelePassStatistics));
+		if (m_args.count(g_argIeleAssemblyCache))
+			m_compiler->setIeleAssemblyCache(make_shared<iele::IeleAssemblyCache>(
+				m_args[g_argIeleAssemblyCache].as<string>()
+			));
 
 		OptimiserSettings settings = m_args.count(g_argOptimize) ? OptimiserSettings::standard() : OptimiserSettings::minimal();
 		settings.expectedExecutionsPerDeployment = m_args[g_argOptimizeRuns].as<unsigned>();
@@ -1530,6 +1583,28 @@ bool CommandLineInterface::processInput()
 			settings.yulOptimiserSteps = m_args[g_strYulOptimizations].as<string>();
 		}
 		settings.optimizeStackAllocation = settings.runYulOptimiser;
+		if (m_args.count(g_strIeleOptimizations))
+		{
+			if (!settings.runIeleOptimiser)
+			{
+				serr() << "--" << g_strIeleOptimizations << " is invalid if the optimizer is disabled" << endl;
+				return false;
+			}
+
+			try
+			{
+				iele::IelePassManager::validatePipeline(m_args[g_strIeleOptimizations].as<string>());
+			}
+			catch (iele::IelePipelineError const& _exception)
+			{
+				serr() << "Invalid pass sequence in --" << g_strIeleOptimizations << ": " << _exception.what() << endl;
+				return false;
+			}
+
+			settings.ielePasses = m_args[g_strIeleOptimizations].as<string>();
+		}
+		settings.ieleInlineCopySlots = m_args[g_strIeleInlineCopySlots].as<unsigned>();
+		settings.ieleInlineThreshold = m_args[g_strIeleInlineThreshold].as<unsigned>();
 		m_compiler->setOptimiserSettings(settings);
 
 		if (m_args.count(g_argImportAst))
@@ -2056,6 +2131,8 @@ void CommandLineInterface::outputCompilationResults()
 		if (m_args.count(g_argGas))
 			handleGasEstimation(contract);
 
+		handleIelePassStatistics(contract);
+
 		handleBytecode(contract);
 		handleIR(contract);
 		handleIROptimized(contract);
@@ -105,18 +105,21 @@ CommonOptions::CommonOptions(std::string _caption):
 {
 	options.add_options()
 		("evm-version", po::value(&evmVersionString), "which evm version to use")
-		("ipcpath", po::value<fs::path>(&this->ipcPath)->default_value(solidity::test::ipcPath()), "path to IPC file")
+		("ipcpath", po::value<std::vector<fs::path>>(&ipcPaths), "path to IPC file, can be supplied multiple times to run each batch against its own node.")
 		("testpath", po::value<fs::path>(&this->testPath)->default_value(solidity::test::testPath()), "path to test files")
 		("vm", po::value<std::vector<fs::path>>(&vmPaths), "path to evmc library, can be supplied multiple times.")
 		("ewasm", po::bool_switch(&ewasm), "tries to automatically find an ewasm vm and enable ewasm test-execution.")
 		("no-ipc", po::bool_switch(&disableIPC), "disable IPC tests")
+		("iele-interpreter", po::bool_switch(&ieleInterpreter), "execute contracts with the in-process IELE interpreter instead of an IELE node over IPC")
 		("no-smt", po::bool_switch(&disableSMT), "disable SMT checker")
 		("optimize", po::bool_switch(&optimize), "enables optimization")
 		("enforce-via-yul", po::bool_switch(&enforceViaYul), "Enforce compiling all tests via yul to see if additional tests can be activated.")
 		("enforce-no-yul-ewasm", po::bool_switch(&enforceNoYulEwasm), "Enforce compiling all tests without yul and not to Ewasm.")
 		("abiencoderv1", po::bool_switch(&useABIEncoderV1), "enables abi encoder v1")
 		("show-messages", po::bool_switch(&showMessages), "enables message output")
-		("show-metadata", po::bool_switch(&showMetadata), "enables metadata output");
+		("show-metadata", po::bool_switch(&showMetadata), "enables metadata output")
+		("batches", po::value<size_t>(&batches)->default_value(1), "set number of batches to split the tests into")
+		("selected-batch", po::value<size_t>(&selectedBatch)->default_value(0), "zero-based number of batch to execute");
 }
 
 void CommonOptions::validate() const
@@ -132,20 +135,38 @@ void CommonOptions::validate() const
 		"Invalid test path specified."
 	);
 
-	if (!disableIPC) {
+	assertThrow(
+		batches > 0 && selectedBatch < batches,
+		ConfigException,
+		"Invalid batch selected. The --selected-batch argument must be less than --batches."
+	);
+
+	if (!disableIPC && !ieleInterpreter) {
 		assertThrow(
-			!ipcPath.empty(),
+			!ipcPaths.empty(),
 			ConfigException,
 			"No IPC path specified. The --ipcpath argument is required, unless --no-ipc is used.."
 		);
+		for (auto const& path: ipcPaths)
+			assertThrow(
+				fs::exists(path),
+				ConfigException,
+				"Invalid IPC path specified: " + path.string()
+			);
 		assertThrow(
-			fs::exists(ipcPath),
+			batches <= ipcPaths.size(),
 			ConfigException,
-			"Invalid IPC path specified."
+			"Not enough IPC paths specified. Every batch needs its own node, so --ipcpath must be given at least as many times as --batches, unless --iele-interpreter is used."
 		);
 	}
 }
 
+fs::path const& CommonOptions::batchIPCPath() const
+{
+	assertThrow(selectedBatch < ipcPaths.size(), ConfigException, "No IPC path specified for the selected batch.");
+	return ipcPaths[selectedBatch];
+}
+
 bool CommonOptions::parse(int argc, char const* const* argv)
 {
 	po::variables_map arguments;
@@ -171,6 +192,9 @@ bool CommonOptions::parse(int argc, char const* const* argv)
 			throw std::runtime_error(errorMessage.str());
 		}
 
+	if (ipcPaths.empty() && !solidity::test::ipcPath().empty())
+		ipcPaths.push_back(solidity::test::ipcPath());
+
 	if (disableIPC && vmPaths.empty())
 	{
 		std::string evmone = envOrDefaultPath("ETH_EVMONE", evmoneFilename);
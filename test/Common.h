@@ -52,20 +52,30 @@ struct ConfigException : public util::Exception {};
 struct CommonOptions: boost::noncopyable
 {
 	std::vector<boost::filesystem::path> vmPaths;
-	boost::filesystem::path ipcPath;
+	/// IPC paths of the IELE nodes to run tests against. Each batch of tests uses one of them.
+	std::vector<boost::filesystem::path> ipcPaths;
 	boost::filesystem::path testPath;
 	bool ewasm = false;
 	bool optimize = false;
 	bool enforceViaYul = false;
 	bool enforceNoYulEwasm = false;
 	bool disableIPC = false;
+	bool ieleInterpreter = false;
 	bool disableSMT = false;
 	bool useABIEncoderV1 = false;
 	bool showMessages = false;
 	bool showMetadata = false;
+	/// The tests are split into this many batches, of which only selectedBatch runs.
+	size_t batches = 1;
+	size_t selectedBatch = 0;
 
 	langutil::EVMVersion evmVersion() const;
 
+	/// @returns true if the test with the given index belongs to the selected batch.
+	bool isInSelectedBatch(size_t _testIndex) const { return _testIndex % batches == selectedBatch; }
+	/// @returns the IPC path of the node that the selected batch runs against.
+	boost::filesystem::path const& batchIPCPath() const;
+
 	virtual bool parse(int argc, char const* const* argv);
 	// Throws a ConfigException on error
 	virtual void validate() const;
@@ -36,6 +36,7 @@
 #include <boost/algorithm/string/replace.hpp>
 
 #include <cstdlib>
+#include <tuple>
 
 using namespace std;
 using namespace solidity;
@@ -48,11 +49,21 @@ namespace // anonymous
 
 string getIPCSocketPath()
 {
-    const boost::filesystem::path &ipcPath = solidity::test::CommonOptions::get().ipcPath;
-    if (ipcPath.empty())
+    auto const& options = solidity::test::CommonOptions::get();
+    if (options.ipcPaths.empty())
         BOOST_FAIL("ERROR: ipcPath not set! (use --ipcpath <path> or the environment variable ETH_TEST_IPC)");
 
-    return ipcPath.string();
+    // Each batch of tests runs against its own node.
+    return options.batchIPCPath().string();
+}
+
+/// @returns the value of the signed big-endian bytes @a _bytes.
+bigint fromSignedBigEndian(bytes const& _bytes)
+{
+	bigint value = fromBigEndian<bigint>(_bytes);
+	if (!_bytes.empty() && (_bytes.front() & 0x80))
+		value -= bigint(1) << (8 * _bytes.size());
+	return value;
 }
 
 }
@@ -63,7 +74,6 @@ ExecutionFramework::ExecutionFramework():
 }
 
 ExecutionFramework::ExecutionFramework(langutil::EVMVersion _evmVersion, vector<boost::filesystem::path> const& _vmPaths):
-	m_rpc(RPCSession::instance(getIPCSocketPath())),
 	m_evmVersion(_evmVersion),
 	m_optimiserSettings(solidity::frontend::OptimiserSettings::minimal()),
 	m_showMessages(solidity::test::CommonOptions::get().showMessages),
@@ -72,7 +82,15 @@ ExecutionFramework::ExecutionFramework(langutil::EVMVersion _evmVersion, vector<
 	if (solidity::test::CommonOptions::get().optimize)
 		m_optimiserSettings = solidity::frontend::OptimiserSettings::standard();
 
-    m_rpc.test_rewindToBlock(0);
+	if (solidity::test::CommonOptions::get().ieleInterpreter)
+		m_ieleHost = make_unique<IeleHost>();
+	else
+	{
+		m_rpc = &RPCSession::instance(getIPCSocketPath());
+		// Rewinding is deferred, so that a snapshot can be restored instead.
+		m_rpc->resetChain();
+	}
+	m_sender = account(0);
 
 /*
 	for (auto const& path: m_vmPaths)
@@ -147,11 +165,15 @@ bytes ExecutionFramework::panicData(util::PanicCode _code)
 
 u256 ExecutionFramework::gasLimit() const
 {
+	if (m_ieleHost)
+		return m_ieleHost->gasLimit();
 	return {m_evmcHost->tx_context.block_gas_limit};
 }
 
 u256 ExecutionFramework::gasPrice() const
 {
+	if (m_ieleHost)
+		return m_gasPrice;
 	// here and below we use "return u256{....}" instead of just "return {....}"
 	// to please MSVC and avoid unexpected
 	// warning C4927 : illegal conversion; more than one user - defined conversion has been implicitly applied
@@ -160,6 +182,8 @@ u256 ExecutionFramework::gasPrice() const
 
 u256 ExecutionFramework::blockHash(u256 const& _number) const
 {
+	if (m_ieleHost)
+		return m_ieleHost->blockHash(_number);
 	return u256{EVMHost::convertFromEVMC(
 		m_evmcHost->get_block_hash(static_cast<int64_t>(_number & numeric_limits<uint64_t>::max()))
 	)};
@@ -190,6 +214,14 @@ void ExecutionFramework::sendMessage(std::vector<bytes> const& _arguments, std::
 		}
 		cout << "]" << endl;
 	}
+	if (m_timestamp == 0)
+		m_timestamp = time(nullptr);
+	if (m_ieleHost)
+	{
+		sendMessageToInterpreter(_arguments, _function, _data, _isCreation, _value);
+		return;
+	}
+
 	RPCSession::TransactionData d;
 	d.data = "0x" + toHex(_data);
 	for (bytes const& arg : _arguments) {
@@ -200,25 +232,46 @@ void ExecutionFramework::sendMessage(std::vector<bytes> const& _arguments, std::
 	d.gas = toHex(m_gas, HexPrefix::Add);
 	d.gasPrice = toHex(m_gasPrice, HexPrefix::Add);
 	d.value = toHex(_value, HexPrefix::Add);
-	if (m_timestamp == 0)
-		m_timestamp = time(nullptr);
-	m_rpc.test_modifyTimestamp(m_timestamp);
+	m_rpc->test_modifyTimestamp(m_timestamp);
+	// Nodes that report the returned values in receipts execute each call once, otherwise
+	// the values are obtained by executing the call with iele_call before sending it.
+	bool const outputInReceipt = m_rpc->receiptsHaveOutput();
 	if (!_isCreation)
 	{
 	        d.to = toString(m_contractAddress);
-	        BOOST_REQUIRE(m_rpc.eth_getCode(d.to, "latest").size() > 2);
-		vector<string> const& outputs = m_rpc.iele_call(d);
-		m_rpc.test_modifyTimestamp(m_timestamp);
-		m_output.clear();
-		for (auto const& output : outputs) {
-			m_output.push_back(fromHex(output, WhenError::Throw));
+		if (!outputInReceipt)
+		{
+			BOOST_REQUIRE(m_rpc->eth_getCode(d.to, "latest").size() > 2);
+			vector<string> const& outputs = m_rpc->iele_call(d);
+			m_rpc->test_modifyTimestamp(m_timestamp);
+			m_output.clear();
+			for (auto const& output : outputs) {
+				m_output.push_back(fromHex(output, WhenError::Throw));
+			}
 		}
 	}
 	m_timestamp = m_timestamp + 1;
 
-	string txHash = m_rpc.iele_sendTransaction(d);
-	m_rpc.test_mineBlocks(1);
-	RPCSession::TransactionReceipt receipt(m_rpc.eth_getTransactionReceipt(txHash));
+	string txHash = m_rpc->iele_sendTransaction(d);
+	m_rpc->test_mineBlocks(1);
+	// Nothing of the previous transaction may be taken for the results of this one.
+	if (outputInReceipt)
+		m_output.clear();
+	m_status = 0;
+	m_gasUsed = 0;
+	m_transactionSuccessful = false;
+	RPCSession::TransactionReceipt receipt(m_rpc->eth_getTransactionReceipt(txHash));
+	if (outputInReceipt)
+		BOOST_REQUIRE_MESSAGE(
+			receipt.hasOutput,
+			"The node reports returned values in receipts, but not in the receipt of " + txHash
+		);
+	if (receipt.hasOutput)
+	{
+		m_output.clear();
+		for (auto const& output: receipt.output)
+			m_output.push_back(fromHex(output, WhenError::Throw));
+	}
 
 	m_blockNumber = u256(receipt.blockNumber);
 	m_status = bigint(receipt.status);
@@ -254,6 +307,94 @@ void ExecutionFramework::sendMessage(std::vector<bytes> const& _arguments, std::
     }
 }
 
+void ExecutionFramework::sendMessageToInterpreter(std::vector<bytes> const& _arguments, std::string const& _function, bytes const& _data, bool _isCreation, u256 const& _value)
+{
+	vector<bigint> arguments;
+	for (bytes const& arg: _arguments)
+		arguments.push_back(fromSignedBigEndian(arg));
+	m_ieleHost->setTimestamp(m_timestamp);
+	m_timestamp = m_timestamp + 1;
+
+	iele::test::IeleTransactionResult result = _isCreation ?
+		m_ieleHost->create(m_sender, _data, arguments, _value, m_gas, m_gasPrice) :
+		m_ieleHost->call(m_sender, m_contractAddress, _function, arguments, _value, m_gas, m_gasPrice);
+
+	m_blockNumber = m_ieleHost->blockNumber();
+	// Like the receipts of IELE nodes, report the status as its minimal
+	// two's complement bytes, e.g. 255 for a revert with -1.
+	m_status = fromBigEndian<bigint>(toBigEndian(result.Status));
+	m_gasUsed = u256(result.GasUsed);
+	m_transactionSuccessful = m_status == 0;
+	if (_isCreation)
+		m_contractAddress = h160(u160(result.ContractAddress));
+	m_output.clear();
+	for (bigint const& value: result.ReturnValues)
+		m_output.push_back(toBigEndian(value));
+
+	if (m_showMessages)
+	{
+		cout << " out:     [ ";
+		for (bytes const& output: m_output)
+			cout << toHex(output) << " ";
+		cout << "]" << endl;
+		cout << " status:   " << m_status << endl;
+		cout << " gas used: " << m_gasUsed.str() << endl;
+	}
+
+	m_logs.clear();
+	for (auto const& log: result.Logs)
+	{
+		LogEntry entry;
+		entry.address = h160(u160(log.Address));
+		for (bigint const& topic: log.Topics)
+			entry.topics.push_back(h256(u256(topic & ((bigint(1) << 256) - 1))));
+		entry.data = log.Data;
+		m_logs.push_back(entry);
+	}
+}
+
+ExecutionFramework::ChainSnapshot ExecutionFramework::snapshot()
+{
+	ChainSnapshot snapshot;
+	if (m_ieleHost)
+		snapshot.ieleSnapshot = m_ieleHost->snapshot();
+	else
+		snapshot.rpcSnapshot = m_rpc->snapshot();
+	snapshot.contractAddress = m_contractAddress;
+	snapshot.blockNumber = m_blockNumber;
+	snapshot.timestamp = m_timestamp;
+	return snapshot;
+}
+
+bool ExecutionFramework::revertToSnapshot(ChainSnapshot const& _snapshot)
+{
+	if (m_ieleHost)
+	{
+		if (!_snapshot.ieleSnapshot)
+			return false;
+		m_ieleHost->revertToSnapshot(_snapshot.ieleSnapshot);
+	}
+	else if (_snapshot.ieleSnapshot || !m_rpc->revertToSnapshot(_snapshot.rpcSnapshot))
+		return false;
+	m_contractAddress = _snapshot.contractAddress;
+	m_blockNumber = _snapshot.blockNumber;
+	m_timestamp = _snapshot.timestamp;
+	return true;
+}
+
+void ExecutionFramework::deployOnce(string const& _key, function<void()> const& _deploy)
+{
+	// Snapshots of a node are only valid in the session they were taken in, and the deployed
+	// contracts depend on the account that sent the deployment.
+	static map<tuple<RPCSession const*, h160, string>, ChainSnapshot> deployments;
+	auto key = make_tuple(m_rpc, m_sender, _key);
+	auto deployment = deployments.find(key);
+	if (deployment != deployments.end() && revertToSnapshot(deployment->second))
+		return;
+	_deploy();
+	deployments[key] = snapshot();
+}
+
 void ExecutionFramework::sendEther(h160 const& _to, u256 const& _value)
 {
 	RPCSession::TransactionData d;
@@ -264,31 +405,44 @@ void ExecutionFramework::sendEther(h160 const& _to, u256 const& _value)
 	d.gasPrice = toHex(m_gasPrice, HexPrefix::Add);
 	d.value = toHex(_value, HexPrefix::Add);
 	d.to = toString(_to);
+	if (m_ieleHost)
+	{
+		m_ieleHost->call(m_sender, _to, d.function, {}, _value, m_gas, m_gasPrice);
+		return;
+	}
 
-	string txHash = m_rpc.iele_sendTransaction(d);
-	m_rpc.test_mineBlocks(1);
+	string txHash = m_rpc->iele_sendTransaction(d);
+	m_rpc->test_mineBlocks(1);
 }
 
 size_t ExecutionFramework::currentTimestamp()
 {
-	auto timestamp = m_rpc.eth_getTimestamp("latest");
+	if (m_ieleHost)
+		return size_t(m_ieleHost->blockTimestamp(m_ieleHost->blockNumber()));
+	auto timestamp = m_rpc->eth_getTimestamp("latest");
 	return size_t(u256(timestamp));
 }
 
 size_t ExecutionFramework::blockTimestamp(u256 _block)
 {
-	auto timestamp = m_rpc.eth_getTimestamp(toString(_block));
+	if (m_ieleHost)
+		return size_t(m_ieleHost->blockTimestamp(_block));
+	auto timestamp = m_rpc->eth_getTimestamp(toString(_block));
 	return size_t(u256(timestamp));
 }
 
 h160 ExecutionFramework::account(size_t _i)
 {
-	return h160(m_rpc.accountCreateIfNotExists(_i));;
+	if (m_ieleHost)
+		return m_ieleHost->account(_i);
+	return h160(m_rpc->accountCreateIfNotExists(_i));
 }
 
 bool ExecutionFramework::addressHasCode(h160 const& _addr)
 {
-    string code = m_rpc.eth_getCode(toString(_addr), "latest");
+	if (m_ieleHost)
+		return m_ieleHost->hasCode(_addr);
+    string code = m_rpc->eth_getCode(toString(_addr), "latest");
     return !code.empty() && code != "0x";
 }
 
@@ -322,10 +476,14 @@ bytes ExecutionFramework::logData(size_t _logIdx) const
 
 u256 ExecutionFramework::balanceAt(h160 const& _addr)
 {
-	return u256(m_rpc.eth_getBalance(toString(_addr), "latest"));
+	if (m_ieleHost)
+		return m_ieleHost->balance(_addr);
+	return u256(m_rpc->eth_getBalance(toString(_addr), "latest"));
 }
 
 bool ExecutionFramework::storageEmpty(h160 const& _addr)
 {
-	return m_rpc.eth_isStorageEmpty(toString(_addr), "latest");
+	if (m_ieleHost)
+		return m_ieleHost->storageEmpty(_addr);
+	return m_rpc->eth_isStorageEmpty(toString(_addr), "latest");
 }
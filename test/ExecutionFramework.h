@@ -25,6 +25,7 @@
 
 #include <test/Common.h>
 #include <test/EVMHost.h>
+#include <test/IeleHost.h>
 #include <test/RPCSession.h>
 
 #include <libsolidity/interface/OptimiserSettings.h>
@@ -445,10 +446,33 @@ protected:
 	void reset();
 
 	void sendMessage(std::vector<bytes> const& _arguments, std::string _function, bytes const& _data, bool _isCreation, u256 const& _value = 0);
+	/// Executes a transaction with the in-process IELE interpreter.
+	void sendMessageToInterpreter(std::vector<bytes> const& _arguments, std::string const& _function, bytes const& _data, bool _isCreation, u256 const& _value);
 	void sendEther(util::h160 const& _to, u256 const& _value);
 	size_t currentTimestamp();
 	size_t blockTimestamp(u256 _number);
 
+	/// A saved state of the chain, together with the contract address and clock of the framework.
+	struct ChainSnapshot
+	{
+		/// The id of the snapshot of the node, unless contracts are executed by @a m_ieleHost.
+		size_t rpcSnapshot = 0;
+		std::shared_ptr<IeleHost::Snapshot const> ieleSnapshot;
+		util::h160 contractAddress;
+		u256 blockNumber;
+		size_t timestamp = 0;
+	};
+
+	/// Saves the current state of the chain.
+	ChainSnapshot snapshot();
+	/// Restores a state saved by snapshot(), possibly in another test case.
+	/// @returns false if the node no longer has that state.
+	bool revertToSnapshot(ChainSnapshot const& _snapshot);
+	/// Runs @a _deploy the first time it is called with @a _key and saves the resulting state.
+	/// Later calls with the same key, sender and node, e.g. from other test cases of a suite,
+	/// restore that state instead of deploying again.
+	void deployOnce(std::string const& _key, std::function<void()> const& _deploy);
+
 	/// @returns the (potentially newly created) _ith address.
 	util::h160 account(size_t _i);
 
@@ -456,7 +480,8 @@ protected:
 	bool storageEmpty(util::h160 const& _addr);
 	bool addressHasCode(util::h160 const& _addr);
 
-	RPCSession& m_rpc;
+	/// The IELE node, unless contracts are executed by @a m_ieleHost.
+	RPCSession* m_rpc = nullptr;
 
     struct LogEntry
     {
@@ -477,11 +502,13 @@ protected:
 	bool m_showMessages = false;
 	bool m_supportsEwasm = false;
 	std::unique_ptr<EVMHost> m_evmcHost;
+	/// The in-process IELE interpreter, if enabled with --iele-interpreter.
+	std::unique_ptr<IeleHost> m_ieleHost;
 
 	std::vector<boost::filesystem::path> m_vmPaths;
 
 	bool m_transactionSuccessful = true;
-	util::h160 m_sender = util::h160(m_rpc.account(0));
+	util::h160 m_sender;
 	util::h160 m_contractAddress;
 	u256 m_blockNumber;
 	u256 const m_gasPrice = 10 * gwei;
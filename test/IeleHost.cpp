@@ -0,0 +1,160 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * IELE execution host, i.e. a simulated IELE blockchain that executes contracts
+ * with the in-process IELE interpreter instead of an IELE node.
+ */
+
+#include <test/IeleHost.h>
+
+#include <libsolutil/Keccak256.h>
+
+using namespace std;
+using namespace solidity;
+using namespace solidity::util;
+using namespace solidity::test;
+using namespace solidity::iele::test;
+
+namespace
+{
+
+bigint toBigint(h160 const& _address)
+{
+	return bigint(u160(_address));
+}
+
+/// The IR of all contracts registered with any host, as long as it is alive.
+map<bytes, weak_ptr<iele::IeleContract const>>& compiledContracts()
+{
+	static map<bytes, weak_ptr<iele::IeleContract const>> contracts;
+	return contracts;
+}
+
+}
+
+IeleHost::IeleHost()
+{
+	// The block gas limit of the IELE test nodes.
+	m_state.GasLimit = 8000000;
+}
+
+shared_ptr<IeleHost::Snapshot const> IeleHost::snapshot() const
+{
+	return make_shared<Snapshot const>(Snapshot{m_state, m_contracts, m_accounts, m_blockTimestamps, m_snapshot});
+}
+
+void IeleHost::revertToSnapshot(shared_ptr<Snapshot const> _snapshot)
+{
+	m_state = _snapshot->state;
+	for (auto const& contract: _snapshot->contracts)
+		m_contracts.emplace(contract);
+	m_accounts = _snapshot->accounts;
+	m_blockTimestamps = _snapshot->blockTimestamps;
+	m_snapshot = move(_snapshot);
+}
+
+void IeleHost::registerContract(bytes const& _bytecode, shared_ptr<iele::IeleContract const> _contract)
+{
+	// Accounts keep pointers into the IR registered first for equal bytecode.
+	compiledContracts().emplace(_bytecode, _contract);
+	m_contracts.emplace(_bytecode, move(_contract));
+}
+
+h160 IeleHost::account(size_t _i)
+{
+	while (m_accounts.size() <= _i)
+	{
+		h160 address(keccak256("account " + to_string(m_accounts.size())), h160::AlignRight);
+		m_state.Accounts[toBigint(address)].Balance = bigint(1) << 100;
+		m_accounts.push_back(address);
+	}
+	return m_accounts[_i];
+}
+
+IeleTransactionResult IeleHost::create(
+	h160 const& _from,
+	bytes const& _bytecode,
+	vector<bigint> const& _arguments,
+	u256 const& _value,
+	u256 const& _gas,
+	u256 const& _gasPrice
+)
+{
+	newBlock();
+	auto contract = m_contracts.find(_bytecode);
+	if (contract == m_contracts.end())
+	{
+		// The bytecode may have been compiled by another test case, whose IR is still
+		// owned by a snapshot.
+		auto compiled = compiledContracts().find(_bytecode);
+		if (compiled != compiledContracts().end())
+			if (auto ir = compiled->second.lock())
+				contract = m_contracts.emplace(_bytecode, move(ir)).first;
+	}
+	if (contract == m_contracts.end())
+	{
+		IeleTransactionResult result;
+		result.Status = ContractInvalid;
+		return result;
+	}
+	return m_interpreter.create(toBigint(_from), *contract->second, _arguments, _value, _gas, _gasPrice);
+}
+
+IeleTransactionResult IeleHost::call(
+	h160 const& _from,
+	h160 const& _to,
+	string const& _function,
+	vector<bigint> const& _arguments,
+	u256 const& _value,
+	u256 const& _gas,
+	u256 const& _gasPrice
+)
+{
+	newBlock();
+	return m_interpreter.call(toBigint(_from), toBigint(_to), _function, _arguments, _value, _gas, _gasPrice);
+}
+
+u256 IeleHost::blockTimestamp(u256 const& _number) const
+{
+	auto timestamp = m_blockTimestamps.find(_number);
+	return timestamp == m_blockTimestamps.end() ? u256(0) : timestamp->second;
+}
+
+u256 IeleHost::balance(h160 const& _address) const
+{
+	auto account = m_state.Accounts.find(toBigint(_address));
+	return account == m_state.Accounts.end() ? u256(0) : u256(account->second.Balance);
+}
+
+bool IeleHost::hasCode(h160 const& _address) const
+{
+	auto account = m_state.Accounts.find(toBigint(_address));
+	return account != m_state.Accounts.end() && account->second.Contract;
+}
+
+bool IeleHost::storageEmpty(h160 const& _address) const
+{
+	auto account = m_state.Accounts.find(toBigint(_address));
+	return account == m_state.Accounts.end() || account->second.Storage.empty();
+}
+
+void IeleHost::newBlock()
+{
+	m_state.BlockNumber++;
+	m_blockTimestamps[u256(m_state.BlockNumber)] = u256(m_state.Timestamp);
+}
@@ -0,0 +1,116 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * IELE execution host, i.e. a simulated IELE blockchain that executes contracts
+ * with the in-process IELE interpreter instead of an IELE node.
+ */
+
+#pragma once
+
+#include <test/tools/ieleInterpreter/IeleInterpreter.h>
+
+#include <libsolutil/Common.h>
+#include <libsolutil/FixedHash.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace solidity::iele
+{
+class IeleContract;
+}
+
+namespace solidity::test
+{
+
+class IeleHost
+{
+public:
+	/// A copy of the chain state and of the contracts it refers to.
+	struct Snapshot
+	{
+		iele::test::IeleChainState state;
+		std::map<bytes, std::shared_ptr<iele::IeleContract const>> contracts;
+		std::vector<util::h160> accounts;
+		std::map<u256, u256> blockTimestamps;
+		/// The snapshot reverted to before, which owns the contracts of some accounts.
+		std::shared_ptr<Snapshot const> base;
+	};
+
+	IeleHost();
+
+	/// @returns a snapshot of the current state, which can be restored on any host.
+	std::shared_ptr<Snapshot const> snapshot() const;
+	/// Restores the state saved in @a _snapshot. Contracts registered since stay registered.
+	void revertToSnapshot(std::shared_ptr<Snapshot const> _snapshot);
+
+	/// Registers the IR of a contract, which is executed by transactions that create
+	/// accounts with @a _bytecode.
+	void registerContract(bytes const& _bytecode, std::shared_ptr<iele::IeleContract const> _contract);
+
+	/// @returns the address of the _ith account, which is funded on first use.
+	util::h160 account(size_t _i);
+
+	/// Sets the timestamp of the next block.
+	void setTimestamp(u256 const& _timestamp) { m_state.Timestamp = _timestamp; }
+
+	/// Executes a transaction creating a contract with @a _bytecode in a new block.
+	iele::test::IeleTransactionResult create(
+		util::h160 const& _from,
+		bytes const& _bytecode,
+		std::vector<bigint> const& _arguments,
+		u256 const& _value,
+		u256 const& _gas,
+		u256 const& _gasPrice
+	);
+	/// Executes a transaction calling @a _function of @a _to in a new block.
+	iele::test::IeleTransactionResult call(
+		util::h160 const& _from,
+		util::h160 const& _to,
+		std::string const& _function,
+		std::vector<bigint> const& _arguments,
+		u256 const& _value,
+		u256 const& _gas,
+		u256 const& _gasPrice
+	);
+
+	u256 blockNumber() const { return u256(m_state.BlockNumber); }
+	u256 gasLimit() const { return u256(m_state.GasLimit); }
+	/// @returns the timestamp of block @a _number, or zero if it has not been mined.
+	u256 blockTimestamp(u256 const& _number) const;
+	u256 blockHash(u256 const& _number) const { return u256(m_state.blockHash(_number)); }
+	u256 balance(util::h160 const& _address) const;
+	bool hasCode(util::h160 const& _address) const;
+	bool storageEmpty(util::h160 const& _address) const;
+
+private:
+	/// Mines the block of a transaction and stores its timestamp.
+	void newBlock();
+
+	iele::test::IeleChainState m_state;
+	iele::test::IeleInterpreter m_interpreter{m_state};
+	std::map<bytes, std::shared_ptr<iele::IeleContract const>> m_contracts;
+	std::vector<util::h160> m_accounts;
+	std::map<u256, u256> m_blockTimestamps;
+	/// The snapshot reverted to last, which owns the contracts of its accounts.
+	std::shared_ptr<Snapshot const> m_snapshot;
+};
+
+}
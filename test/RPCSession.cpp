@@ -145,9 +145,12 @@ string IPCSocket::sendRequest(string const& _req)
 
 RPCSession& RPCSession::instance(const string& _path)
 {
-	static RPCSession session(_path);
-	BOOST_REQUIRE_EQUAL(session.m_ipcSocket.path(), _path);
-	return session;
+	// There is one session per node, with its own accounts.
+	static map<string, unique_ptr<RPCSession>> sessions;
+	unique_ptr<RPCSession>& session = sessions[_path];
+	if (!session)
+		session.reset(new RPCSession(_path));
+	return *session;
 }
 
 string RPCSession::eth_getCode(string const& _address, string const& _blockNumber)
@@ -163,14 +166,22 @@ string RPCSession::eth_getTimestamp(string const& _blockNumber)
 
 RPCSession::TransactionReceipt RPCSession::eth_getTransactionReceipt(string const& _transactionHash)
 {
-	TransactionReceipt receipt;
 	Json::Value const result = rpcCall("eth_getTransactionReceipt", { quote(_transactionHash) });
 	BOOST_REQUIRE(!result.isNull());
-	receipt.contractAddress = result["contractAddress"].asString();
-	receipt.gasUsed = result["gasUsed"].asString();
-	receipt.status = result["status"].asString();
-	receipt.blockNumber = result["blockNumber"].asString();
-	for (auto const& log: result["logs"])
+	TransactionReceipt receipt = parseTransactionReceipt(result);
+	if (receipt.hasOutput)
+		m_receiptsHaveOutput = true;
+	return receipt;
+}
+
+RPCSession::TransactionReceipt RPCSession::parseTransactionReceipt(Json::Value const& _result)
+{
+	TransactionReceipt receipt;
+	receipt.contractAddress = _result["contractAddress"].asString();
+	receipt.gasUsed = _result["gasUsed"].asString();
+	receipt.status = _result["status"].asString();
+	receipt.blockNumber = _result["blockNumber"].asString();
+	for (auto const& log: _result["logs"])
 	{
 		LogEntry entry;
 		entry.address = log["address"].asString();
@@ -179,6 +190,12 @@ RPCSession::TransactionReceipt RPCSession::eth_getTransactionReceipt(string cons
 			entry.topics.push_back(topic.asString());
 		receipt.logEntries.push_back(entry);
 	}
+	if (_result.isMember("output"))
+	{
+		receipt.hasOutput = true;
+		for (auto const& output: _result["output"])
+			receipt.output.push_back(output.asString());
+	}
 	return receipt;
 }
 
@@ -228,6 +245,35 @@ string RPCSession::personal_newAccount()
 void RPCSession::test_rewindToBlock(size_t _blockNr)
 {
 	BOOST_REQUIRE(rpcCall("test_rewindToBlock", { to_string(_blockNr) }) == true);
+	// Blocks after the target are mined again, so their snapshots no longer apply.
+	for (auto it = m_snapshots.begin(); it != m_snapshots.end();)
+		if (it->second > _blockNr)
+			it = m_snapshots.erase(it);
+		else
+			++it;
+}
+
+size_t RPCSession::eth_blockNumber()
+{
+	return size_t(u256(rpcCall("eth_blockNumber").asString()));
+}
+
+size_t RPCSession::snapshot()
+{
+	size_t id = m_nextSnapshot++;
+	m_snapshots[id] = eth_blockNumber();
+	return id;
+}
+
+bool RPCSession::revertToSnapshot(size_t _id)
+{
+	auto snapshot = m_snapshots.find(_id);
+	if (snapshot == m_snapshots.end())
+		return false;
+	// A pending reset is superseded, and would invalidate the snapshot.
+	m_resetPending = false;
+	test_rewindToBlock(snapshot->second);
+	return true;
 }
 
 void RPCSession::test_mineBlocks(int _number)
@@ -287,6 +333,17 @@ void RPCSession::test_setBalance(vector<string> _accounts, string _balance) {
 
 Json::Value RPCSession::rpcCall(string const& _methodName, vector<string> const& _args, bool _canFail)
 {
+	if (m_resetPending)
+	{
+		m_resetPending = false;
+		// The blocks up to the latest snapshot are kept, since rewinding below them would make
+		// the snapshots unavailable.
+		size_t block = 0;
+		for (auto const& snapshot: m_snapshots)
+			block = max(block, snapshot.second);
+		test_rewindToBlock(block);
+	}
+
 	string request = "{\"jsonrpc\":\"2.0\",\"method\":\"" + _methodName + "\",\"params\":[";
 	for (size_t i = 0; i < _args.size(); ++i)
 	{
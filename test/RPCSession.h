@@ -104,24 +104,47 @@ public:
 		std::string status;
 		std::vector<LogEntry> logEntries;
 		std::string blockNumber;
+		/// The values returned by the transaction, if the node reports them in receipts.
+		std::vector<std::string> output;
+		bool hasOutput = false;
 	};
 
+	/// @returns the session with the node at the IPC path @a _path, connecting to it first
+	/// if needed.
 	static RPCSession& instance(std::string const& _path);
 
 	std::string eth_getCode(std::string const& _address, std::string const& _blockNumber);
 	std::string eth_getTimestamp(std::string const& _blockNumber);
 	TransactionReceipt eth_getTransactionReceipt(std::string const& _transactionHash);
+	/// @returns the receipt described by the result @a _result of eth_getTransactionReceipt.
+	static TransactionReceipt parseTransactionReceipt(Json::Value const& _result);
 	std::string iele_sendTransaction(TransactionData const& _td);
 	std::string iele_sendTransaction(std::string const& _transaction);
 	std::vector<std::string> iele_call(TransactionData const& _td);
 	std::string eth_getBalance(std::string const& _address, std::string const& _blockNumber);
 	bool eth_isStorageEmpty(std::string const& _address, std::string const& _blockNumber);
 	void test_rewindToBlock(size_t _blockNr);
+	size_t eth_blockNumber();
 	void test_modifyTimestamp(size_t _timestamp);
 	void test_mineBlocks(int _number);
 
 	bool miner_setEtherbase(std::string const& _address);
 
+	/// Rewinds the chain before the next request, unless a snapshot is reverted to first.
+	/// The chain is rewound to the block of the latest snapshot, or to its genesis block if
+	/// there is none, so that resets keep the snapshots available.
+	void resetChain() { m_resetPending = true; }
+	/// Saves the current state of the chain. @returns the id of the snapshot.
+	size_t snapshot();
+	/// Rewinds the chain to the state saved as snapshot @a _id. Snapshots of blocks that were
+	/// rewound since, e.g. by reverting to an earlier snapshot, are no longer available.
+	/// @returns false if the snapshot is no longer available, leaving the chain unchanged.
+	bool revertToSnapshot(size_t _id);
+
+	/// @returns true if the node reports the returned values in transaction receipts, so
+	/// that calls need not be executed with iele_call first. Known after the first receipt.
+	bool receiptsHaveOutput() const { return m_receiptsHaveOutput; }
+
 	std::string const& account(size_t _id) const { return m_accounts.at(_id); }
 	std::string const& accountCreate();
 	std::string const& accountCreateIfNotExists(size_t _id);
@@ -142,6 +165,11 @@ private:
 	unsigned m_maxMiningTime = 6000000; // 600 seconds
 	unsigned m_sleepTime = 10; // 10 milliseconds
 	unsigned m_successfulMineRuns = 0;
+	bool m_receiptsHaveOutput = false;
+	bool m_resetPending = false;
+	/// The block numbers of the available snapshots, by id.
+	std::map<size_t, size_t> m_snapshots;
+	size_t m_nextSnapshot = 0;
 
 	std::vector<std::string> m_accounts;
 };
@@ -0,0 +1,111 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Unit tests for the parsing of the results of the RPC calls to IELE nodes.
+ */
+
+#include <test/RPCSession.h>
+
+#include <libsolutil/JSON.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+using namespace std;
+using namespace solidity::util;
+
+namespace solidity::test
+{
+
+namespace
+{
+
+RPCSession::TransactionReceipt parseReceipt(string const& _json)
+{
+	Json::Value result;
+	BOOST_REQUIRE(jsonParseStrict(_json, result));
+	return RPCSession::parseTransactionReceipt(result);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(RPCSessionTest)
+
+BOOST_AUTO_TEST_CASE(receipt_with_output)
+{
+	RPCSession::TransactionReceipt receipt = parseReceipt(R"({
+		"blockNumber": "0x5",
+		"contractAddress": null,
+		"gasUsed": "0x4c2",
+		"status": "0x0",
+		"logs": [{
+			"address": "0x1000000000000000000000000000000000000002",
+			"data": "0x01",
+			"topics": ["0x2a", "0x2b"]
+		}],
+		"output": ["0x07", "0x"]
+	})");
+	BOOST_CHECK_EQUAL(receipt.blockNumber, "0x5");
+	BOOST_CHECK_EQUAL(receipt.contractAddress, "");
+	BOOST_CHECK_EQUAL(receipt.gasUsed, "0x4c2");
+	BOOST_CHECK_EQUAL(receipt.status, "0x0");
+	BOOST_REQUIRE_EQUAL(receipt.logEntries.size(), 1);
+	BOOST_CHECK_EQUAL(receipt.logEntries[0].address, "0x1000000000000000000000000000000000000002");
+	BOOST_CHECK_EQUAL(receipt.logEntries[0].data, "0x01");
+	BOOST_REQUIRE_EQUAL(receipt.logEntries[0].topics.size(), 2);
+	BOOST_CHECK_EQUAL(receipt.logEntries[0].topics[1], "0x2b");
+	BOOST_CHECK(receipt.hasOutput);
+	BOOST_REQUIRE_EQUAL(receipt.output.size(), 2);
+	BOOST_CHECK_EQUAL(receipt.output[0], "0x07");
+	BOOST_CHECK_EQUAL(receipt.output[1], "0x");
+}
+
+BOOST_AUTO_TEST_CASE(receipt_with_empty_output)
+{
+	RPCSession::TransactionReceipt receipt = parseReceipt(R"({
+		"blockNumber": "0x6",
+		"contractAddress": "0x1000000000000000000000000000000000000003",
+		"gasUsed": "0x100",
+		"status": "0x0",
+		"logs": [],
+		"output": []
+	})");
+	BOOST_CHECK_EQUAL(receipt.contractAddress, "0x1000000000000000000000000000000000000003");
+	BOOST_CHECK(receipt.hasOutput);
+	BOOST_CHECK(receipt.output.empty());
+}
+
+BOOST_AUTO_TEST_CASE(receipt_without_output)
+{
+	RPCSession::TransactionReceipt receipt = parseReceipt(R"({
+		"blockNumber": "0x7",
+		"contractAddress": null,
+		"gasUsed": "0x200",
+		"status": "0xff",
+		"logs": []
+	})");
+	BOOST_CHECK_EQUAL(receipt.status, "0xff");
+	BOOST_CHECK(receipt.logEntries.empty());
+	BOOST_CHECK(!receipt.hasOutput);
+	BOOST_CHECK(receipt.output.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -43,6 +43,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/test/tree/visitor.hpp>
 #include <string>
 
 using namespace boost::unit_test;
@@ -60,6 +61,27 @@ void removeTestSuite(std::string const& _name)
 	master.remove(id);
 }
 
+/// Removes the test cases that are not part of the selected batch, counting them in the
+/// order of the test tree.
+void removeTestsOutsideBatch()
+{
+	struct BatchFilter: test_tree_visitor
+	{
+		void visit(test_case const& _testCase) override
+		{
+			if (!solidity::test::CommonOptions::get().isInSelectedBatch(index++))
+				excluded.push_back(_testCase.p_id);
+		}
+		size_t index = 0;
+		vector<test_unit_id> excluded;
+	};
+
+	BatchFilter filter;
+	traverse_test_tree(framework::master_test_suite(), filter, true);
+	for (test_unit_id id: filter.excluded)
+		framework::get<test_suite>(framework::get(id, TUT_CASE).p_parent_id).remove(id);
+}
+
 int registerTests(
 	boost::unit_test::test_suite& _suite,
 	boost::filesystem::path const& _basepath,
@@ -164,7 +186,8 @@ test_suite* init_unit_test_suite( int /*argc*/, char* /*argv*/[] )
 	bool disableSemantics = true;
 	try
 	{
-		disableSemantics = solidity::test::CommonOptions::get().disableIPC;
+		auto const& options = solidity::test::CommonOptions::get();
+		disableSemantics = options.disableIPC && !options.ieleInterpreter;
 	}
 	catch (std::runtime_error const& _exception)
 	{
@@ -212,6 +235,9 @@ test_suite* init_unit_test_suite( int /*argc*/, char* /*argv*/[] )
 			removeTestSuite(suite);
 	}
 
+	if (solidity::test::CommonOptions::get().batches > 1)
+		removeTestsOutsideBatch();
+
 	return nullptr;
 }
 
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: GPL-3.0
+pragma solidity >=0.0;
+
+contract C {
+    uint x;
+
+    constructor(uint v) { x = v; }
+
+    function loop(uint n) public returns (uint s) {
+        for (uint i = 0; i < n; i++)
+            s += i;
+        x = s;
+    }
+
+    function rec(uint n) public pure returns (uint) {
+        return n == 0 ? 0 : rec(n - 1) + 1;
+    }
+
+    function get() public view returns (uint) { return x; }
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-3.0
+pragma solidity >=0.0;
+
+contract C {
+    address owner = msg.sender;
+    bool locked;
+    uint x;
+
+    modifier guarded(uint limit) {
+        require(msg.sender == owner);
+        require(!locked);
+        require(limit > 0 && limit < 1000);
+        locked = true;
+        _;
+        locked = false;
+        require(x <= limit);
+    }
+
+    function a(uint v) public guarded(10) { x = v; }
+    function b(uint v) public guarded(20) { x = v + 1; }
+    function c(uint v) public guarded(30) { x = v * 2; }
+    function d(uint v) public guarded(40) { x = v * 3; }
+}
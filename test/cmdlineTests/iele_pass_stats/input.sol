@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0
+pragma solidity >=0.0;
+
+contract C {
+    mapping(uint => uint) balances;
+
+    function sum(uint n) public pure returns (uint s) {
+        for (uint i = 0; i < n; i++)
+            s += i * (2 + 3);
+    }
+
+    function move(uint from, uint to, uint amount) public {
+        require(balances[from] >= amount);
+        balances[from] -= amount;
+        balances[to] += amount;
+    }
+
+    function squares() public pure returns (uint s) {
+        uint[8] memory a;
+        for (uint i = 0; i < 8; i++)
+            a[i] = i * i;
+        for (uint i = 0; i < a.length; i++)
+            s += a[i];
+    }
+
+    function total(uint[] memory a) public pure returns (uint s) {
+        for (uint i = 0; i < a.length; i++)
+            s += a[i];
+    }
+}
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-3.0
+pragma solidity >=0.0;
+
+contract C {
+    mapping(uint => uint) balances;
+
+    function sum(uint n) public pure returns (uint s) {
+        for (uint i = 0; i < n; i++)
+            s += i * (2 + 3);
+    }
+
+    function move(uint from, uint to, uint amount) public {
+        require(balances[from] >= amount);
+        balances[from] -= amount;
+        balances[to] += amount;
+    }
+}
@@ -222,12 +222,13 @@ class AuctionRegistrarTestFramework: public SolidityExecutionFramework
 protected:
 	void deployRegistrar()
 	{
-		bytes const& compiled = s_compiledRegistrar.init([&]{
-			return compileContract(registrarCode, "GlobalRegistrar");
+		deployOnce("GlobalRegistrar", [&]{
+			bytes const& compiled = s_compiledRegistrar.init([&]{
+				return compileContract(registrarCode, "GlobalRegistrar");
+			});
+			sendMessage(std::vector<bytes>(), "", compiled, true);
+			BOOST_REQUIRE(m_status == 0);
 		});
-
-		sendMessage(std::vector<bytes>(), "", compiled, true);
-		BOOST_REQUIRE(m_status == 0);
 	}
 
 	class RegistrarInterface: public ContractInterface
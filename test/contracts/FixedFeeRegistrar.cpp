@@ -133,12 +133,13 @@ class RegistrarTestFramework: public SolidityExecutionFramework
 protected:
 	void deployRegistrar()
 	{
-		bytes const& compiled = s_compiledRegistrar.init([&]{
-			return compileContract(registrarCode, "FixedFeeRegistrar");
+		deployOnce("FixedFeeRegistrar", [&]{
+			bytes const& compiled = s_compiledRegistrar.init([&]{
+				return compileContract(registrarCode, "FixedFeeRegistrar");
+			});
+			sendMessage(std::vector<bytes>(), "", compiled, true);
+			BOOST_REQUIRE(m_status == 0);
 		});
-
-		sendMessage(std::vector<bytes>(), "", compiled, true);
-		BOOST_REQUIRE(m_status == 0);
 	}
 	u256 const m_fee = u256("69000000000000000000");
 };
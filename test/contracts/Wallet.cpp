@@ -448,16 +448,20 @@ protected:
 		u256 _dailyLimit = 0
 	)
 	{
-		bytes const& compiled = s_compiledWallet.init([&]{
-			return compileContract(walletCode, "Wallet");
-		});
-
-
 		vector<u256> _owners256;
 		for (auto _owner : _owners) _owners256.push_back(u256(h256(_owner, h256::AlignRight)));
 		std::vector<bytes> args = encodeArgs(encodeRefArray(_owners256, _owners.size(), 20), _required, _dailyLimit);
-		sendMessage(args, "", compiled, true, _value);
-		BOOST_REQUIRE(m_status == 0);
+
+		string key = "Wallet " + toString(_value);
+		for (bytes const& arg: args)
+			key += " " + toHex(arg);
+		deployOnce(key, [&]{
+			bytes const& compiled = s_compiledWallet.init([&]{
+				return compileContract(walletCode, "Wallet");
+			});
+			sendMessage(args, "", compiled, true, _value);
+			BOOST_REQUIRE(m_status == 0);
+		});
 	}
 };
 
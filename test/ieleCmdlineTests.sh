@@ -124,13 +124,95 @@ done
 cd ..
 rm -rf "$TMPDIR"
 
-total=$((examples+contracts+ctests+doctests))
-total_success=$((examples_success+contracts_success+ctests_success+doctests_success))
-total_excluded=$((examples_excluded+contracts_excluded+ctests_excluded+doctests_excluded))
+# Runs the commandline test in directory $1 and compares its output with the
+# expectations stored next to it. The test consists of either input.sol, which
+# is compiled with the arguments in args, or input.json, which is fed to
+# --standard-json. The expected standard output is in output or output.json,
+# the expected standard error (if checked) in err and the expected exit code
+# (if not 0) in exit. If the file runs exists, the compiler is run that many
+# times in the same directory and only the output of the last run is checked.
+function runCmdlineTest()
+{
+    local tdir="$1"
+    local workdir stdout stderr exit_code expected_exit runs args
+
+    workdir=$(mktemp -d)
+    cp -r "$tdir"/. "$workdir"
+    args=()
+    [ -f "$tdir/args" ] && read -r -a args < "$tdir/args"
+    runs=1
+    [ -f "$tdir/runs" ] && runs=$(cat "$tdir/runs")
+
+    for ((run = 0; run < runs; run++))
+    do
+        if [ -f "$tdir/input.json" ]
+        then
+            (cd "$workdir" && "$SOLC" --standard-json "${args[@]}" < input.json > stdout 2> stderr)
+        else
+            (cd "$workdir" && "$SOLC" "${args[@]}" input.sol > stdout 2> stderr)
+        fi
+        exit_code=$?
+    done
+
+    stdout="$workdir/stdout"
+    stderr="$workdir/stderr"
+    sed -i -e '/^Warning: This is a pre-release compiler version, please do not use it in production./d' "$stderr"
+    sed -i -e '/^$/d' "$stderr"
+    sed -i -E -e 's/\{[^{]*"message":"This is a pre-release compiler version[^}]*\},?//' "$stdout"
+    sed -i -E -e 's/"errors":\[\],?//' "$stdout"
+    sed -i -E -e 's/"object":"[a-f0-9]+"/"object":"bytecode removed"/g' "$stdout"
+    sed -i -e '/^Binary:$/{n;s/^[a-f0-9]*$/bytecode removed/}' "$stdout"
+    sed -i -E -e 's/ +[0-9]+\.[0-9]{3} / <time> /' "$stdout"
+    # The code deposit is charged for the metadata too, which contains the compiler version.
+    sed -i -E -e 's/^(   code deposit:\t)[0-9]+$/\1<deposit>/' -e 's/^(   total:\tmin )[0-9]+, max [0-9]+$/\1<deposit>/' "$stdout"
+    sed -i -E -e 's/"codeDepositCost":"[0-9]+"/"codeDepositCost":"<deposit>"/g' -e 's/"totalCost":\{[^}]*\}/"totalCost":"<deposit>"/g' "$stdout"
+
+    expected_exit=0
+    [ -f "$tdir/exit" ] && expected_exit=$(cat "$tdir/exit")
+
+    local failed=0
+    if [ "$exit_code" -ne "$expected_exit" ]
+    then
+        echo "Error: $tdir: expected exit code $expected_exit, got $exit_code"
+        failed=1
+    fi
+    local expected_stdout="$tdir/output"
+    [ -f "$tdir/input.json" ] && expected_stdout="$tdir/output.json"
+    if ! diff -u "$expected_stdout" "$stdout"
+    then
+        echo "Error: $tdir: unexpected output"
+        failed=1
+    fi
+    if [ -f "$tdir/err" ] && ! diff -u "$tdir/err" "$stderr"
+    then
+        echo "Error: $tdir: unexpected error output"
+        failed=1
+    fi
+
+    rm -rf "$workdir"
+    [ $failed -eq 0 ]
+}
+
+printTask "Running IELE commandline tests..."
+cmdlinetests=0
+cmdlinetests_success=0
+cmdlinetests_excluded=0
+for tdir in "$REPO_ROOT"/test/cmdlineTests/iele_*/
+do
+    runCmdlineTest "${tdir%/}"
+    failed=$?
+    cmdlinetests=$((cmdlinetests+1))
+    [ $failed -eq 0 ] && cmdlinetests_success=$((cmdlinetests_success+1))
+done
+
+total=$((examples+contracts+ctests+doctests+cmdlinetests))
+total_success=$((examples_success+contracts_success+ctests_success+doctests_success+cmdlinetests_success))
+total_excluded=$((examples_excluded+contracts_excluded+ctests_excluded+doctests_excluded+cmdlinetests_excluded))
 printResult "Std examples          " "$examples_success" "$examples" "$examples_excluded"
 printResult "Contracts             " "$contracts_success" "$contracts" "$contracts_excluded"
 printResult "Test-suite examples   " "$ctests_success" "$ctests" "$ctests_excluded"
 printResult "Documentation examples" "$doctests_success" "$doctests" "$doctests_excluded"
+printResult "Commandline tests     " "$cmdlinetests_success" "$cmdlinetests" "$cmdlinetests_excluded"
 printResult "Total tests           " "$total_success" "$total" "$total_excluded"
 
 echo "Done."
@@ -0,0 +1,192 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Golden bytecode tests for the in-process IELE assembler.
+ *
+ * The expected bytecode below is tied to IeleAssembler::Version: any change to
+ * the encoder that makes one of these tests fail must also bump the version,
+ * since cached bytecode produced by the old encoder is no longer valid.
+ */
+
+#include <libiele/IeleAssembler.h>
+#include <libiele/IeleContext.h>
+#include <libiele/IeleContract.h>
+#include <libiele/IeleParser.h>
+
+#include <libsolutil/CommonData.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+using namespace std;
+using namespace solidity::iele;
+
+namespace solidity::iele::test
+{
+
+namespace
+{
+
+string assembleToHex(IeleContract const& _contract)
+{
+	return util::toHex(IeleAssembler::assemble(_contract));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(IeleAssemblerTest, *boost::unit_test::label("nooptions"))
+
+BOOST_AUTO_TEST_CASE(version)
+{
+	// Bump this together with IeleAssembler::Version and update the expected
+	// bytecode of the test cases below.
+	BOOST_CHECK_EQUAL(IeleAssembler::Version, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(empty_contract)
+{
+	// This is the output of kiele for the same contract.
+	IeleContext context;
+	IeleContract* contract = IeleContract::Create(&context, "C");
+	IeleParser(&context).parseFunctions(R"IELE(
+define @init() {
+entry:
+  ret void
+}
+)IELE", contract);
+	BOOST_CHECK_EQUAL(assembleToHex(*contract), "0000000d63006700000000660000f60000");
+}
+
+BOOST_AUTO_TEST_CASE(arithmetic)
+{
+	IeleContext context;
+	IeleContract* contract = IeleContract::Create(&context, "C");
+	IeleParser(&context).parseFunctions(R"IELE(
+define public @init() {
+entry:
+  ret void
+}
+
+define public @"f(uint256)"(%a) {
+entry:
+  %b = add %a, 1
+  %c = mul %b, %a
+  ret %c
+}
+)IELE", contract);
+	BOOST_CHECK_EQUAL(
+		assembleToHex(*contract),
+		"0000002e630269000a662875696e74323536296700000000660000f600006800010001"
+		"66000061c00101014c0290f6000180"
+	);
+}
+
+BOOST_AUTO_TEST_CASE(control_flow_and_constants)
+{
+	IeleContext context;
+	IeleContract* contract = IeleContract::Create(&context, "C");
+	IeleParser(&context).parseFunctions(R"IELE(
+define public @init() {
+entry:
+  ret void
+}
+
+define public @"g(int256)"(%a) {
+entry:
+  %neg = cmp lt %a, 0
+  br %neg, negative
+  %r = add %a, 115792089237316195423570985008687907853269984665640564039457584007913129639936
+  ret %r
+negative:
+  %r = sub %a, -300
+  ret %r
+}
+)IELE", contract);
+	BOOST_CHECK_EQUAL(
+		assembleToHex(*contract),
+		"0000006263026900096728696e74323536296700000000660000f60000680001000166"
+		"000061c000104c6500014061c021010000000000000000000000000000000000000000"
+		"000000000000000000000000018cf600018066000162c002fed4038cf6000180"
+	);
+}
+
+BOOST_AUTO_TEST_CASE(local_calls_and_memory)
+{
+	IeleContext context;
+	IeleContract* contract = IeleContract::Create(&context, "C");
+	IeleParser(&context).parseFunctions(R"IELE(
+define public @init() {
+entry:
+  ret void
+}
+
+define @helper(%x, %y) {
+entry:
+  store %x, %y
+  %z = load %y
+  ret %z
+}
+
+define public @"h()"() {
+entry:
+  %v = call @helper(7, 3)
+  %w = call @iele.gas()
+  ret %v
+}
+)IELE", contract);
+	BOOST_CHECK_EQUAL(
+		assembleToHex(*contract),
+		"0000004b630369000668656c7065726900036828296700000000660000f60000670001"
+		"000266000053045144f600014068000200006600006140010761600103f40001000200"
+		"0109805a20f6000100"
+	);
+}
+
+BOOST_AUTO_TEST_CASE(child_contract)
+{
+	IeleContext context;
+	IeleContract* contract = IeleContract::Create(&context, "C");
+	IeleContract* child = IeleContract::Create(&context, "D", contract);
+	IeleParser(&context).parseFunctions(R"IELE(
+define public @init() {
+entry:
+  ret void
+}
+)IELE", child);
+	IeleParser(&context).parseFunctions(R"IELE(
+define public @init() {
+entry:
+  ret void
+}
+
+define public @"k()"() {
+entry:
+  ret 5
+}
+)IELE", contract);
+	BOOST_CHECK_EQUAL(
+		assembleToHex(*contract),
+		"0000003363006900036b28296a0000000d63006700000000660000f600006700000000"
+		"660000f600006800010000660000610105f60001"
+	);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
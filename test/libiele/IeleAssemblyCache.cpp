@@ -0,0 +1,213 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Unit tests for the persistent cache of assembled IELE bytecode.
+ */
+
+#include <libiele/IeleAssemblyCache.h>
+
+#include <libsolutil/CommonData.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <ctime>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+using namespace solidity::iele;
+using namespace solidity::util;
+
+namespace fs = boost::filesystem;
+
+namespace solidity::iele::test
+{
+
+namespace
+{
+
+/// A fresh directory that is removed with everything in it when the object goes out of scope.
+class TemporaryDirectory
+{
+public:
+	TemporaryDirectory():
+		m_path(fs::temp_directory_path() / fs::unique_path("iele-assembly-cache-test-%%%%-%%%%-%%%%"))
+	{
+		fs::create_directories(m_path);
+	}
+	~TemporaryDirectory()
+	{
+		boost::system::error_code errorCode;
+		fs::remove_all(m_path, errorCode);
+	}
+
+	fs::path const& path() const { return m_path; }
+
+private:
+	fs::path m_path;
+};
+
+vector<fs::path> entries(fs::path const& _directory)
+{
+	vector<fs::path> result;
+	for (fs::directory_entry const& entry: fs::directory_iterator(_directory))
+		if (entry.path().extension() == ".bin")
+			result.push_back(entry.path());
+	return result;
+}
+
+void overwrite(fs::path const& _file, bytes const& _contents)
+{
+	ofstream out(_file.string(), ios::binary | ios::trunc);
+	out.write(reinterpret_cast<char const*>(_contents.data()), static_cast<streamsize>(_contents.size()));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(IeleAssemblyCacheTest, *boost::unit_test::label("nooptions"))
+
+BOOST_AUTO_TEST_CASE(key)
+{
+	BOOST_CHECK(IeleAssemblyCache::key("contract \"A\" {}") == IeleAssemblyCache::key("contract \"A\" {}"));
+	BOOST_CHECK(IeleAssemblyCache::key("contract \"A\" {}") != IeleAssemblyCache::key("contract \"B\" {}"));
+}
+
+BOOST_AUTO_TEST_CASE(miss_then_hit)
+{
+	TemporaryDirectory directory;
+	IeleAssemblyCache cache(directory.path());
+	h256 key = IeleAssemblyCache::key("A");
+	bytes bytecode = fromHex("0000000d63006700000000660000f60000");
+
+	BOOST_CHECK(!cache.lookup(key));
+	cache.store(key, bytecode);
+	optional<bytes> cached = cache.lookup(key);
+	BOOST_REQUIRE(cached);
+	BOOST_CHECK(*cached == bytecode);
+	BOOST_CHECK(!cache.lookup(IeleAssemblyCache::key("B")));
+
+	BOOST_CHECK_EQUAL(cache.hits(), 1);
+	BOOST_CHECK_EQUAL(cache.misses(), 2);
+	BOOST_CHECK_EQUAL(cache.evictions(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(shared_between_instances)
+{
+	TemporaryDirectory directory;
+	h256 key = IeleAssemblyCache::key("A");
+	bytes bytecode = fromHex("00112233");
+	IeleAssemblyCache(directory.path()).store(key, bytecode);
+
+	IeleAssemblyCache cache(directory.path());
+	optional<bytes> cached = cache.lookup(key);
+	BOOST_REQUIRE(cached);
+	BOOST_CHECK(*cached == bytecode);
+	BOOST_CHECK_EQUAL(cache.hits(), 1);
+	BOOST_CHECK_EQUAL(cache.misses(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+	TemporaryDirectory directory;
+	// Every entry takes 32 bytes of checksum plus 10 bytes of bytecode, so
+	// only two of them fit.
+	IeleAssemblyCache cache(directory.path(), 100);
+	h256 keyA = IeleAssemblyCache::key("A");
+	h256 keyB = IeleAssemblyCache::key("B");
+	h256 keyC = IeleAssemblyCache::key("C");
+	bytes bytecode(10, 0x42);
+
+	cache.store(keyA, bytecode);
+	cache.store(keyB, bytecode);
+	BOOST_CHECK_EQUAL(cache.evictions(), 0);
+
+	// A is older than B, but using it makes B the least recently used entry.
+	time_t now = time(nullptr);
+	fs::last_write_time(directory.path() / (keyA.hex() + ".bin"), now - 100);
+	fs::last_write_time(directory.path() / (keyB.hex() + ".bin"), now - 50);
+	BOOST_CHECK(cache.lookup(keyA));
+
+	cache.store(keyC, bytecode);
+	BOOST_CHECK_EQUAL(cache.evictions(), 1);
+	BOOST_CHECK_EQUAL(entries(directory.path()).size(), 2);
+	BOOST_CHECK(cache.lookup(keyA));
+	BOOST_CHECK(!cache.lookup(keyB));
+	BOOST_CHECK(cache.lookup(keyC));
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_entry)
+{
+	TemporaryDirectory directory;
+	IeleAssemblyCache cache(directory.path());
+	h256 key = IeleAssemblyCache::key("A");
+	bytes bytecode = fromHex("0000000d63006700000000660000f60000");
+	cache.store(key, bytecode);
+
+	vector<fs::path> stored = entries(directory.path());
+	BOOST_REQUIRE_EQUAL(stored.size(), 1);
+	bytes contents;
+	{
+		ifstream in(stored[0].string(), ios::binary);
+		contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	}
+	contents.back() ^= 0xff;
+	overwrite(stored[0], contents);
+
+	// The damaged entry is a miss and is dropped, so that it can be replaced.
+	BOOST_CHECK(!cache.lookup(key));
+	BOOST_CHECK(entries(directory.path()).empty());
+	cache.store(key, bytecode);
+	optional<bytes> cached = cache.lookup(key);
+	BOOST_REQUIRE(cached);
+	BOOST_CHECK(*cached == bytecode);
+	BOOST_CHECK_EQUAL(cache.hits(), 1);
+	BOOST_CHECK_EQUAL(cache.misses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(truncated_entry)
+{
+	TemporaryDirectory directory;
+	IeleAssemblyCache cache(directory.path());
+	h256 key = IeleAssemblyCache::key("A");
+	overwrite(directory.path() / (key.hex() + ".bin"), fromHex("0000"));
+
+	BOOST_CHECK(!cache.lookup(key));
+	BOOST_CHECK(entries(directory.path()).empty());
+	BOOST_CHECK_EQUAL(cache.misses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(unusable_directory)
+{
+	TemporaryDirectory directory;
+	// A regular file in place of the cache directory makes every access fail,
+	// also when running with privileges that ignore file permissions.
+	fs::path file = directory.path() / "file";
+	overwrite(file, fromHex("00"));
+
+	IeleAssemblyCache cache(file);
+	h256 key = IeleAssemblyCache::key("A");
+	cache.store(key, fromHex("00112233"));
+	BOOST_CHECK(!cache.lookup(key));
+	BOOST_CHECK_EQUAL(cache.hits(), 0);
+	BOOST_CHECK_EQUAL(cache.misses(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,102 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Tests for the reuse of contracts deployed once by several test cases.
+ */
+
+#include <test/libsolidity/SolidityExecutionFramework.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+using namespace std;
+using namespace solidity::util;
+
+namespace solidity::frontend::test
+{
+
+namespace
+{
+
+static char const* counterCode = R"(
+	contract Counter {
+		uint public count;
+		function increment() public { count++; }
+	}
+)";
+
+/// A test case, with the contracts it deploys once exposed.
+class DeployingCase: public SolidityExecutionFramework
+{
+public:
+	/// Deploys the counter contract under @a _key, unless it was deployed before.
+	/// @returns true if it was deployed.
+	bool deployCounter(string const& _key)
+	{
+		bool deployed = false;
+		deployOnce(_key, [&]{
+			compileAndRun(counterCode, 0, "Counter");
+			deployed = true;
+		});
+		return deployed;
+	}
+
+	h160 const& contractAddress() const { return m_contractAddress; }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(DeploymentSnapshots)
+
+BOOST_AUTO_TEST_CASE(reused_by_later_cases)
+{
+	string const key = "DeploymentSnapshots Counter";
+	h160 address;
+	{
+		DeployingCase first;
+		BOOST_REQUIRE(first.deployCounter(key));
+		address = first.contractAddress();
+		// Changes made after the deployment are not part of its snapshot.
+		first.callContractFunction("increment()");
+		BOOST_CHECK(first.callContractFunction("count()") == first.encodeArgs(1));
+	}
+	{
+		// A case that deploys its own contracts resets the chain.
+		DeployingCase other;
+		other.compileAndRun(counterCode, 0, "Counter");
+		other.callContractFunction("increment()");
+	}
+	{
+		DeployingCase second;
+		BOOST_CHECK(!second.deployCounter(key));
+		BOOST_CHECK_EQUAL(second.contractAddress(), address);
+		BOOST_CHECK(second.callContractFunction("count()") == second.encodeArgs(0));
+		second.callContractFunction("increment()");
+		BOOST_CHECK(second.callContractFunction("count()") == second.encodeArgs(1));
+	}
+	{
+		DeployingCase third;
+		BOOST_CHECK(!third.deployCounter(key));
+		BOOST_CHECK(third.callContractFunction("count()") == third.encodeArgs(0));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -106,6 +106,15 @@ SemanticTest::SemanticTest(string const& _filename, langutil::EVMVersion _evmVer
 
 	m_allowNonExistingFunctions = m_reader.boolSetting("allowNonExistingFunctions", false);
 
+	// Tests that depend on the gas costs of IELE nodes, or on precompiled contracts the
+	// interpreter does not implement, can only run against a node.
+	if (!m_reader.boolSetting("ieleInterpreter", true) && solidity::test::CommonOptions::get().ieleInterpreter)
+		m_shouldRun = false;
+
+	// Tests of the IELE optimizer passes need them to run even without --optimize.
+	if (m_reader.boolSetting("optimize", false))
+		m_optimiserSettings = OptimiserSettings::standard();
+
 	parseExpectations(m_reader.stream());
 	soltestAssert(!m_tests.empty(), "No tests specified in " + _filename);
 }
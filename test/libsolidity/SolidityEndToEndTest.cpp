@@ -1769,6 +1769,45 @@ BOOST_AUTO_TEST_CASE(event_lots_of_data)
 	)
 }
 
+BOOST_AUTO_TEST_CASE(event_fixed_width_data)
+{
+	char const* sourceCode = R"(
+		contract ClientReceipt {
+			enum E { A, B, C }
+			event Signed(int8 indexed _a, int16 _b, int32 _c, int64 _d);
+			event Fused(int24 _a, bytes3 _b, bool _c, address _d, E _e, uint8 _f);
+			event Generic(int24 _a, bytes3 _b, bool _c, address _d, E _e, uint8 _f, bytes _g);
+			function signed(int64 k) public {
+				emit Signed(-int8(k), -int16(k + 1), -int32(k * 300), -int64(k * 5));
+			}
+			function mixed(uint k) public {
+				int24 a = -int24(uint24(k + 1));
+				bytes3 b = bytes3(uint24(0x616263 + k - 1));
+				address d = address(uint160(0x1234 * k));
+				uint8 f = uint8(0xff - k + 1);
+				bytes memory empty;
+				emit Fused(a, b, k % 2 == 1, d, E(k % 3), f);
+				emit Generic(a, b, k % 2 == 1, d, E(k % 3), f, empty);
+			}
+		}
+	)";
+	compileAndRun(sourceCode);
+	callContractFunction("signed(int64)", 1);
+	BOOST_REQUIRE_EQUAL(numLogs(), 1);
+	BOOST_CHECK_EQUAL(toHex(logData(0)), "feffd4fefffffbffffffffffffff");
+	BOOST_REQUIRE_EQUAL(numLogTopics(0), 2);
+	BOOST_CHECK_EQUAL(logTopic(0, 1), h256(solidity::s2u(-1)));
+
+	callContractFunction("mixed(uint)", 1);
+	BOOST_REQUIRE_EQUAL(numLogs(), 2);
+	BOOST_CHECK_EQUAL(
+		toHex(logData(0)),
+		"feffff636261013412" + string(36, '0') + "01ff"
+	);
+	BOOST_CHECK_EQUAL(toHex(logData(1)), toHex(logData(0) + bytes(8, 0)));
+	BOOST_CHECK_EQUAL(logTopic(1, 0), util::keccak256(string("Generic(int24,bytes3,bool,address,uint8,uint8,bytes)")));
+}
+
 BOOST_AUTO_TEST_CASE(event_really_lots_of_data)
 {
 	char const* sourceCode = R"(
@@ -112,7 +112,11 @@ bytes SolidityExecutionFramework::multiSourceCompileContract(
 		}
 	}
 	else
+	{
 		obj = m_compiler.object(contractName);
+		if (m_ieleHost)
+			m_ieleHost->registerContract(obj.bytecode, m_compiler.ieleContract(contractName));
+	}
 	BOOST_REQUIRE(obj.linkReferences.empty());
 	BOOST_TEST_MESSAGE(obj.bytecode.size());
 	if (m_showMetadata)
@@ -29,6 +29,8 @@
 #include <libsolutil/CommonData.h>
 #include <test/Metadata.h>
 
+#include <boost/filesystem.hpp>
+
 #include <algorithm>
 #include <set>
 
@@ -420,7 +422,15 @@ BOOST_AUTO_TEST_CASE(basic_compilation)
                 "\n"
                 "}\n"
 	) == 0);
-	BOOST_CHECK(!contract["evm"]["gasEstimates"].isObject());
+	BOOST_CHECK(contract["evm"]["gasEstimates"].isObject());
+	// The code deposit is charged per byte of the bytecode, whose metadata contains the compiler version.
+	Json::Value const& creation = contract["evm"]["gasEstimates"]["creation"];
+	size_t codeDepositCost = 200 * contract["evm"]["bytecode"]["object"].asString().size() / 2;
+	BOOST_CHECK_EQUAL(creation["codeDepositCost"].asString(), to_string(codeDepositCost));
+	BOOST_CHECK_EQUAL(util::jsonCompactPrint(creation["executionCost"]), "{\"max\":\"4\",\"min\":\"4\"}");
+	BOOST_CHECK_EQUAL(creation["totalCost"]["min"].asString(), to_string(codeDepositCost + 4));
+	BOOST_CHECK_EQUAL(creation["totalCost"]["max"].asString(), to_string(codeDepositCost + 4));
+	BOOST_CHECK(!contract["evm"]["gasEstimates"].isMember("external"));
 	BOOST_CHECK(!contract["evm"]["legacyAssembly"].isObject());
 	BOOST_CHECK(contract["metadata"].isString());
 	BOOST_CHECK(solidity::test::isValidMetadata(contract["metadata"].asString()));
@@ -1194,7 +1204,9 @@ BOOST_AUTO_TEST_CASE(optimizer_settings_details_different)
 	);
 	BOOST_CHECK(optimizer["details"]["yulDetails"]["stackAllocation"].asBool() == true);
 	BOOST_CHECK(optimizer["details"]["yulDetails"]["optimizerSteps"].asString() == OptimiserSettings::DefaultYulOptimiserSteps);
-	BOOST_CHECK_EQUAL(optimizer["details"].getMemberNames().size(), 8);
+	BOOST_CHECK(optimizer["details"]["iele"].asBool() == false);
+	BOOST_CHECK(!optimizer["details"].isMember("ieleDetails"));
+	BOOST_CHECK_EQUAL(optimizer["details"].getMemberNames().size(), 9);
 	BOOST_CHECK(optimizer["runs"].asUInt() == 600);
 }
 
@@ -1709,6 +1721,53 @@ BOOST_AUTO_TEST_CASE(dependency_tracking_of_abstract_contract_yul)
 	BOOST_REQUIRE(result["sources"].size() == 1);
 }
 
+BOOST_AUTO_TEST_CASE(iele_assembly_cache)
+{
+	boost::filesystem::path cacheDirectory =
+		boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("iele-assembly-cache-%%%%-%%%%-%%%%");
+	string input = R"(
+	{
+		"language": "Solidity",
+		"sources": {
+			"A.sol": {
+				"content": "contract A {} contract B { function f() public { new A(); } }"
+			}
+		},
+		"settings": {
+			"ieleAssemblyCache": { "directory": ")" + cacheDirectory.string() + R"(" },
+			"outputSelection": {
+				"A.sol": { "*": ["evm.bytecode.object"] }
+			}
+		}
+	}
+	)";
+
+	Json::Value first = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(first));
+	BOOST_REQUIRE(first["ieleAssemblyCache"].isObject());
+	BOOST_CHECK_EQUAL(first["ieleAssemblyCache"]["misses"].asUInt(), 2);
+	BOOST_CHECK_EQUAL(first["ieleAssemblyCache"]["evictions"].asUInt(), 0);
+
+	// Nothing needs to be assembled again on a second run against the same directory.
+	Json::Value second = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(second));
+	BOOST_REQUIRE(second["ieleAssemblyCache"].isObject());
+	BOOST_CHECK_EQUAL(second["ieleAssemblyCache"]["misses"].asUInt(), 0);
+	BOOST_CHECK_EQUAL(
+		second["ieleAssemblyCache"]["hits"].asUInt(),
+		first["ieleAssemblyCache"]["hits"].asUInt() + first["ieleAssemblyCache"]["misses"].asUInt()
+	);
+	BOOST_CHECK_EQUAL(second["ieleAssemblyCache"]["evictions"].asUInt(), 0);
+	BOOST_CHECK(
+		second["contracts"]["A.sol"]["B"]["evm"]["bytecode"]["object"] ==
+		first["contracts"]["A.sol"]["B"]["evm"]["bytecode"]["object"]
+	);
+
+	boost::system::error_code errorCode;
+	boost::filesystem::remove_all(cacheDirectory, errorCode);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // end namespaces
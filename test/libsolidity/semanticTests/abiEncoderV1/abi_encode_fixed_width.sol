@@ -0,0 +1,100 @@
+// Tuples of fixed-width values are encoded with a single store. An empty byte
+// array added to such a tuple makes it go through the encoding of each value
+// in turn, which must produce the same bytes.
+contract C {
+    enum E { A, B, C }
+
+    function same(bytes memory x, bytes memory y) internal pure returns (bool) {
+        return keccak256(x) == keccak256(y);
+    }
+
+    function signedEncode(uint k) public pure returns (bool, bool) {
+        int8 a = -int8(uint8(k));
+        int16 b = -int16(uint16(k + 1));
+        int32 c = -int32(uint32(k * 300));
+        int64 d = int64(uint64(k * 5));
+        bytes memory fused = abi.encode(a, b, c, d);
+        return (
+            same(fused, hex"fffeffd4feffff0500000000000000"),
+            same(abi.encodePacked(a, b, c, d), hex"fffffefffffed40000000000000005")
+        );
+    }
+
+    function limits(uint k) public pure returns (bool, bool) {
+        int8 a = int8(-128) + int8(uint8(k - 1));
+        int64 b = int64(-1) * int64(uint64(k));
+        bytes1 c = bytes1(uint8(k * 0x7a));
+        return (
+            same(abi.encodePacked(a, b, c), hex"80ffffffffffffffff7a"),
+            same(abi.encode(a, b, c), hex"80ffffffffffffffff7a")
+        );
+    }
+
+    function mixed(uint k) internal pure returns (int24 a, bytes3 b, bool c, address d, E e, uint8 f) {
+        a = -int24(uint24(k + 1));
+        b = bytes3(uint24(0x616263 + k - 1));
+        c = k % 2 == 1;
+        d = address(uint160(0x1234 * k));
+        e = E(k % 3);
+        f = uint8(0xff - k + 1);
+    }
+
+    function mixedEncode(uint k) public pure returns (bool, bool) {
+        (int24 a, bytes3 b, bool c, address d, E e, uint8 f) = mixed(k);
+        return (
+            same(abi.encode(a, b, c, d, e, f), hex"feffff63626101341200000000000000000000000000000000000001ff"),
+            same(abi.encodePacked(a, b, c, d, e, f), hex"fffffe61626301000000000000000000000000000000000000123401ff")
+        );
+    }
+
+    function packedMatches(uint k) public pure returns (bool) {
+        (int24 a, bytes3 b, bool c, address d, E e, uint8 f) = mixed(k);
+        bytes memory empty;
+        return same(abi.encodePacked(a, b, c, d, e, f),
+                    abi.encodePacked(a, b, c, d, e, f, empty));
+    }
+
+    // The generic encoding adds the length of the empty array, which is zero,
+    // after the encoding of the other values.
+    function encodeMatches(uint k) public pure returns (bool) {
+        (int24 a, bytes3 b, bool c, address d, E e, uint8 f) = mixed(k);
+        bytes memory empty;
+        bytes memory fused = abi.encode(a, b, c, d, e, f);
+        bytes memory generic = abi.encode(a, b, c, d, e, f, empty);
+        if (generic.length != fused.length + 8)
+            return false;
+        for (uint i = 0; i < fused.length; i++)
+            if (fused[i] != generic[i])
+                return false;
+        for (uint i = fused.length; i < generic.length; i++)
+            if (generic[i] != 0)
+                return false;
+        return true;
+    }
+
+    function hashMatches(uint k) public pure returns (bool, bool) {
+        int64 a = -int64(uint64(k));
+        int8 b = int8(-128) + int8(uint8(k));
+        bytes1 c = bytes1(uint8(k));
+        bytes memory empty;
+        return (
+            keccak256(abi.encodePacked(a, b, c)) ==
+                keccak256(abi.encodePacked(empty, a, b, c)),
+            sha256(abi.encodePacked(a, b, c)) ==
+                sha256(abi.encodePacked(a, b, empty, c))
+        );
+    }
+}
+// ----
+// signedEncode(uint): 1 -> true, true
+// limits(uint): 1 -> true, true
+// mixedEncode(uint): 1 -> true, true
+// packedMatches(uint): 0 -> true
+// packedMatches(uint): 1 -> true
+// packedMatches(uint): 2 -> true
+// encodeMatches(uint): 0 -> true
+// encodeMatches(uint): 1 -> true
+// encodeMatches(uint): 2 -> true
+// hashMatches(uint): 0 -> true, true
+// hashMatches(uint): 1 -> true, true
+// hashMatches(uint): 127 -> true, true
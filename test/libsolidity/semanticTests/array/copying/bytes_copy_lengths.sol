@@ -0,0 +1,53 @@
+// Byte arrays keep their bytes in one cell after the length, which copies
+// move as a whole. Lengths around a word boundary and slices must keep every
+// byte and no stale ones.
+contract C {
+    bytes s;
+
+    function pattern(uint n, uint first) internal pure returns (bytes memory b) {
+        b = new bytes(n);
+        for (uint i = 0; i < n; i++)
+            b[i] = bytes1(uint8((first + i) * 7 % 256));
+    }
+
+    function memoryToStorage(uint n) public returns (uint, bool) {
+        s = pattern(40, 3);
+        bytes memory m = pattern(n, 0);
+        s = m;
+        return (s.length, keccak256(s) == keccak256(pattern(n, 0)));
+    }
+
+    function storageToMemory(uint n) public returns (uint, bool) {
+        s = pattern(n, 0);
+        bytes memory m = s;
+        s = pattern(40, 3);
+        return (m.length, keccak256(m) == keccak256(pattern(n, 0)));
+    }
+
+    function sliceOf(bytes calldata b, uint start, uint end) external pure returns (bytes memory) {
+        bytes memory m = b[start:end];
+        return m;
+    }
+
+    function slice(uint n, uint start, uint end) public view returns (uint, bool) {
+        bytes memory m = this.sliceOf(pattern(n, 0), start, end);
+        return (m.length, keccak256(m) == keccak256(pattern(end - start, start)));
+    }
+}
+// ----
+// memoryToStorage(uint): 0 -> 0, true
+// memoryToStorage(uint): 31 -> 31, true
+// memoryToStorage(uint): 32 -> 32, true
+// memoryToStorage(uint): 33 -> 33, true
+// memoryToStorage(uint): 1000 -> 1000, true
+// storageToMemory(uint): 0 -> 0, true
+// storageToMemory(uint): 31 -> 31, true
+// storageToMemory(uint): 32 -> 32, true
+// storageToMemory(uint): 33 -> 33, true
+// storageToMemory(uint): 1000 -> 1000, true
+// slice(uint,uint,uint): 40, 0, 0 -> 0, true
+// slice(uint,uint,uint): 40, 5, 36 -> 31, true
+// slice(uint,uint,uint): 40, 0, 32 -> 32, true
+// slice(uint,uint,uint): 40, 7, 40 -> 33, true
+// slice(uint,uint,uint): 1000, 3, 997 -> 994, true
+// slice(uint,uint,uint): 40, 5, 41 -> FAILURE, 255
@@ -6,5 +6,6 @@ contract C {
 
 // ====
 // compileViaYul: also
+// ieleInterpreter: false
 // ----
 // f() -> 0x009c1185a5c5e9fc54612808977ee8f548b2258d31
@@ -5,6 +5,7 @@ contract test {
 }
 // ====
 // compileViaYul: also
+// ieleInterpreter: false
 // ----
 // a(bytes32,uint8,bytes32,bytes32):
 // 0x18c547e4f7b0f325ad1e56f57e26c745b09a3e503d86e00e5255ff7f715d3d1c,
@@ -8,5 +8,6 @@ contract C {
 }
 // ====
 // compileViaYul: also
+// ieleInterpreter: false
 // ----
 // f() -> 0
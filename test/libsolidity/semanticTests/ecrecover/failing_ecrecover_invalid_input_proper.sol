@@ -18,5 +18,6 @@ contract C {
 }
 // ====
 // compileViaYul: also
+// ieleInterpreter: false
 // ----
 // f() -> 0
@@ -12,6 +12,7 @@ contract C {
 }
 // ====
 // compileViaYul: also
+// ieleInterpreter: false
 // ----
 // (), 1 ether
 // call() -> 1, 2, 2, 2
@@ -0,0 +1,55 @@
+// Repeated expressions, including the hashes of mapping keys, are only reused
+// while their operands and, for sha3, the memory they hash are unchanged.
+contract C {
+    mapping(uint => uint) m;
+    mapping(uint => mapping(uint => uint)) n;
+
+    function keysInLoop(uint k, uint count) public returns (uint) {
+        for (uint i = 0; i < count; i++)
+            m[k + i] += m[k] + 1;
+        return m[k] + m[k + count - 1];
+    }
+
+    function keyReassigned(uint k) public returns (uint, uint) {
+        m[k] = 10;
+        uint a = m[k];
+        k = k + 1;
+        m[k] = 20;
+        return (a, m[k]);
+    }
+
+    function nested(uint a, uint b) public returns (uint, uint, uint) {
+        n[a][b] = 1;
+        n[b][a] = 2;
+        n[a][a] = 3;
+        return (n[a][b], n[b][a], n[a][a]);
+    }
+
+    function hashReusedMemory(uint a, uint b) public pure returns (bool, bool) {
+        bytes32 h1 = keccak256(abi.encodePacked(a));
+        bytes32 h2 = keccak256(abi.encodePacked(b));
+        bytes32 h3 = keccak256(abi.encodePacked(a));
+        return (h1 == h2, h1 == h3);
+    }
+
+    function expressionInBranches(uint a, uint b, bool c) public pure returns (uint) {
+        uint r;
+        if (c)
+            r = a * b;
+        else
+            a = a + 1;
+        return r + a * b;
+    }
+}
+// ====
+// optimize: true
+// ----
+// keysInLoop(uint,uint): 5, 0 -> 0
+// keysInLoop(uint,uint): 5, 3 -> 3
+// keyReassigned(uint): 7 -> 10, 20
+// nested(uint,uint): 1, 2 -> 1, 2, 3
+// nested(uint,uint): 4, 4 -> 3, 3, 3
+// hashReusedMemory(uint,uint): 1, 2 -> false, true
+// hashReusedMemory(uint,uint): 3, 3 -> true, true
+// expressionInBranches(uint,uint,bool): 2, 3, true -> 12
+// expressionInBranches(uint,uint,bool): 2, 3, false -> 9
@@ -0,0 +1,35 @@
+// Folding must follow the semantics of IELE on signed values and of
+// truncating conversions.
+contract C {
+    function signedDivision() public pure returns (int, int, int) {
+        int a = -7;
+        return (a / 2, a % 3, a >> 1);
+    }
+
+    function conversions() public pure returns (int8, uint8, uint16) {
+        int256 v = 200;
+        uint256 w = 300;
+        uint256 x = 0x12345;
+        return (int8(v), uint8(w), uint16(x));
+    }
+
+    function negation() public pure returns (int, uint256) {
+        int a = 5;
+        uint256 b = 0;
+        return (-a, ~b);
+    }
+
+    function exponentiation(uint256 e) public pure returns (uint256) {
+        uint256 b = 2;
+        uint256 k = 10;
+        return b ** k + b ** e;
+    }
+}
+// ====
+// optimize: true
+// ----
+// signedDivision() -> -3, -1, -4
+// conversions() -> -56, 44, 0x2345
+// negation() -> -5, 115792089237316195423570985008687907853269984665640564039457584007913129639935
+// exponentiation(uint256): 3 -> 1032
+// exponentiation(uint256): 256 -> FAILURE, 255
@@ -0,0 +1,50 @@
+// Values that are constant on entry to a loop or on one side of a branch must
+// not be treated as constant where another definition reaches.
+contract C {
+    function loop(uint n) public pure returns (uint) {
+        uint x = 1;
+        uint y = 7;
+        for (uint i = 0; i < n; i++) {
+            y = x + 6;
+            x = x * 2;
+        }
+        return x + y;
+    }
+
+    function branch(bool c) public pure returns (uint) {
+        uint a = 5;
+        if (c)
+            a = 7;
+        return a * 2;
+    }
+
+    function deadBranch(uint n) public pure returns (uint r) {
+        uint k = 3;
+        if (k > 5)
+            r = n;
+        else
+            r = k + 1;
+        while (k < n)
+            k += 10;
+        r += k;
+    }
+
+    function divisionByZero(bool c) public pure returns (uint) {
+        uint z = 0;
+        if (c)
+            return 10 / z;
+        return 10 / (z + 2);
+    }
+}
+// ====
+// optimize: true
+// ----
+// loop(uint): 0 -> 8
+// loop(uint): 1 -> 9
+// loop(uint): 3 -> 18
+// branch(bool): false -> 10
+// branch(bool): true -> 14
+// deadBranch(uint): 0 -> 7
+// deadBranch(uint): 20 -> 27
+// divisionByZero(bool): false -> 5
+// divisionByZero(bool): true -> FAILURE, 4
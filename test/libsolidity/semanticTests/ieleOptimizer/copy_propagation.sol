@@ -0,0 +1,48 @@
+// A copy can only replace its source while neither of them is redefined, and
+// registers can only be merged if their live ranges do not interfere.
+contract C {
+    function swapLoop(uint a, uint b, uint n) public pure returns (uint, uint) {
+        for (uint i = 0; i < n; i++)
+            (a, b) = (b, a + b);
+        return (a, b);
+    }
+
+    function redefinedSource(uint x) public pure returns (uint, uint) {
+        uint y = x;
+        x = x + 1;
+        return (x, y);
+    }
+
+    function redefinedOnBranch(uint x, bool c) public pure returns (uint) {
+        uint y = x;
+        if (c)
+            x = 100;
+        return x + y;
+    }
+
+    function copyAcrossLoop(uint n) public pure returns (uint last, uint previous) {
+        for (uint i = 1; i <= n; i++) {
+            previous = last;
+            last = i * i;
+        }
+    }
+
+    function overwrittenArgument(uint a) public pure returns (uint, uint) {
+        uint b = a;
+        a = b * 2;
+        b = a + b;
+        return (a, b);
+    }
+}
+// ====
+// optimize: true
+// ----
+// swapLoop(uint,uint,uint): 0, 1, 0 -> 0, 1
+// swapLoop(uint,uint,uint): 0, 1, 10 -> 55, 89
+// redefinedSource(uint): 4 -> 5, 4
+// redefinedOnBranch(uint,bool): 3, false -> 6
+// redefinedOnBranch(uint,bool): 3, true -> 103
+// copyAcrossLoop(uint): 0 -> 0, 0
+// copyAcrossLoop(uint): 1 -> 1, 0
+// copyAcrossLoop(uint): 4 -> 16, 9
+// overwrittenArgument(uint): 7 -> 14, 21
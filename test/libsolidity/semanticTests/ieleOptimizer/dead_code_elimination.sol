@@ -0,0 +1,62 @@
+// Instructions whose results are unused must stay if they have side effects
+// or can fail, and values used only in a later loop iteration are live.
+contract C {
+    uint counter;
+
+    function bump() internal returns (uint) {
+        counter++;
+        return counter;
+    }
+
+    function discardedCall() public returns (uint) {
+        bump();
+        bump();
+        return counter;
+    }
+
+    function unusedDivision(uint a, uint b) public pure returns (uint) {
+        uint q = a / b;
+        return 1;
+    }
+
+    function unusedOverflow(uint256 a) public pure returns (uint) {
+        uint256 x = a + 1;
+        return 2;
+    }
+
+    function memoryStore(uint i) public pure returns (uint) {
+        uint[] memory arr = new uint[](3);
+        arr[i] = 5;
+        return arr[1];
+    }
+
+    function loopCarried(uint n) public pure returns (uint r) {
+        uint carry = 0;
+        for (uint i = 0; i < n; i++) {
+            r += carry;
+            carry = i;
+        }
+    }
+
+    function afterRevert(bool c) public pure returns (uint) {
+        if (c)
+            revert();
+        return 3;
+    }
+}
+// ====
+// optimize: true
+// ----
+// discardedCall() -> 2
+// discardedCall() -> 4
+// unusedDivision(uint,uint): 4, 2 -> 1
+// unusedDivision(uint,uint): 4, 0 -> FAILURE, 4
+// unusedOverflow(uint256): 1 -> 2
+// unusedOverflow(uint256): 115792089237316195423570985008687907853269984665640564039457584007913129639935 -> FAILURE, 255
+// memoryStore(uint): 1 -> 5
+// memoryStore(uint): 2 -> 0
+// memoryStore(uint): 3 -> FAILURE, 255
+// loopCarried(uint): 0 -> 0
+// loopCarried(uint): 4 -> 3
+// afterRevert(bool): false -> 3
+// afterRevert(bool): true -> FAILURE, 255
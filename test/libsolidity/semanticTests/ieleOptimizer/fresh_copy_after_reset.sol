@@ -0,0 +1,60 @@
+// Arrays copied into memory are not cleared after the copy, since freshly
+// allocated memory is zero. This must hold for memory released by an internal
+// function called in a loop, which was written before it was released.
+contract C {
+    uint[] short;
+    uint[2] pair;
+
+    constructor() {
+        short.push(7);
+        short.push(8);
+        pair[0] = 5;
+        pair[1] = 6;
+    }
+
+    function dirty(uint n) internal pure returns (uint s) {
+        uint[] memory a = new uint[](n);
+        for (uint i = 0; i < n; i++) {
+            a[i] = i + 1;
+            s += a[i];
+        }
+    }
+
+    function copyShort(uint n) internal view returns (uint s, uint tail) {
+        uint[] memory m = short;
+        uint[2] memory p = pair;
+        uint[] memory longer = new uint[](n);
+        for (uint i = 0; i < m.length; i++)
+            longer[i] = m[i] + p[i];
+        s = m.length + m[0] + m[1] + p[0] + p[1];
+        for (uint i = m.length; i < n; i++)
+            tail += longer[i];
+    }
+
+    function inLoop(uint k) public view returns (uint total, uint copied, uint tail) {
+        for (uint j = 0; j < k; j++) {
+            total += dirty(10);
+            (uint s, uint t) = copyShort(8);
+            copied += s;
+            tail += t;
+        }
+    }
+
+    function afterLoop(uint k) public view returns (uint total, uint copied, uint tail) {
+        for (uint j = 0; j < k; j++)
+            total += dirty(10);
+        uint[] memory m = short;
+        uint[] memory longer = new uint[](8);
+        for (uint i = 0; i < m.length; i++)
+            longer[i] = m[i];
+        copied = m.length + m[0] + m[1];
+        for (uint i = m.length; i < longer.length; i++)
+            tail += longer[i];
+    }
+}
+// ====
+// optimize: true
+// ----
+// inLoop(uint): 0 -> 0, 0, 0
+// inLoop(uint): 3 -> 165, 84, 0
+// afterLoop(uint): 3 -> 165, 17, 0
@@ -0,0 +1,54 @@
+// The registers of an inlined copy of a function must start out as zero on
+// every execution of the call, like those of the function itself.
+contract C {
+    uint x;
+
+    function pick(uint a) internal pure returns (uint r) {
+        if (a % 2 == 1)
+            r = a;
+    }
+
+    function sum(uint n) public pure returns (uint s) {
+        for (uint i = 0; i < n; i++)
+            s += pick(i);
+    }
+
+    function countUp(uint a) internal pure returns (uint) {
+        uint c;
+        while (c < a)
+            c++;
+        return c;
+    }
+
+    function twice(uint a, uint b) public pure returns (uint, uint) {
+        return (countUp(a), countUp(b));
+    }
+
+    function bump(uint v) internal returns (uint old) {
+        old = x;
+        x = v;
+    }
+
+    function bumpInLoop(uint n) public returns (uint s) {
+        for (uint i = 1; i <= n; i++)
+            s += bump(i);
+    }
+
+    function check(uint a) internal pure returns (uint) {
+        require(a < 10);
+        return a * 2;
+    }
+
+    function checked(uint a, uint b) public pure returns (uint) {
+        return check(a) + check(b);
+    }
+}
+// ====
+// optimize: true
+// ----
+// sum(uint): 4 -> 4
+// sum(uint): 7 -> 9
+// twice(uint,uint): 5, 2 -> 5, 2
+// bumpInLoop(uint): 4 -> 6
+// checked(uint,uint): 3, 4 -> 14
+// checked(uint,uint): 3, 10 -> FAILURE, 255
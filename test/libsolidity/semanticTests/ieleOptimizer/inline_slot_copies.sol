@@ -0,0 +1,84 @@
+// Copies and fills of at most ieleInlineCopySlots (4) slots are emitted as
+// single loads and stores instead of calls to the runtime. The structs and
+// arrays here have exactly 4 slots or one more.
+contract C {
+    struct Inner {
+        uint x;
+        uint y;
+    }
+    struct Four {
+        uint a;
+        Inner inner;
+        uint d;
+    }
+    struct Five {
+        uint a;
+        Inner inner;
+        uint d;
+        uint e;
+    }
+
+    Four four;
+    Four fourCopy;
+    Five five;
+    Five fiveCopy;
+    uint[4] arrayFour;
+    uint[4] arrayFourCopy;
+    uint[5] arrayFive;
+    uint[5] arrayFiveCopy;
+
+    function set(uint v) public {
+        four = Four(v, Inner(v + 1, v + 2), v + 3);
+        five = Five(v, Inner(v + 1, v + 2), v + 3, v + 4);
+        for (uint i = 0; i < 4; i++)
+            arrayFour[i] = v + i;
+        for (uint i = 0; i < 5; i++)
+            arrayFive[i] = v + i;
+    }
+
+    function copyStructs() public returns (uint, uint, uint, uint, uint, uint, uint, uint, uint) {
+        fourCopy = four;
+        fiveCopy = five;
+        return (fourCopy.a, fourCopy.inner.x, fourCopy.inner.y, fourCopy.d,
+                fiveCopy.a, fiveCopy.inner.x, fiveCopy.inner.y, fiveCopy.d, fiveCopy.e);
+    }
+
+    function copyInner() public returns (uint, uint, uint, uint) {
+        fourCopy.inner = five.inner;
+        Inner memory m = four.inner;
+        m.x += 10;
+        fiveCopy.inner = m;
+        return (fourCopy.inner.x, fourCopy.inner.y, fiveCopy.inner.x, fiveCopy.inner.y);
+    }
+
+    function copyArrays() public returns (uint, uint, uint, uint) {
+        arrayFourCopy = arrayFour;
+        arrayFiveCopy = arrayFive;
+        uint[4] memory m4 = arrayFour;
+        uint[5] memory m5 = arrayFive;
+        m4[3] += 100;
+        m5[4] += 100;
+        arrayFour = m4;
+        arrayFive = m5;
+        return (arrayFourCopy[3], arrayFiveCopy[4], arrayFour[3], arrayFive[4]);
+    }
+
+    function deleteAll() public returns (uint, uint, uint, uint, uint, uint) {
+        delete fourCopy;
+        delete fiveCopy;
+        delete arrayFourCopy;
+        delete arrayFiveCopy;
+        uint[5] memory m = arrayFive;
+        delete m;
+        return (fourCopy.d + fourCopy.inner.y, fiveCopy.e + fiveCopy.inner.y,
+                arrayFourCopy[3], arrayFiveCopy[4], m[4], arrayFive[4]);
+    }
+}
+// ====
+// optimize: true
+// ----
+// set(uint): 10 ->
+// copyStructs() -> 10, 11, 12, 13, 10, 11, 12, 13, 14
+// copyInner() -> 11, 12, 21, 12
+// copyArrays() -> 13, 14, 113, 114
+// deleteAll() -> 0, 0, 0, 0, 0, 114
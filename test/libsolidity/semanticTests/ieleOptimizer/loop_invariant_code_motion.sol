@@ -0,0 +1,68 @@
+// Only instructions whose operands do not change in a loop are hoisted out of
+// it, loads only if the loop does not write the location, and instructions
+// that may throw only if the loop is known to execute them.
+contract C {
+    uint x;
+    uint[] a;
+
+    function storageWrittenInLoop(uint n) public returns (uint s) {
+        x = 1;
+        for (uint i = 0; i < n; i++) {
+            s += x;
+            x = x * 2;
+        }
+    }
+
+    function zeroTripDivision(uint a, uint b, uint n) public pure returns (uint s) {
+        for (uint i = 0; i < n; i++)
+            s += a / b;
+    }
+
+    function guardedDivision(uint a, uint b, uint n) public pure returns (uint s) {
+        for (uint i = 0; i < n; i++)
+            if (b != 0)
+                s += a / b;
+    }
+
+    function nested(uint n, uint m) public pure returns (uint s) {
+        for (uint i = 0; i < n; i++)
+            for (uint j = 0; j < m; j++)
+                s += i * 10 + n * m;
+    }
+
+    function shortCircuitDivision(bool flag, uint x, uint y) public pure returns (uint n) {
+        while (flag || x / y > 0) {
+            n++;
+            if (n == 3)
+                break;
+        }
+    }
+
+    function push(uint v) internal {
+        a.push(v);
+    }
+
+    function lengthChangedByCall(uint n) public returns (uint s) {
+        for (uint i = 0; i < n; i++) {
+            push(i);
+            s += a.length;
+        }
+    }
+}
+// ====
+// optimize: true
+// ----
+// storageWrittenInLoop(uint): 0 -> 0
+// storageWrittenInLoop(uint): 4 -> 15
+// zeroTripDivision(uint,uint,uint): 7, 0, 0 -> 0
+// zeroTripDivision(uint,uint,uint): 7, 2, 3 -> 9
+// zeroTripDivision(uint,uint,uint): 7, 0, 1 -> FAILURE, 4
+// guardedDivision(uint,uint,uint): 7, 0, 3 -> 0
+// guardedDivision(uint,uint,uint): 7, 2, 3 -> 9
+// nested(uint,uint): 0, 5 -> 0
+// nested(uint,uint): 2, 3 -> 66
+// shortCircuitDivision(bool,uint,uint): true, 7, 0 -> 3
+// shortCircuitDivision(bool,uint,uint): false, 7, 2 -> 3
+// shortCircuitDivision(bool,uint,uint): false, 0, 2 -> 0
+// shortCircuitDivision(bool,uint,uint): false, 7, 0 -> FAILURE, 4
+// lengthChangedByCall(uint): 3 -> 6
@@ -0,0 +1,71 @@
+// Modifiers used by several functions are compiled into shared functions
+// for the code before and after the placeholder, which take and return the
+// parameters and local variables of the modifier.
+contract C {
+    address owner = msg.sender;
+    uint calls;
+    uint depth;
+    uint limit = 100;
+    uint trace;
+
+    modifier counted(uint weight) {
+        require(msg.sender == owner);
+        require(weight > 0 && weight < 100);
+        uint before = calls;
+        uint mark = depth * 100 + weight;
+        calls += weight;
+        depth++;
+        _;
+        depth--;
+        trace = trace * 1000 + mark;
+        require(calls - before >= weight);
+        require(calls <= limit);
+    }
+
+    function early(uint x) public counted(1) returns (uint) {
+        if (x > 5)
+            return x * 2;
+        return x + 1;
+    }
+
+    function twice(uint x) public counted(2) counted(3) returns (uint) {
+        return x + depth;
+    }
+
+    function tooMuch() public counted(50) returns (uint) {
+        return calls;
+    }
+
+    function plain() public counted(4) {
+    }
+
+    function setLimit(uint l) public {
+        limit = l;
+    }
+
+    function reset() public {
+        trace = 0;
+    }
+
+    function getTrace() public view returns (uint) {
+        return trace;
+    }
+}
+// ====
+// optimize: true
+// ----
+// early(uint): 7 -> 14
+// early(uint): 2 -> 3
+// getTrace() -> 1001
+// reset() ->
+// twice(uint): 10 -> 12
+// getTrace() -> 103002
+// plain() ->
+// getTrace() -> 103002004
+// reset() ->
+// tooMuch() -> 61
+// tooMuch() -> FAILURE, 255
+// getTrace() -> 50
+// setLimit(uint): 1000 ->
+// tooMuch() -> 111
+// getTrace() -> 50050
@@ -0,0 +1,29 @@
+// Exercises the default IELE pass pipeline on a mix of loops, branches,
+// storage accesses and internal calls, where later passes work on the output
+// of earlier ones.
+contract C {
+    mapping(uint => uint) m;
+    uint total;
+
+    function twice(uint a) internal pure returns (uint) {
+        return a + a;
+    }
+
+    function f(uint n) public returns (uint) {
+        for (uint i = 0; i < n; i++) {
+            uint k = i % 3;
+            if (k == 0)
+                m[k] += twice(i);
+            else
+                m[k] += i;
+            total += m[k];
+        }
+        return total + m[0] + m[1] + m[2];
+    }
+}
+// ====
+// optimize: true
+// ----
+// f(uint): 0 -> 0
+// f(uint): 5 -> 27
+// f(uint): 3 -> 46
@@ -0,0 +1,58 @@
+// Range checks may only be dropped where the operands are known to be in
+// range on every path, including later loop iterations.
+contract C {
+    function narrowAdd(uint8 x) public pure returns (uint8) {
+        if (x < 200)
+            return x + 55;
+        return x + 1;
+    }
+
+    function guardedSubtraction(uint a, uint b) public pure returns (uint) {
+        if (a >= b)
+            return a - b;
+        return b - a;
+    }
+
+    function wrongSideSubtraction(uint a, uint b) public pure returns (uint) {
+        if (a >= b)
+            return b - a;
+        return 0;
+    }
+
+    function loopOverflow(uint8 start, uint8 n) public pure returns (uint8 i) {
+        i = start;
+        for (uint8 k = 0; k < n; k++)
+            i++;
+    }
+
+    function masked(uint256 x) public pure returns (uint8, uint8) {
+        uint8 y = uint8(x & 0x7f);
+        uint8 z = uint8(x & 0xff);
+        return (y + 128, z + 1);
+    }
+
+    function negate(int8 x) public pure returns (int8) {
+        if (x < 0)
+            return -x;
+        return x;
+    }
+}
+// ====
+// optimize: true
+// ----
+// narrowAdd(uint8): 199 -> 254
+// narrowAdd(uint8): 200 -> 201
+// narrowAdd(uint8): 254 -> 255
+// narrowAdd(uint8): 255 -> FAILURE, 255
+// guardedSubtraction(uint,uint): 7, 3 -> 4
+// guardedSubtraction(uint,uint): 3, 7 -> 4
+// wrongSideSubtraction(uint,uint): 3, 3 -> 0
+// wrongSideSubtraction(uint,uint): 7, 3 -> FAILURE, 255
+// wrongSideSubtraction(uint,uint): 3, 7 -> 0
+// loopOverflow(uint8,uint8): 250, 5 -> 255
+// loopOverflow(uint8,uint8): 250, 6 -> FAILURE, 255
+// masked(uint256): 254 -> 254, 255
+// masked(uint256): 255 -> FAILURE, 255
+// negate(int8): -127 -> 127
+// negate(int8): -128 -> FAILURE, 255
+// negate(int8): 5 -> 5
@@ -0,0 +1,51 @@
+// Memory allocated by an internal function called in a loop is released when
+// the function returns, and must read as zero when it is allocated again.
+contract C {
+    struct S { uint a; uint b; }
+
+    function fill(uint n) internal pure returns (uint s) {
+        uint[] memory a = new uint[](n);
+        for (uint i = 0; i < n; i++) {
+            a[i] = i + 1;
+            s += a[i];
+        }
+    }
+
+    function fresh(uint n) internal pure returns (uint s) {
+        uint[] memory a = new uint[](n);
+        for (uint i = 0; i < n; i++)
+            s += a[i];
+    }
+
+    function freshStruct(uint v) internal pure returns (uint) {
+        S memory x;
+        uint r = x.a + x.b;
+        x.a = v;
+        x.b = v;
+        return r;
+    }
+
+    function reallocated(uint k) public pure returns (uint total, uint dirty) {
+        for (uint j = 0; j < k; j++) {
+            total += fill(3);
+            dirty += fresh(5);
+            dirty += freshStruct(j + 1);
+        }
+    }
+
+    function allocatedByCaller(uint k) public pure returns (uint total, uint dirty) {
+        for (uint j = 0; j < k; j++) {
+            total += fill(4);
+            uint[] memory b = new uint[](4);
+            for (uint i = 0; i < 4; i++)
+                dirty += b[i];
+            b[0] = 7;
+        }
+    }
+}
+// ====
+// optimize: true
+// ----
+// reallocated(uint): 0 -> 0, 0
+// reallocated(uint): 4 -> 24, 0
+// allocatedByCaller(uint): 3 -> 30, 0
@@ -0,0 +1,83 @@
+// Known storage values are forwarded to later loads, also across blocks, and
+// redundant or overwritten stores are removed, but only while no store, call
+// or branch can observe or change the storage in between.
+contract C {
+    mapping(uint => uint) m;
+    uint x;
+    uint y;
+
+    function aliasing(uint a, uint b) public returns (uint, uint) {
+        m[a] = 1;
+        m[b] = 2;
+        return (m[a], m[b]);
+    }
+
+    function storeInLoop(uint n) public returns (uint, uint) {
+        x = 1;
+        uint s = 0;
+        for (uint i = 0; i < n; i++) {
+            s += x;
+            x = x + 1;
+        }
+        return (s, x);
+    }
+
+    function storeOnBranch(bool c) public returns (uint) {
+        x = 5;
+        if (c)
+            x = 7;
+        return x;
+    }
+
+    function knownAcrossBranch(bool c) public returns (uint) {
+        x = 5;
+        uint r = 0;
+        if (c)
+            r = 1;
+        return x + r;
+    }
+
+    function setY(uint v) internal {
+        y = v;
+        x = v;
+    }
+
+    function callInBetween(uint v) public returns (uint, uint) {
+        x = 1;
+        y = 1;
+        setY(v);
+        return (x, y);
+    }
+
+    function overwrittenThenRevert(bool c) public returns (uint) {
+        x = 1;
+        require(!c);
+        x = 2;
+        return x;
+    }
+
+    function readX() public view returns (uint) {
+        return x;
+    }
+
+    function readM(uint k) public view returns (uint) {
+        return m[k];
+    }
+}
+// ====
+// optimize: true
+// ----
+// aliasing(uint,uint): 3, 3 -> 2, 2
+// aliasing(uint,uint): 3, 4 -> 1, 2
+// readM(uint): 3 -> 1
+// storeInLoop(uint): 0 -> 0, 1
+// storeInLoop(uint): 3 -> 6, 4
+// storeOnBranch(bool): false -> 5
+// storeOnBranch(bool): true -> 7
+// knownAcrossBranch(bool): false -> 5
+// knownAcrossBranch(bool): true -> 6
+// callInBetween(uint): 9 -> 9, 9
+// overwrittenThenRevert(bool): true -> FAILURE, 255
+// readX() -> 9
+// overwrittenThenRevert(bool): false -> 2
+// readX() -> 2
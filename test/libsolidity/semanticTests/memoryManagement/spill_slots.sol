@@ -0,0 +1,46 @@
+// Hashed mapping keys, decoded values and event data are staged in memory
+// cells reserved once per call, which every execution of the same site
+// reuses.
+contract C {
+    mapping(uint => mapping(uint => uint)) nested;
+    uint total;
+
+    event Noted(uint indexed key, uint64 value, uint256 total);
+
+    function loop(uint n) public returns (uint s) {
+        for (uint i = 0; i < n; i++) {
+            nested[i][i + 1] = i * 3;
+            s += nested[i][i + 1];
+            (uint a, uint b) = abi.decode(abi.encode(i, s), (uint, uint));
+            emit Noted(a, uint64(b), uint256(s));
+            s += a;
+        }
+    }
+
+    function recurse(uint n, uint key) public returns (uint) {
+        nested[key][n] = n + 1;
+        if (n == 0)
+            return nested[key][0];
+        uint below = recurse(n - 1, key + 1);
+        emit Noted(key, uint64(n), uint256(below));
+        return nested[key][n] * 100 + below;
+    }
+
+    function note(uint v) internal returns (uint) {
+        total += v;
+        emit Noted(v, uint64(v * 2), uint256(total));
+        return v;
+    }
+
+    function spilled(uint k) public returns (uint) {
+        nested[k][note(k + 1)] = note(k + 2) + nested[note(k)][k];
+        return nested[k][k + 1] * 1000 + total;
+    }
+}
+// ----
+// loop(uint): 0 -> 0
+// loop(uint): 4 -> 24
+// recurse(uint,uint): 0, 7 -> 1
+// recurse(uint,uint): 3, 1 -> 901
+// spilled(uint): 5 -> 7018
+// spilled(uint): 5 -> 7036
@@ -21,6 +21,7 @@ contract C {
 // compileViaYul: also
 // EVMVersion: >=byzantium
 // revertStrings: debug
+// ieleInterpreter: false
 // ----
 // (), 10 wei ->
 // g() -> 10
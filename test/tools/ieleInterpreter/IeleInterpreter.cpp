@@ -0,0 +1,969 @@
+#include <test/tools/ieleInterpreter/IeleInterpreter.h>
+
+#include "libiele/IeleArgument.h"
+#include "libiele/IeleBlock.h"
+#include "libiele/IeleContract.h"
+#include "libiele/IeleFunction.h"
+#include "libiele/IeleGlobalVariable.h"
+#include "libiele/IeleInstruction.h"
+#include "libiele/IeleIntConstant.h"
+#include "libiele/IeleLocalVariable.h"
+
+#include <libsolutil/CommonData.h>
+#include <libsolutil/Keccak256.h>
+#include <libsolutil/picosha2.h>
+
+#include <algorithm>
+
+using namespace solidity;
+using namespace solidity::iele;
+using namespace solidity::iele::test;
+
+namespace {
+
+// Account calls nest at most this deep; deeper calls fail with status
+// CallStackExceeded.
+const unsigned MaxAccountDepth = 1024;
+// The maximum number of nested function frames of a transaction, counting
+// both internal and account calls.
+const unsigned MaxFrames = 4096;
+// Passed to callAccount when any number of returned values is accepted.
+const size_t AnyReturns = size_t(-1);
+// The address of the account holding the precompiled functions.
+const unsigned PrecompiledAddress = 1;
+// The gas of the sha256 precompiled function, per call and per 64-bit word.
+const uint64_t Sha256Gas = 60;
+const uint64_t Sha256WordGas = 3;
+
+// Thrown to stop the execution of an account call. Exceptional halts
+// consume all of the gas of the call, while reverts keep the gas left.
+struct Halt {
+  bigint Status;
+  bool ConsumesGas;
+};
+
+// Thrown by selfdestruct to end the account call successfully.
+struct Stop { };
+
+[[noreturn]] void halt(IeleStatus Status) {
+  throw Halt{Status, true};
+}
+
+// Returns the number of 64-bit words of V, as in the static gas estimator.
+uint64_t wordsOf(const bigint &V) {
+  bigint Magnitude = V < 0 ? bigint(-V) : V;
+  if (Magnitude == 0)
+    return 1;
+  return uint64_t(boost::multiprecision::msb(Magnitude) + 1) / 64 + 1;
+}
+
+uint64_t wordsOfBytes(size_t Bytes) {
+  return (Bytes + 7) / 8;
+}
+
+// Returns the Width low-order bytes of the two's complement of V as an
+// unsigned value.
+bigint twos(const bigint &Width, const bigint &V) {
+  return V & ((bigint(1) << unsigned(Width * 8)) - 1);
+}
+
+bigint signExtend(const bigint &Width, const bigint &V) {
+  if (Width == 0)
+    return 0;
+  bigint Result = twos(Width, V);
+  if (boost::multiprecision::bit_test(Result, unsigned(Width * 8 - 1)))
+    Result -= bigint(1) << unsigned(Width * 8);
+  return Result;
+}
+
+// Memory cells hold the little-endian two's complement of the values
+// stored to them as a whole.
+bytes toLittleEndian(const bigint &V) {
+  bytes Result;
+  bigint Rest = V;
+  while (Rest != 0 && Rest != -1) {
+    Result.push_back(uint8_t(unsigned(Rest & 0xff)));
+    Rest >>= 8;
+  }
+  // Keep a byte for the sign unless the last byte already has it.
+  bool Negative = V < 0;
+  if (V != 0 && (Result.empty() || bool(Result.back() & 0x80) != Negative))
+    Result.push_back(Negative ? 0xff : 0);
+  return Result;
+}
+
+bigint fromLittleEndian(const bytes &Bytes, size_t Offset, size_t Width,
+                        bool Signed) {
+  bigint Result = 0;
+  for (size_t i = Width; i > 0; --i) {
+    size_t Index = Offset + i - 1;
+    Result <<= 8;
+    Result |= Index < Bytes.size() ? Bytes[Index] : 0;
+  }
+  if (Signed && Width > 0 && Offset + Width <= Bytes.size() &&
+      (Bytes[Offset + Width - 1] & 0x80))
+    Result -= bigint(1) << (8 * Width);
+  return Result;
+}
+
+bigint hashOf(const bytes &Data) {
+  return util::fromBigEndian<bigint>(util::keccak256(Data).asBytes());
+}
+
+// Returns the non-negative value of V that fits a size_t, or halts with
+// status Code.
+size_t toSize(const bigint &V, IeleStatus Code) {
+  if (V < 0 || V > bigint(std::numeric_limits<uint32_t>::max()))
+    halt(Code);
+  return size_t(V);
+}
+
+} // end anonymous namespace
+
+bigint IeleChainState::blockHash(const bigint &Number) const {
+  if (Number >= BlockNumber || Number + 256 < BlockNumber)
+    return 0;
+  // The hashes the IELE test nodes report for their blocks.
+  return util::fromBigEndian<bigint>(bytes(32, 0x37)) + Number;
+}
+
+// The state of one account call: the account that executes, its memory and
+// the gas left.
+struct IeleInterpreter::Message {
+  const IeleContract *Contract;
+  bigint Address;
+  bigint Caller;
+  bigint Value;
+  bool Static;
+  uint64_t Gas;
+  std::map<bigint, bytes> Memory;
+
+  void charge(const bigint &Amount) {
+    if (Amount > Gas) {
+      Gas = 0;
+      halt(OutOfGas);
+    }
+    Gas -= uint64_t(Amount);
+  }
+
+  // Returns the most gas that can be given to an account call or creation.
+  // The caller keeps a 64th of its gas, so that it can still handle an
+  // exceptional halt of the callee, which consumes all of the gas given to it.
+  uint64_t callableGas() const { return Gas - Gas / 64; }
+};
+
+// The registers of a function call.
+struct IeleInterpreter::Frame {
+  const FunctionInfo *Info;
+  std::vector<bigint> Registers;
+};
+
+namespace {
+
+// A copy of the state to restore when an account call fails.
+struct Snapshot {
+  std::map<bigint, IeleAccount> Accounts;
+  size_t Logs;
+  std::set<bigint> Destroyed;
+};
+
+// Counts the nesting of frames while a function runs.
+struct FrameGuard {
+  unsigned &Frames;
+  explicit FrameGuard(unsigned &Frames) : Frames(Frames) {
+    if (Frames >= MaxFrames)
+      halt(CallStackExceeded);
+    ++Frames;
+  }
+  ~FrameGuard() { --Frames; }
+};
+
+} // end anonymous namespace
+
+size_t IeleInterpreter::getCodeSize(const IeleContract &Contract) {
+  return Contract.getBytecode().size();
+}
+
+IeleTransactionResult IeleInterpreter::call(
+    const bigint &From, const bigint &To, const std::string &Function,
+    const std::vector<bigint> &Arguments, const bigint &Value,
+    const bigint &GasLimit, const bigint &GasPrice) {
+  return transact(From, GasLimit, GasPrice, [&](uint64_t Gas) {
+    ++State.Accounts[From].Nonce;
+    return callAccount(From, To, Function, Arguments, Value, Gas, false,
+                       AnyReturns);
+  });
+}
+
+IeleTransactionResult IeleInterpreter::create(
+    const bigint &From, const IeleContract &Contract,
+    const std::vector<bigint> &Arguments, const bigint &Value,
+    const bigint &GasLimit, const bigint &GasPrice) {
+  return transact(From, GasLimit, GasPrice, [&](uint64_t Gas) {
+    return createAccount(From, Contract, Arguments, Value, Gas);
+  });
+}
+
+IeleTransactionResult IeleInterpreter::transact(
+    const bigint &From, const bigint &GasLimit, const bigint &Price,
+    const std::function<CallResult(uint64_t)> &Run) {
+  IeleTransactionResult Result;
+  IeleAccount &Sender = State.Accounts[From];
+  if (GasLimit < 0 || GasLimit > std::numeric_limits<uint64_t>::max() ||
+      Sender.Balance < GasLimit * Price) {
+    Result.Status = OutOfFunds;
+    return Result;
+  }
+  Sender.Balance -= GasLimit * Price;
+  Origin = From;
+  GasPrice = Price;
+  Logs.clear();
+  Destroyed.clear();
+
+  uint64_t Gas = uint64_t(GasLimit);
+  CallResult Call = Run(Gas);
+  Result.Status = Call.Status;
+  Result.ReturnValues = std::move(Call.ReturnValues);
+  Result.GasUsed = Gas - Call.GasLeft;
+  Result.ContractAddress = Call.Address;
+  Result.Logs = std::move(Logs);
+  Logs.clear();
+
+  State.Accounts[From].Balance += Call.GasLeft * Price;
+  State.Accounts[State.Beneficiary].Balance += Result.GasUsed * Price;
+  for (const bigint &Address : Destroyed)
+    State.Accounts.erase(Address);
+  Destroyed.clear();
+  return Result;
+}
+
+bool IeleInterpreter::transfer(const bigint &From, const bigint &To,
+                               const bigint &Value) {
+  IeleAccount &Source = State.Accounts[From];
+  if (Value < 0 || Source.Balance < Value)
+    return false;
+  Source.Balance -= Value;
+  State.Accounts[To].Balance += Value;
+  return true;
+}
+
+IeleInterpreter::CallResult IeleInterpreter::callAccount(
+    const bigint &Caller, const bigint &To, const std::string &Function,
+    const std::vector<bigint> &Arguments, const bigint &Value, uint64_t Gas,
+    bool Static, size_t NumReturns) {
+  CallResult Result;
+  Result.GasLeft = Gas;
+  if (AccountDepth >= MaxAccountDepth) {
+    Result.Status = CallStackExceeded;
+    return Result;
+  }
+  Snapshot Saved{State.Accounts, Logs.size(), Destroyed};
+  auto restore = [&]() {
+    State.Accounts = std::move(Saved.Accounts);
+    Logs.resize(Saved.Logs);
+    Destroyed = std::move(Saved.Destroyed);
+  };
+
+  if (!transfer(Caller, To, Value)) {
+    restore();
+    Result.Status = OutOfFunds;
+    return Result;
+  }
+  const IeleContract *Contract = State.Accounts[To].Contract;
+  if (!Contract && To == PrecompiledAddress) {
+    if (!runPrecompiled(Function, Arguments, Result))
+      restore();
+    return Result;
+  }
+  if (!Contract) {
+    // Accounts without code only accept deposits.
+    if (Function != "deposit") {
+      restore();
+      Result.Status = FunctionNotFound;
+    }
+    return Result;
+  }
+  const IeleFunction *F = nullptr;
+  for (const IeleFunction &Candidate : Contract->functions())
+    if ((Candidate.isPublic() || Candidate.isDeposit()) &&
+        Candidate.getName() == Function)
+      F = &Candidate;
+  if (!F) {
+    restore();
+    Result.Status = FunctionNotFound;
+    return Result;
+  }
+
+  Message M{Contract, To, Caller, Value, Static, Gas, {}};
+  ++AccountDepth;
+  try {
+    Result.ReturnValues = runFunction(M, *F, Arguments);
+    if (NumReturns != AnyReturns && Result.ReturnValues.size() != NumReturns)
+      halt(FunctionWrongSignature);
+    Result.GasLeft = M.Gas;
+  } catch (const Stop &) {
+    Result.ReturnValues.clear();
+    Result.GasLeft = M.Gas;
+  } catch (const Halt &H) {
+    restore();
+    Result.Status = H.Status;
+    Result.ReturnValues.clear();
+    Result.GasLeft = H.ConsumesGas ? 0 : M.Gas;
+  }
+  --AccountDepth;
+  return Result;
+}
+
+bool IeleInterpreter::runPrecompiled(const std::string &Function,
+                                     const std::vector<bigint> &Arguments,
+                                     CallResult &Result) {
+  auto fail = [&](IeleStatus Status) {
+    Result.Status = Status;
+    Result.GasLeft = 0;
+    return false;
+  };
+  // Only sha256 is supported: the other precompiled functions need
+  // cryptography that the interpreter does not link.
+  if (Function != "iele.sha256")
+    return fail(FunctionNotFound);
+  if (Arguments.size() != 2)
+    return fail(FunctionWrongSignature);
+  if (Arguments[0] < 0 ||
+      Arguments[0] > bigint(std::numeric_limits<uint32_t>::max()))
+    return fail(OutOfGas);
+  size_t Length = size_t(Arguments[0]);
+  uint64_t Cost = Sha256Gas + Sha256WordGas * wordsOfBytes(Length);
+  if (Cost > Result.GasLeft)
+    return fail(OutOfGas);
+  Result.GasLeft -= Cost;
+  // The data are the Length bytes of the value in big-endian order.
+  bytes Data(Length);
+  util::toBigEndian(twos(Length, Arguments[1]), Data);
+  Result.ReturnValues.push_back(
+    util::fromBigEndian<bigint>(picosha2::hash256(Data)));
+  return true;
+}
+
+IeleInterpreter::CallResult IeleInterpreter::createAccount(
+    const bigint &Creator, const IeleContract &Contract,
+    const std::vector<bigint> &Arguments, const bigint &Value, uint64_t Gas) {
+  CallResult Result;
+  Result.GasLeft = Gas;
+  if (AccountDepth >= MaxAccountDepth) {
+    Result.Status = CallStackExceeded;
+    return Result;
+  }
+  // The address of the new account depends on its creator and on the number
+  // of accounts it created before.
+  bigint Nonce = State.Accounts[Creator].Nonce++;
+  bigint Address = twos(20, hashOf(util::toCompactBigEndian(Creator, 1) +
+                                   util::toCompactBigEndian(Nonce, 1)));
+
+  auto Existing = State.Accounts.find(Address);
+  if (Existing != State.Accounts.end() &&
+      (Existing->second.Contract || Existing->second.Nonce != 0)) {
+    Result.Status = AccountCollision;
+    return Result;
+  }
+  Snapshot Saved{State.Accounts, Logs.size(), Destroyed};
+  auto restore = [&]() {
+    State.Accounts = std::move(Saved.Accounts);
+    Logs.resize(Saved.Logs);
+    Destroyed = std::move(Saved.Destroyed);
+  };
+  if (!transfer(Creator, Address, Value)) {
+    restore();
+    Result.Status = OutOfFunds;
+    return Result;
+  }
+  // The account has no code until init returns, so that calls to it from
+  // init fail as on IELE nodes.
+  State.Accounts[Address].Nonce = 1;
+
+  Message M{&Contract, Address, Creator, Value, false, Gas, {}};
+  ++AccountDepth;
+  try {
+    const IeleFunction *Init = nullptr;
+    for (const IeleFunction &F : Contract.functions())
+      if (F.isInit())
+        Init = &F;
+    if (Init)
+      runFunction(M, *Init, Arguments);
+    else if (!Arguments.empty())
+      halt(FunctionWrongSignature);
+    M.charge(bigint(Schedule.CodeDepositByte) * getCodeSize(Contract));
+    State.Accounts[Address].Contract = &Contract;
+    Result.Address = Address;
+    Result.GasLeft = M.Gas;
+  } catch (const Stop &) {
+    State.Accounts[Address].Contract = &Contract;
+    Result.Address = Address;
+    Result.GasLeft = M.Gas;
+  } catch (const Halt &H) {
+    restore();
+    Result.Status = H.Status;
+    Result.GasLeft = H.ConsumesGas ? 0 : M.Gas;
+  }
+  --AccountDepth;
+  return Result;
+}
+
+const IeleInterpreter::FunctionInfo &
+IeleInterpreter::getFunctionInfo(const IeleFunction &F) {
+  auto It = Functions.find(&F);
+  if (It != Functions.end())
+    return It->second;
+
+  // Registers are numbered as by the assembler.
+  FunctionInfo &Info = Functions[&F];
+  auto number = [&](const IeleValue *V) {
+    Info.Registers.emplace(V, Info.Registers.size());
+  };
+  for (const IeleArgument &A : F.args())
+    number(&A);
+  for (const IeleLocalVariable &LV : F.lvars())
+    number(&LV);
+  for (const IeleBlock &B : F.blocks())
+    for (const IeleInstruction &I : B.instructions()) {
+      for (const IeleLocalVariable *LV : I.lvalues())
+        number(LV);
+      for (const IeleValue *V : I.operands())
+        if (llvm::isa<IeleLocalVariable>(V))
+          number(V);
+    }
+  return Info;
+}
+
+const IeleInterpreter::NameTable &
+IeleInterpreter::getNameTable(const IeleContract &Contract) {
+  auto It = NameTables.find(&Contract);
+  if (It != NameTables.end())
+    return It->second;
+
+  // The name table of the bytecode: the functions of the contract and of the
+  // runtime, followed by the other names in the order the functions use
+  // them. Function values are indices into it. As on IELE nodes, the init
+  // function comes first, so that uninitialized function pointers, which are
+  // zero, name a function that cannot be called.
+  NameTable &Table = NameTables[&Contract];
+  auto add = [&](llvm::StringRef Name) {
+    if (Table.Indices.emplace(Name.str(), Table.Names.size()).second)
+      Table.Names.push_back(Name.str());
+  };
+  std::vector<const IeleFunction *> Defined;
+  for (const IeleFunction &F : Contract.functions())
+    if (F.isInit())
+      Defined.push_back(&F);
+  for (const IeleFunction &F : Contract.functions())
+    if (!F.isInit())
+      Defined.push_back(&F);
+  for (const IeleFunction *F : Contract.getRuntimeFunctions())
+    Defined.push_back(F);
+  for (const IeleFunction *F : Defined) {
+    add(F->getName());
+    Table.Functions.emplace(F->getName().str(), F);
+  }
+  for (const IeleFunction *F : Defined)
+    for (const IeleBlock &B : F->blocks())
+      for (const IeleInstruction &I : B.instructions())
+        for (const IeleValue *V : I.operands()) {
+          const IeleGlobalVariable *GV =
+            llvm::dyn_cast<IeleGlobalVariable>(V);
+          if (llvm::isa<IeleFunction>(V) ||
+              (GV && !GV->getStorageAddress() &&
+               GV->getName() != "ielert.storage.next.free"))
+            add(V->getName());
+        }
+  return Table;
+}
+
+std::vector<bigint>
+IeleInterpreter::runFunction(Message &M, const IeleFunction &F,
+                             const std::vector<bigint> &Arguments) {
+  if (Arguments.size() != F.arg_size())
+    halt(FunctionWrongSignature);
+  FrameGuard Guard(Frames);
+  Frame Fr{&getFunctionInfo(F), {}};
+  Fr.Registers.resize(Fr.Info->Registers.size());
+  auto Argument = Arguments.begin();
+  for (const IeleArgument &A : F.args())
+    Fr.Registers[Fr.Info->Registers.at(&A)] = *Argument++;
+
+  // Blocks fall through to the next block unless they branch.
+  auto B = F.begin();
+  while (B != F.end()) {
+    const IeleBlock *Target = nullptr;
+    for (const IeleInstruction &I : B->instructions()) {
+      M.charge(getInstructionGasCost(I, Schedule).Min);
+      switch (I.getOpcode()) {
+      case IeleInstruction::Br:
+        if (!I.isConditionalBranch() || operand(M, Fr, *I.begin()) != 0)
+          Target = I.getBranchTarget();
+        break;
+      case IeleInstruction::Ret: {
+        std::vector<bigint> Results;
+        for (const IeleValue *V : I.operands())
+          Results.push_back(operand(M, Fr, V));
+        return Results;
+      }
+      case IeleInstruction::Revert:
+        throw Halt{operand(M, Fr, *I.begin()), false};
+      default:
+        runInstruction(M, Fr, I);
+        break;
+      }
+      if (Target)
+        break;
+    }
+    B = Target ? Target->getIterator() : std::next(B);
+  }
+  return {};
+}
+
+bigint &IeleInterpreter::lvalue(Frame &Fr, const IeleInstruction &I,
+                                unsigned N) {
+  return Fr.Registers[Fr.Info->Registers.at(*(I.lvalue_begin() + N))];
+}
+
+bigint IeleInterpreter::operand(Message &M, Frame &Fr, const IeleValue *V) {
+  if (const IeleIntConstant *C = llvm::dyn_cast<IeleIntConstant>(V))
+    return C->getValue();
+  if (llvm::isa<IeleLocalVariable>(V) || llvm::isa<IeleArgument>(V))
+    return Fr.Registers[Fr.Info->Registers.at(V)];
+  if (const IeleGlobalVariable *GV = llvm::dyn_cast<IeleGlobalVariable>(V)) {
+    if (GV->getStorageAddress())
+      return GV->getStorageAddress()->getValue();
+    if (GV->getName() == "ielert.storage.next.free")
+      return M.Contract->getStorageRuntimeNextFreePtrAddress();
+  }
+  // Function values are indices into the name table.
+  const NameTable &Table = getNameTable(*M.Contract);
+  auto It = Table.Indices.find(V->getName().str());
+  if (It == Table.Indices.end())
+    halt(FunctionNotFound);
+  return It->second;
+}
+
+std::string IeleInterpreter::calleeName(Message &M, Frame &Fr,
+                                        const IeleValue *V,
+                                        const IeleContract *Callee) {
+  if (!llvm::isa<IeleLocalVariable>(V) && !llvm::isa<IeleArgument>(V))
+    return V->getName().str();
+  // A register holds an index into the name table of the callee.
+  bigint Index = operand(M, Fr, V);
+  if (!Callee)
+    return std::string();
+  const NameTable &Table = getNameTable(*Callee);
+  if (Index < 0 || Index >= Table.Names.size())
+    return std::string();
+  return Table.Names[size_t(Index)];
+}
+
+void IeleInterpreter::runInstruction(Message &M, Frame &Fr,
+                                     const IeleInstruction &I) {
+  auto op = [&](unsigned N) { return operand(M, Fr, *(I.begin() + N)); };
+  auto account = [&](const bigint &Address) -> const IeleAccount * {
+    auto It = State.Accounts.find(Address);
+    return It == State.Accounts.end() ? nullptr : &It->second;
+  };
+
+  switch (I.getOpcode()) {
+  case IeleInstruction::Assign:
+    lvalue(Fr, I, 0) = op(0);
+    break;
+
+  case IeleInstruction::Load: {
+    const bytes &Cell = M.Memory[op(0)];
+    if (I.size() == 1) {
+      M.charge(bigint(Schedule.MemoryWord) * wordsOfBytes(Cell.size()));
+      lvalue(Fr, I, 0) = fromLittleEndian(Cell, 0, Cell.size(), true);
+      break;
+    }
+    size_t Offset = toSize(op(1), OutOfGas);
+    size_t Width = toSize(op(2), OutOfGas);
+    M.charge(bigint(Schedule.MemoryWord) * wordsOfBytes(Width));
+    lvalue(Fr, I, 0) = fromLittleEndian(Cell, Offset, Width, false);
+    break;
+  }
+  case IeleInstruction::Store: {
+    bigint Value = op(0);
+    bytes &Cell = M.Memory[op(1)];
+    size_t OldSize = Cell.size();
+    if (I.size() == 2) {
+      bytes Data = toLittleEndian(Value);
+      M.charge(bigint(Schedule.MemoryWord) * wordsOfBytes(Data.size()));
+      Cell = std::move(Data);
+    } else {
+      size_t Offset = toSize(op(2), OutOfGas);
+      size_t Width = toSize(op(3), OutOfGas);
+      M.charge(bigint(Schedule.MemoryWord) * wordsOfBytes(Width) +
+               bigint(Schedule.MemoryGrowthWord) *
+                 wordsOfBytes(std::max(Offset + Width, OldSize) - OldSize));
+      if (Cell.size() < Offset + Width)
+        Cell.resize(Offset + Width);
+      bigint Bytes = twos(Width, Value);
+      for (size_t i = 0; i < Width; ++i, Bytes >>= 8)
+        Cell[Offset + i] = uint8_t(unsigned(Bytes & 0xff));
+      break;
+    }
+    if (Cell.size() > OldSize)
+      M.charge(bigint(Schedule.MemoryGrowthWord) *
+               wordsOfBytes(Cell.size() - OldSize));
+    break;
+  }
+
+  case IeleInstruction::SLoad: {
+    const IeleAccount *Account = account(M.Address);
+    bigint Key = op(0);
+    auto It = Account->Storage.find(Key);
+    lvalue(Fr, I, 0) = It == Account->Storage.end() ? bigint(0) : It->second;
+    break;
+  }
+  case IeleInstruction::SStore: {
+    if (M.Static)
+      halt(UserError);
+    bigint Value = op(0);
+    std::map<bigint, bigint> &Storage = State.Accounts[M.Address].Storage;
+    auto It = Storage.find(op(1));
+    if (Value != 0 && It == Storage.end())
+      M.charge(Schedule.SStoreSet - Schedule.SStoreReset);
+    if (Value == 0) {
+      if (It != Storage.end())
+        Storage.erase(It);
+    } else if (It != Storage.end())
+      It->second = Value;
+    else
+      Storage.emplace(op(1), Value);
+    break;
+  }
+
+  case IeleInstruction::IsZero:
+    lvalue(Fr, I, 0) = op(0) == 0 ? 1 : 0;
+    break;
+  case IeleInstruction::Not:
+    lvalue(Fr, I, 0) = ~op(0);
+    break;
+  case IeleInstruction::Add:
+    lvalue(Fr, I, 0) = op(0) + op(1);
+    break;
+  case IeleInstruction::Sub:
+    lvalue(Fr, I, 0) = op(0) - op(1);
+    break;
+  case IeleInstruction::Mul:
+    lvalue(Fr, I, 0) = op(0) * op(1);
+    break;
+  case IeleInstruction::Div:
+  case IeleInstruction::Mod: {
+    bigint Divisor = op(1);
+    if (Divisor == 0)
+      halt(UserError);
+    lvalue(Fr, I, 0) = I.getOpcode() == IeleInstruction::Div
+                         ? bigint(op(0) / Divisor)
+                         : bigint(op(0) % Divisor);
+    break;
+  }
+  case IeleInstruction::Exp: {
+    bigint Base = op(0), Exponent = op(1);
+    if (Exponent < 0)
+      halt(UserError);
+    // Charge for the size of the result before computing it.
+    if (Exponent > 1)
+      M.charge(bigint(Schedule.MulWord) * wordsOf(Base) * Exponent);
+    lvalue(Fr, I, 0) = boost::multiprecision::pow(Base, unsigned(Exponent));
+    break;
+  }
+  case IeleInstruction::Log2: {
+    bigint Value = op(0);
+    if (Value <= 0)
+      halt(UserError);
+    lvalue(Fr, I, 0) = boost::multiprecision::msb(Value);
+    break;
+  }
+  case IeleInstruction::AddMod:
+  case IeleInstruction::MulMod: {
+    bigint Modulus = op(2);
+    if (Modulus == 0 || op(0) < 0 || op(1) < 0)
+      halt(UserError);
+    lvalue(Fr, I, 0) = I.getOpcode() == IeleInstruction::AddMod
+                         ? bigint((op(0) + op(1)) % Modulus)
+                         : bigint((op(0) * op(1)) % Modulus);
+    break;
+  }
+  case IeleInstruction::ExpMod: {
+    bigint Base = op(0), Exponent = op(1), Modulus = op(2);
+    if (Modulus == 0 || Exponent < 0)
+      halt(UserError);
+    if (Modulus < 0)
+      Modulus = -Modulus;
+    Base %= Modulus;
+    if (Base < 0)
+      Base += Modulus;
+    lvalue(Fr, I, 0) = boost::multiprecision::powm(Base, Exponent, Modulus);
+    break;
+  }
+
+  case IeleInstruction::Byte: {
+    bigint Index = op(0), Value = op(1);
+    if (Index < 0)
+      halt(UserError);
+    if (Index >= wordsOf(Value) * 8)
+      lvalue(Fr, I, 0) = Value < 0 ? 0xff : 0;
+    else
+      lvalue(Fr, I, 0) = (Value >> unsigned(Index * 8)) & 0xff;
+    break;
+  }
+  case IeleInstruction::SExt:
+  case IeleInstruction::Twos:
+  case IeleInstruction::BSwap: {
+    bigint Width = op(0), Value = op(1);
+    if (Width < 0)
+      halt(UserError);
+    M.charge(bigint(Schedule.ArithWord) * (Width / 8));
+    if (I.getOpcode() == IeleInstruction::SExt) {
+      lvalue(Fr, I, 0) = signExtend(Width, Value);
+      break;
+    }
+    bigint Result = twos(Width, Value);
+    if (I.getOpcode() == IeleInstruction::BSwap) {
+      bigint Swapped = 0;
+      for (size_t i = 0; i < size_t(Width); ++i, Result >>= 8)
+        Swapped = (Swapped << 8) | (Result & 0xff);
+      Result = Swapped;
+    }
+    lvalue(Fr, I, 0) = Result;
+    break;
+  }
+  case IeleInstruction::And:
+    lvalue(Fr, I, 0) = op(0) & op(1);
+    break;
+  case IeleInstruction::Or:
+    lvalue(Fr, I, 0) = op(0) | op(1);
+    break;
+  case IeleInstruction::Xor:
+    lvalue(Fr, I, 0) = op(0) ^ op(1);
+    break;
+  case IeleInstruction::Shift: {
+    bigint Value = op(0), Amount = op(1);
+    if (Amount >= 0) {
+      M.charge(bigint(Schedule.ArithWord) * (Amount / 64));
+      lvalue(Fr, I, 0) = Value << unsigned(Amount);
+    } else if (-Amount >= wordsOf(Value) * 64)
+      lvalue(Fr, I, 0) = Value < 0 ? -1 : 0;
+    else
+      lvalue(Fr, I, 0) = Value >> unsigned(-Amount);
+    break;
+  }
+  case IeleInstruction::CmpLt:
+    lvalue(Fr, I, 0) = op(0) < op(1) ? 1 : 0;
+    break;
+  case IeleInstruction::CmpLe:
+    lvalue(Fr, I, 0) = op(0) <= op(1) ? 1 : 0;
+    break;
+  case IeleInstruction::CmpGt:
+    lvalue(Fr, I, 0) = op(0) > op(1) ? 1 : 0;
+    break;
+  case IeleInstruction::CmpGe:
+    lvalue(Fr, I, 0) = op(0) >= op(1) ? 1 : 0;
+    break;
+  case IeleInstruction::CmpEq:
+    lvalue(Fr, I, 0) = op(0) == op(1) ? 1 : 0;
+    break;
+  case IeleInstruction::CmpNe:
+    lvalue(Fr, I, 0) = op(0) != op(1) ? 1 : 0;
+    break;
+
+  case IeleInstruction::Sha3: {
+    const bytes &Cell = M.Memory[op(0)];
+    M.charge(bigint(Schedule.Sha3Word) * wordsOfBytes(Cell.size()));
+    lvalue(Fr, I, 0) = hashOf(Cell);
+    break;
+  }
+  case IeleInstruction::Log: {
+    if (M.Static)
+      halt(UserError);
+    IeleLogEntry Entry;
+    Entry.Address = M.Address;
+    Entry.Data = M.Memory[op(0)];
+    M.charge(bigint(Schedule.LogDataWord) * wordsOfBytes(Entry.Data.size()));
+    for (unsigned i = 1; i < I.size(); ++i)
+      Entry.Topics.push_back(op(i));
+    Logs.push_back(std::move(Entry));
+    break;
+  }
+  case IeleInstruction::Selfdestruct: {
+    if (M.Static)
+      halt(UserError);
+    bigint Beneficiary = op(0);
+    if (!account(Beneficiary))
+      M.charge(Schedule.NewAccount);
+    bigint Balance = State.Accounts[M.Address].Balance;
+    State.Accounts[M.Address].Balance = 0;
+    if (Beneficiary != M.Address)
+      State.Accounts[Beneficiary].Balance += Balance;
+    Destroyed.insert(M.Address);
+    throw Stop();
+  }
+
+  case IeleInstruction::Call: {
+    const NameTable &Table = getNameTable(*M.Contract);
+    auto Callee = Table.Functions.find(calleeName(M, Fr, *I.begin(),
+                                                  M.Contract));
+    // The init function only runs when its account is created.
+    if (Callee == Table.Functions.end() || Callee->second->isInit())
+      halt(FunctionNotFound);
+    std::vector<bigint> Arguments;
+    for (unsigned i = 1; i < I.size(); ++i)
+      Arguments.push_back(op(i));
+    std::vector<bigint> Results = runFunction(M, *Callee->second, Arguments);
+    if (Results.size() != I.lvalue_size())
+      halt(FunctionWrongSignature);
+    for (unsigned i = 0; i < Results.size(); ++i)
+      lvalue(Fr, I, i) = std::move(Results[i]);
+    break;
+  }
+  case IeleInstruction::CallAt:
+  case IeleInstruction::StaticCallAt: {
+    bool IsStatic = I.getOpcode() == IeleInstruction::StaticCallAt;
+    unsigned N = 1;
+    bigint To = op(N++);
+    bigint Value = IsStatic ? bigint(0) : op(N++);
+    bigint GasLimit = op(N++);
+    std::vector<bigint> Arguments;
+    for (; N < I.size(); ++N)
+      Arguments.push_back(op(N));
+    if (M.Static && Value != 0)
+      halt(UserError);
+    const IeleAccount *Target = account(To);
+    if (Value != 0)
+      M.charge(Schedule.CallValue + (Target ? 0 : Schedule.NewAccount));
+    std::string Function =
+      calleeName(M, Fr, *I.begin(), Target ? Target->Contract : nullptr);
+
+    uint64_t Given = GasLimit < 0
+                       ? 0
+                       : uint64_t(std::min(GasLimit, bigint(M.callableGas())));
+    M.Gas -= Given;
+    CallResult Result = callAccount(M.Address, To, Function, Arguments,
+                                    Value, Given, M.Static || IsStatic,
+                                    I.lvalue_size() - 1);
+    M.Gas += Result.GasLeft;
+    lvalue(Fr, I, 0) = Result.Status;
+    for (unsigned i = 1; i < I.lvalue_size(); ++i)
+      lvalue(Fr, I, i) =
+        Result.Status == 0 ? std::move(Result.ReturnValues[i - 1]) : 0;
+    break;
+  }
+  case IeleInstruction::Create:
+  case IeleInstruction::CopyCreate: {
+    if (M.Static)
+      halt(UserError);
+    const IeleContract *Contract = nullptr;
+    if (I.getOpcode() == IeleInstruction::Create)
+      Contract = llvm::cast<IeleContract>(*I.begin());
+    else if (const IeleAccount *Source = account(op(0)))
+      Contract = Source->Contract;
+    bigint Value = op(1);
+    std::vector<bigint> Arguments;
+    for (unsigned i = 2; i < I.size(); ++i)
+      Arguments.push_back(op(i));
+
+    CallResult Result;
+    if (!Contract)
+      Result.Status = ContractNotFound;
+    else {
+      uint64_t Given = M.callableGas();
+      M.Gas -= Given;
+      Result = createAccount(M.Address, *Contract, Arguments, Value, Given);
+      M.Gas += Result.GasLeft;
+    }
+    lvalue(Fr, I, 0) = Result.Status;
+    lvalue(Fr, I, 1) = Result.Status == 0 ? Result.Address : bigint(0);
+    break;
+  }
+  case IeleInstruction::CallAddress: {
+    // The index of the function in the name table of the account, or -1 if
+    // it has no function of that name. An account that is running its init
+    // function has no code yet, but its functions are those being run.
+    bigint To = op(1);
+    const IeleAccount *Target = account(To);
+    const IeleContract *Code =
+      To == M.Address ? M.Contract : Target ? Target->Contract : nullptr;
+    bigint Index = -1;
+    if (Code) {
+      const NameTable &Table = getNameTable(*Code);
+      auto It = Table.Indices.find((*I.begin())->getName().str());
+      if (It != Table.Indices.end())
+        Index = It->second;
+    }
+    lvalue(Fr, I, 0) = Index;
+    break;
+  }
+
+  case IeleInstruction::Invalid:
+    halt(UserError);
+  case IeleInstruction::Gas:
+    lvalue(Fr, I, 0) = M.Gas;
+    break;
+  case IeleInstruction::Gasprice:
+    lvalue(Fr, I, 0) = GasPrice;
+    break;
+  case IeleInstruction::Gaslimit:
+    lvalue(Fr, I, 0) = State.GasLimit;
+    break;
+  case IeleInstruction::Beneficiary:
+    lvalue(Fr, I, 0) = State.Beneficiary;
+    break;
+  case IeleInstruction::Timestamp:
+    lvalue(Fr, I, 0) = State.Timestamp;
+    break;
+  case IeleInstruction::Number:
+    lvalue(Fr, I, 0) = State.BlockNumber;
+    break;
+  case IeleInstruction::Difficulty:
+    lvalue(Fr, I, 0) = State.Difficulty;
+    break;
+  case IeleInstruction::Address:
+    lvalue(Fr, I, 0) = M.Address;
+    break;
+  case IeleInstruction::Origin:
+    lvalue(Fr, I, 0) = Origin;
+    break;
+  case IeleInstruction::Caller:
+    lvalue(Fr, I, 0) = M.Caller;
+    break;
+  case IeleInstruction::Callvalue:
+    lvalue(Fr, I, 0) = M.Value;
+    break;
+  case IeleInstruction::Msize: {
+    size_t Size = 0;
+    for (const auto &Cell : M.Memory)
+      Size += Cell.second.size();
+    lvalue(Fr, I, 0) = Size;
+    break;
+  }
+  case IeleInstruction::Codesize:
+    lvalue(Fr, I, 0) = getCodeSize(*M.Contract);
+    break;
+  case IeleInstruction::Blockhash:
+    lvalue(Fr, I, 0) = State.blockHash(op(0));
+    break;
+  case IeleInstruction::Balance: {
+    const IeleAccount *Account = account(op(0));
+    lvalue(Fr, I, 0) = Account ? Account->Balance : bigint(0);
+    break;
+  }
+  case IeleInstruction::Extcodesize: {
+    const IeleAccount *Account = account(op(0));
+    lvalue(Fr, I, 0) = Account && Account->Contract
+                         ? getCodeSize(*Account->Contract)
+                         : 0;
+    break;
+  }
+
+  // Handled by runFunction.
+  case IeleInstruction::Br:
+  case IeleInstruction::Ret:
+  case IeleInstruction::Revert:
+    break;
+  }
+}
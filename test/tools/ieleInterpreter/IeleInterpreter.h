@@ -0,0 +1,174 @@
+#pragma once
+
+#include "libiele/IeleGasEstimator.h"
+
+#include <libsolutil/Common.h>
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace solidity {
+namespace iele {
+
+class IeleContract;
+class IeleFunction;
+class IeleInstruction;
+class IeleValue;
+
+namespace test {
+
+// The status codes of IELE account calls and transactions. Reverts use the
+// value given to the revert instruction as status instead.
+enum IeleStatus : unsigned {
+  Success = 0,
+  FunctionNotFound = 1,
+  FunctionWrongSignature = 2,
+  ContractNotFound = 3,
+  UserError = 4,
+  OutOfGas = 5,
+  AccountCollision = 6,
+  OutOfFunds = 7,
+  CallStackExceeded = 8,
+  ContractInvalid = 9
+};
+
+struct IeleLogEntry {
+  bigint Address;
+  std::vector<bigint> Topics;
+  bytes Data;
+};
+
+struct IeleAccount {
+  bigint Balance;
+  bigint Nonce;
+  std::map<bigint, bigint> Storage;
+  // The code of the account, or null for accounts without code.
+  const IeleContract *Contract = nullptr;
+};
+
+// The state of the chain that transactions execute on.
+struct IeleChainState {
+  std::map<bigint, IeleAccount> Accounts;
+  bigint BlockNumber = 0;
+  bigint Timestamp = 0;
+  bigint GasLimit = 100000000;
+  bigint Difficulty = 0;
+  bigint Beneficiary = 0;
+
+  // Returns the hash of block Number, or zero if it is not one of the 256
+  // blocks before the current one.
+  bigint blockHash(const bigint &Number) const;
+};
+
+// The outcome of a transaction.
+struct IeleTransactionResult {
+  bigint Status = IeleStatus::Success;
+  std::vector<bigint> ReturnValues;
+  bigint GasUsed = 0;
+  // The address of the created account, for contract creations.
+  bigint ContractAddress = 0;
+  std::vector<IeleLogEntry> Logs;
+};
+
+// An interpreter of IELE contracts in memory, used to run tests without an
+// IELE node. Each transaction executes the functions of the IR of its
+// contracts: values are unbounded integers, memory is a set of cells holding
+// byte arrays, and every instruction is charged the lower bound of its gas
+// cost in the schedule of the static gas estimator, plus the costs that
+// depend on the values it operates on, such as memory growth and writing new
+// storage entries. A failed account call or creation restores the state as
+// it was before it.
+class IeleInterpreter {
+public:
+  explicit IeleInterpreter(IeleChainState &State,
+                           IeleGasSchedule Schedule = IeleGasSchedule())
+    : State(State), Schedule(Schedule) { }
+
+  // Calls public function Function of the account at To.
+  IeleTransactionResult call(const bigint &From, const bigint &To,
+                             const std::string &Function,
+                             const std::vector<bigint> &Arguments,
+                             const bigint &Value, const bigint &GasLimit,
+                             const bigint &GasPrice);
+
+  // Creates an account for Contract and runs its init function.
+  IeleTransactionResult create(const bigint &From,
+                               const IeleContract &Contract,
+                               const std::vector<bigint> &Arguments,
+                               const bigint &Value, const bigint &GasLimit,
+                               const bigint &GasPrice);
+
+  // Returns the size of the bytecode of Contract.
+  static size_t getCodeSize(const IeleContract &Contract);
+
+private:
+  struct Message;
+  struct Frame;
+  struct FunctionInfo {
+    std::unordered_map<const IeleValue *, unsigned> Registers;
+  };
+  struct NameTable {
+    std::vector<std::string> Names;
+    std::map<std::string, unsigned> Indices;
+    std::map<std::string, const IeleFunction *> Functions;
+  };
+
+  // The result of an account call or creation.
+  struct CallResult {
+    bigint Status = IeleStatus::Success;
+    std::vector<bigint> ReturnValues;
+    uint64_t GasLeft = 0;
+    bigint Address = 0;
+  };
+
+  IeleChainState &State;
+  IeleGasSchedule Schedule;
+  bigint Origin;
+  bigint GasPrice;
+  unsigned AccountDepth = 0;
+  unsigned Frames = 0;
+  // The logs of the current transaction, and the accounts it destroyed.
+  std::vector<IeleLogEntry> Logs;
+  std::set<bigint> Destroyed;
+  std::map<const IeleFunction *, FunctionInfo> Functions;
+  std::map<const IeleContract *, NameTable> NameTables;
+
+  IeleTransactionResult transact(const bigint &From, const bigint &GasLimit,
+                                 const bigint &Price,
+                                 const std::function<CallResult(uint64_t)> &Run);
+
+  CallResult callAccount(const bigint &Caller, const bigint &To,
+                         const std::string &Function,
+                         const std::vector<bigint> &Arguments,
+                         const bigint &Value, uint64_t Gas, bool Static,
+                         size_t NumReturns);
+  CallResult createAccount(const bigint &Creator,
+                           const IeleContract &Contract,
+                           const std::vector<bigint> &Arguments,
+                           const bigint &Value, uint64_t Gas);
+  bool transfer(const bigint &From, const bigint &To, const bigint &Value);
+  // Runs a precompiled function, returning false if it fails.
+  bool runPrecompiled(const std::string &Function,
+                      const std::vector<bigint> &Arguments,
+                      CallResult &Result);
+
+  const FunctionInfo &getFunctionInfo(const IeleFunction &F);
+  const NameTable &getNameTable(const IeleContract &Contract);
+
+  std::vector<bigint> runFunction(Message &M, const IeleFunction &F,
+                                  const std::vector<bigint> &Arguments);
+  void runInstruction(Message &M, Frame &Fr, const IeleInstruction &I);
+
+  bigint &lvalue(Frame &Fr, const IeleInstruction &I, unsigned N);
+  bigint operand(Message &M, Frame &Fr, const IeleValue *V);
+  std::string calleeName(Message &M, Frame &Fr, const IeleValue *V,
+                         const IeleContract *Callee);
+};
+
+} // end namespace test
+} // end namespace iele
+} // end namespace solidity
@@ -142,10 +142,13 @@ private:
 	unique_ptr<TestCase> m_test;
 
 	static bool m_exitRequested;
+	/// Index of the next test file found, used to select the tests of the selected batch.
+	static size_t m_testIndex;
 };
 
 string TestTool::editor;
 bool TestTool::m_exitRequested = false;
+size_t TestTool::m_testIndex = 0;
 
 TestTool::Result TestTool::process()
 {
@@ -279,7 +282,10 @@ TestStats TestTool::processPath(
 				fs::directory_iterator(fullpath),
 				fs::directory_iterator()
 			))
-				if (fs::is_directory(entry.path()) || TestCase::isTestFilename(entry.path().filename()))
+				if (
+					fs::is_directory(entry.path()) ||
+					(TestCase::isTestFilename(entry.path().filename()) && _options.isInSelectedBatch(m_testIndex++))
+				)
 					paths.push(currentPath / entry.path().filename());
 		}
 		else if (m_exitRequested)
@@ -429,7 +435,9 @@ int main(int argc, char const *argv[])
 	bool disableSemantics = true;
 	try
 	{
-		disableSemantics = !solidity::test::EVMHost::checkVmPaths(options.vmPaths);
+		disableSemantics =
+			!options.ieleInterpreter &&
+			!solidity::test::EVMHost::checkVmPaths(options.vmPaths);
 	}
 	catch (std::runtime_error const& _exception)
 	{